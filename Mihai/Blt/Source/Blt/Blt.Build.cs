@@ -13,7 +13,17 @@ public class Blt : ModuleRules
 			"Core",
 			"CoreUObject",
 			"Engine",
+			"EngineSettings",
 			"Json"
 		});
+
+		if (target.bBuildEditor)
+		{
+			PrivateDependencyModuleNames.AddRange(new[]
+			{
+				"DirectoryWatcher",
+				"UnrealEd"
+			});
+		}
 	}
 }
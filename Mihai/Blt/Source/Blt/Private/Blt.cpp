@@ -2,12 +2,45 @@
 
 #include "BLT.h"
 
+#include "BltActorIndex.h"
+#include "BltClassSchema.h"
+#include "BltFuzzSpecWatcher.h"
+#include "BltMutationJournal.h"
+#include "BltSchemaSnapshot.h"
+#include "BltStats.h"
+#include "BltWorldCheckpoint.h"
+
 #define LOCTEXT_NAMESPACE "FBLTModule"
 
 
-void FBltModule::StartupModule() {}
+void FBltModule::StartupModule()
+{
+	FBltClassSchemaCache::Get().RegisterInvalidationHooks();
+	FBltActorIndex::RegisterWorldHooks();
+	FBltWorldCheckpoint::RegisterWorldHooks();
+	FBltFuzzSpecWatcher::Get().Watch(FPaths::ProjectContentDir() / TEXT("Data"));
+	FBltSchemaSnapshot::Get().Open(FBltSchemaSnapshot::GetDefaultPath());
+	FBltMutationJournal::Get().Start(FPaths::ProjectLogDir() / TEXT("Blt"));
+
+#if STATS
+	FBltStats::RegisterTicker();
+#endif
+}
+
+void FBltModule::ShutdownModule()
+{
+#if STATS
+	FBltStats::UnregisterTicker();
+#endif
 
-void FBltModule::ShutdownModule() {}
+	FBltMutationJournal::Get().Stop();
+	FBltSchemaSnapshot::Get().Flush();
+	FBltSchemaSnapshot::Get().Close();
+	FBltFuzzSpecWatcher::Get().UnwatchAll();
+	FBltWorldCheckpoint::UnregisterWorldHooks();
+	FBltActorIndex::UnregisterWorldHooks();
+	FBltClassSchemaCache::Get().UnregisterInvalidationHooks();
+}
 
 
 #undef LOCTEXT_NAMESPACE
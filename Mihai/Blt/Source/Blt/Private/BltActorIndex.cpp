@@ -0,0 +1,280 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "BltActorIndex.h"
+
+#include "EngineUtils.h"
+#include "BltClassSchema.h"
+#include "BltStats.h"
+
+
+TMap<TWeakObjectPtr<UWorld>, TUniquePtr<FBltActorIndex>> FBltActorIndex::Indices;
+FDelegateHandle FBltActorIndex::WorldCleanupHandle;
+FDelegateHandle FBltActorIndex::LevelAddedHandle;
+FDelegateHandle FBltActorIndex::LevelRemovedHandle;
+FDelegateHandle FBltActorIndex::ActorDeletedHandle;
+FDelegateHandle FBltActorIndex::PostEngineInitHandle;
+
+
+FBltActorIndex& FBltActorIndex::Get(UWorld* const World)
+{
+	check(World);
+
+	TUniquePtr<FBltActorIndex>& Index = Indices.FindOrAdd(World);
+	if (!Index)
+	{
+		Index.Reset(new FBltActorIndex(World));
+	}
+
+	return *Index;
+}
+
+void FBltActorIndex::RegisterWorldHooks()
+{
+	WorldCleanupHandle = FWorldDelegates::OnWorldCleanup.AddLambda(
+		[](UWorld* const World, bool, bool)
+		{
+			Indices.Remove(World);
+		}
+	);
+
+	LevelAddedHandle = FWorldDelegates::LevelAddedToWorld.AddLambda(
+		[](const ULevel* const Level, const UWorld* const World)
+		{
+			if (TUniquePtr<FBltActorIndex>* const Index = Indices.Find(const_cast<UWorld*>(World)))
+			{
+				(*Index)->AddLevel(Level);
+			}
+		}
+	);
+
+	LevelRemovedHandle = FWorldDelegates::LevelRemovedFromWorld.AddLambda(
+		[](const ULevel* const Level, const UWorld* const World)
+		{
+			if (TUniquePtr<FBltActorIndex>* const Index = Indices.Find(const_cast<UWorld*>(World)))
+			{
+				(*Index)->RemoveLevel(Level);
+			}
+		}
+	);
+
+	// Deletion is not broadcast in every configuration; dead entries are also dropped lazily by queries.
+	// The module loads before the engine exists
+	PostEngineInitHandle = FCoreDelegates::OnPostEngineInit.AddLambda([]()
+	{
+		if (!GEngine)
+			return;
+
+		ActorDeletedHandle = GEngine->OnLevelActorDeleted().AddLambda([](AActor* const Actor)
+		{
+			if (TUniquePtr<FBltActorIndex>* const Index = Actor ? Indices.Find(Actor->GetWorld()) : nullptr)
+			{
+				(*Index)->RemoveActor(Actor);
+			}
+		});
+	});
+}
+
+void FBltActorIndex::UnregisterWorldHooks()
+{
+	FWorldDelegates::OnWorldCleanup.Remove(WorldCleanupHandle);
+	FWorldDelegates::LevelAddedToWorld.Remove(LevelAddedHandle);
+	FWorldDelegates::LevelRemovedFromWorld.Remove(LevelRemovedHandle);
+	FCoreDelegates::OnPostEngineInit.Remove(PostEngineInitHandle);
+	if (GEngine)
+	{
+		GEngine->OnLevelActorDeleted().Remove(ActorDeletedHandle);
+	}
+
+	Indices.Empty();
+}
+
+UClass* FBltActorIndex::FindClass(const FString& ClassName)
+{
+	static TMap<FString, TWeakObjectPtr<UClass>> Classes;
+	static uint32 Generation = 0u;
+
+	const uint32 SchemaGeneration = FBltClassSchemaCache::Get().GetGeneration();
+	if (Generation != SchemaGeneration)
+	{
+		Classes.Empty();
+		Generation = SchemaGeneration;
+	}
+
+	if (const TWeakObjectPtr<UClass>* const Class = Classes.Find(ClassName))
+	{
+		if (Class->IsValid())
+			return Class->Get();
+	}
+
+	UClass* Class = FindObject<UClass>(ANY_PACKAGE, *ClassName);
+	if (!Class)
+	{
+		if (const UObjectRedirector* const RenamedClassRedirector = FindObject<UObjectRedirector>(ANY_PACKAGE, *ClassName))
+		{
+			Class = CastChecked<UClass>(RenamedClassRedirector->DestinationObject);
+		}
+	}
+
+	if (Class)
+	{
+		Classes.Add(ClassName, Class);
+	}
+
+	return Class;
+}
+
+FBltActorIndex::FBltActorIndex(UWorld* const InWorld)
+	: World(InWorld)
+	, SchemaGeneration(FBltClassSchemaCache::Get().GetGeneration())
+{
+	BLT_SCOPE_CYCLE_COUNTER(STAT_BltActorIndexBuild);
+
+	for (const ULevel* const Level : InWorld->GetLevels())
+	{
+		if (Level && Level->bIsVisible)
+		{
+			AddLevel(Level);
+		}
+	}
+
+	ActorSpawnedHandle = InWorld->AddOnActorSpawnedHandler(
+		FOnActorSpawned::FDelegate::CreateRaw(this, &FBltActorIndex::AddActor)
+	);
+}
+
+FBltActorIndex::~FBltActorIndex()
+{
+	if (UWorld* const IndexedWorld = World.Get())
+	{
+		IndexedWorld->RemoveOnActorSpawnedHandler(ActorSpawnedHandle);
+	}
+}
+
+void FBltActorIndex::GetActorsOfClass(const UClass* const Class, TArray<AActor*>& OutActors)
+{
+	if (!Class)
+		return;
+
+	BLT_SCOPE_CYCLE_COUNTER(STAT_BltActorLookup);
+
+	DropStaleClasses();
+	for (const UClass* const BucketClass : FindOrAddSubclasses(Class))
+	{
+		TArray<TWeakObjectPtr<AActor>>& Bucket = Buckets.FindChecked(BucketClass);
+		for (int32 ActorIndex = Bucket.Num() - 1; ActorIndex >= 0; --ActorIndex)
+		{
+			AActor* const Actor = Bucket[ActorIndex].Get();
+			if (!Actor || Actor->IsPendingKill())
+			{
+				Bucket.RemoveAtSwap(ActorIndex, 1, false);
+				continue;
+			}
+
+			OutActors.Add(Actor);
+		}
+	}
+}
+
+void FBltActorIndex::AddActor(AActor* const Actor)
+{
+	if (!Actor)
+		return;
+
+	DropStaleClasses();
+	const UClass* const Class = Actor->GetClass();
+	TArray<TWeakObjectPtr<AActor>>* Bucket = Buckets.Find(Class);
+	if (!Bucket)
+	{
+		Bucket = &Buckets.Add(Class);
+		for (TPair<const UClass*, TArray<const UClass*>>& Entry : Subclasses)
+		{
+			if (Class->IsChildOf(Entry.Key))
+			{
+				Entry.Value.Add(Class);
+			}
+		}
+	}
+
+	Bucket->Add(Actor);
+}
+
+void FBltActorIndex::RemoveActor(AActor* const Actor)
+{
+	if (TArray<TWeakObjectPtr<AActor>>* const Bucket = Buckets.Find(Actor->GetClass()))
+	{
+		Bucket->RemoveSingleSwap(Actor, false);
+	}
+}
+
+void FBltActorIndex::AddLevel(const ULevel* const Level)
+{
+	bool bAlreadyIndexed = false;
+	Levels.Add(Level, &bAlreadyIndexed);
+	if (bAlreadyIndexed)
+		return;
+
+	for (AActor* const Actor : Level->Actors)
+	{
+		AddActor(Actor);
+	}
+}
+
+void FBltActorIndex::RemoveLevel(const ULevel* const Level)
+{
+	// Null level means every level of the world went away
+	if (Level)
+	{
+		Levels.Remove(Level);
+	}
+	else
+	{
+		Levels.Empty();
+	}
+
+	for (TPair<const UClass*, TArray<TWeakObjectPtr<AActor>>>& Bucket : Buckets)
+	{
+		Bucket.Value.RemoveAllSwap([Level](const TWeakObjectPtr<AActor>& Actor)
+		{
+			return !Actor.IsValid() || !Level || Actor->GetLevel() == Level;
+		}, false);
+	}
+}
+
+void FBltActorIndex::DropStaleClasses()
+{
+	const uint32 CurrentGeneration = FBltClassSchemaCache::Get().GetGeneration();
+	if (SchemaGeneration == CurrentGeneration)
+		return;
+
+	SchemaGeneration = CurrentGeneration;
+	Subclasses.Empty();
+	for (auto Iterator = Buckets.CreateIterator(); Iterator; ++Iterator)
+	{
+		Iterator.Value().RemoveAllSwap([](const TWeakObjectPtr<AActor>& Actor)
+		{
+			return !Actor.IsValid();
+		}, false);
+
+		if (Iterator.Value().Num() == 0)
+		{
+			Iterator.RemoveCurrent();
+		}
+	}
+}
+
+const TArray<const UClass*>& FBltActorIndex::FindOrAddSubclasses(const UClass* const Class)
+{
+	if (const TArray<const UClass*>* const Found = Subclasses.Find(Class))
+		return *Found;
+
+	TArray<const UClass*> BucketClasses;
+	for (const TPair<const UClass*, TArray<TWeakObjectPtr<AActor>>>& Bucket : Buckets)
+	{
+		if (Bucket.Key->IsChildOf(Class))
+		{
+			BucketClasses.Add(Bucket.Key);
+		}
+	}
+
+	return Subclasses.Add(Class, MoveTemp(BucketClasses));
+}
@@ -0,0 +1,52 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+
+// Actors of one world bucketed by their exact class. The world is swept once when the index is
+// first asked for, then kept current from spawn, level streaming and deletion events, so fuzz
+// passes never scan the world again. Subclass queries go through a table of the bucket classes
+// deriving from each queried class, extended whenever a bucket for a new class shows up.
+class FBltActorIndex
+{
+public:
+	static FBltActorIndex& Get(UWorld* const World);
+
+	static void RegisterWorldHooks();
+	static void UnregisterWorldHooks();
+
+	~FBltActorIndex();
+
+	// Appends every live actor that is Class or derives from it
+	void GetActorsOfClass(const UClass* const Class, TArray<AActor*>& OutActors);
+
+	// Cached FindObject by class name, dropped whenever classes get reloaded
+	static UClass* FindClass(const FString& ClassName);
+
+private:
+	explicit FBltActorIndex(UWorld* const InWorld);
+
+	void AddActor(AActor* const Actor);
+	void RemoveActor(AActor* const Actor);
+	void AddLevel(const ULevel* const Level);
+	void RemoveLevel(const ULevel* const Level);
+
+	// Reloads replace classes, so buckets left without live actors and the subclass table are dropped
+	void DropStaleClasses();
+	const TArray<const UClass*>& FindOrAddSubclasses(const UClass* const Class);
+
+	TWeakObjectPtr<UWorld> World;
+	TSet<TWeakObjectPtr<const ULevel>> Levels;
+	TMap<const UClass*, TArray<TWeakObjectPtr<AActor>>> Buckets;
+	TMap<const UClass*, TArray<const UClass*>> Subclasses;
+	uint32 SchemaGeneration = 0u;
+
+	FDelegateHandle ActorSpawnedHandle;
+
+	static TMap<TWeakObjectPtr<UWorld>, TUniquePtr<FBltActorIndex>> Indices;
+	static FDelegateHandle WorldCleanupHandle;
+	static FDelegateHandle LevelAddedHandle;
+	static FDelegateHandle LevelRemovedHandle;
+	static FDelegateHandle ActorDeletedHandle;
+	static FDelegateHandle PostEngineInitHandle;
+};
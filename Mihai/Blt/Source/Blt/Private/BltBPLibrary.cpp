@@ -2,29 +2,28 @@
 
 #include "BltBPLibrary.h"
 
-#include "Kismet/GameplayStatics.h"
+#include "BltActorIndex.h"
+#include "BltClassSchema.h"
+#include "BltCorpus.h"
+#include "BltFuzzBatch.h"
+#include "BltFuzzFailures.h"
+#include "BltFuzzSpecReader.h"
+#include "BltFuzzSpecWatcher.h"
+#include "BltMutationJournal.h"
+#include "BltNamePool.h"
+#include "BltNumericMutators.h"
+#include "BltPropertyAccess.h"
+#include "BltRegexGenerator.h"
+#include "BltRestoreJournal.h"
+#include "BltSchemaSnapshot.h"
+#include "BltStats.h"
+#include "BltStringMutator.h"
+#include "BltWorldCheckpoint.h"
 #include "PythonBridge.h"
 
 DEFINE_LOG_CATEGORY(LogBlt);
 
 
-bool UBltBPLibrary::ParseJson(const FString& FilePath, TSharedPtr<FJsonObject>& OutObject)
-{
-	FString AbsoluteFilePath;
-	if (!GetAbsolutePath(FilePath, AbsoluteFilePath))
-		return false;
-	
-	FString JsonRaw;
-	FFileHelper::LoadFileToString(JsonRaw, *AbsoluteFilePath);
-	if (!FJsonSerializer::Deserialize<TCHAR>(TJsonReaderFactory<TCHAR>::Create(JsonRaw), OutObject))
-	{
-		UE_LOG(LogBlt, Error, TEXT("Could not deserialize %s [check if file is JSON]"), *AbsoluteFilePath);
-		return false;
-	}
-
-	return true;
-}
-
 bool UBltBPLibrary::GetAbsolutePath(const FString& FilePath, FString& AbsoluteFilePath)
 {
 	IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
@@ -44,14 +43,8 @@ bool UBltBPLibrary::GetAbsolutePath(const FString& FilePath, FString& AbsoluteFi
 UClass* UBltBPLibrary::FindClass(const FString& ClassName)
 {
 	check(*ClassName);
-	
-	if (UClass* const ClassType = FindObject<UClass>(ANY_PACKAGE, *ClassName))
-		return ClassType;
-
-	if (const UObjectRedirector* const RenamedClassRedirector = FindObject<UObjectRedirector>(ANY_PACKAGE, *ClassName))
-		return CastChecked<UClass>(RenamedClassRedirector->DestinationObject);
 
-	return nullptr;
+	return FBltActorIndex::FindClass(ClassName);
 }
 
 TArray<AActor*> UBltBPLibrary::GetAllActorsOfClass(
@@ -66,7 +59,11 @@ TArray<AActor*> UBltBPLibrary::GetAllActorsOfClass(
 	}
 
 	TArray<AActor*> OutActors;
-	UGameplayStatics::GetAllActorsOfClass(WorldContextObject->GetWorld(), ActorClass, OutActors);
+	if (UWorld* const World = WorldContextObject->GetWorld())
+	{
+		FBltActorIndex::Get(World).GetActorsOfClass(ActorClass, OutActors);
+	}
+
 	return OutActors;
 }
 
@@ -74,253 +71,495 @@ void UBltBPLibrary::ApplyFuzzing(
 	const UObject* const WorldContextObject,
 	const FString& FilePath,
 	const TArray<AActor*>& AffectedActors,
-	const bool bUseArray
+	const bool bUseArray,
+	const int64 Seed,
+	const int32 Iteration,
+	const bool bParallel
 )
 {
-	TSharedPtr<FJsonObject> JsonParsed;
-	if (!ParseJson(FilePath, JsonParsed))
+	const FBltFuzzPlanHandle& Plan = LoadFuzzPlan(FilePath);
+	if (!Plan.IsValid())
 		return;
 
-	const TMap<FString, TSharedPtr<FJsonValue>> JsonClasses = JsonParsed.Get()->Values;
-	for (const TTuple<FString, TSharedPtr<FJsonValue>>& JsonClass : JsonClasses)
-	{
-		const FString& ActorClassName = JsonClass.Key;
-		const TSharedPtr<FJsonObject>* ActorClassObject;
-		if (!JsonClass.Value->TryGetObject(ActorClassObject))
-		{
-			UE_LOG(LogBlt, Error, TEXT("Entry %s must have an Object type value!"), *ActorClassName);
-			continue;
-		}
-
-		RandomiseProperties(
-			ActorClassObject,
-			bUseArray ? AffectedActors : GetAllActorsOfClass(WorldContextObject, ActorClassName)
-		);
-	}
+	ApplyFuzzPlan(WorldContextObject, Plan, AffectedActors, bUseArray, Seed, Iteration, bParallel);
 }
 
 void UBltBPLibrary::K2ApplyFuzzing(
 	const UObject* const WorldContextObject,
 	const FString& FilePath,
 	const TArray<AActor*>& AffectedActors,
-	const bool bUseArray
+	const bool bUseArray,
+	const int64 Seed,
+	const int32 Iteration,
+	const bool bParallel
 )
 {
-	ApplyFuzzing(WorldContextObject, FilePath, AffectedActors, bUseArray);
+	ApplyFuzzing(WorldContextObject, FilePath, AffectedActors, bUseArray, Seed, Iteration, bParallel);
 }
 
-void UBltBPLibrary::RandomiseProperties(
-	const TSharedPtr<FJsonObject>* ActorClassObject,
-	const TArray<AActor*>& Actors
-)
+FBltFuzzPlanHandle UBltBPLibrary::LoadFuzzPlan(const FString& FilePath)
 {
-	const TMap<FString, TSharedPtr<FJsonValue>> ActorClassProperties = ActorClassObject->Get()->Values;
-	
-	for (AActor* const Actor : Actors)
+	// Loaded plans are kept current by the spec watcher, so only the first call touches the disk
+	for (const FString& CandidatePath : { FilePath, FPaths::ProjectContentDir() + FilePath })
 	{
+		const FBltFuzzPlanHandle Handle = FBltFuzzPlanRegistry::Get().FindByPath(FPaths::ConvertRelativePathToFull(CandidatePath));
+		if (Handle.IsValid())
+			return Handle;
+	}
 
-		if (!Actor)
-			continue;
+	FString AbsoluteFilePath;
+	if (!GetAbsolutePath(FilePath, AbsoluteFilePath))
+		return FBltFuzzPlanHandle();
 
-		FString currentProperties = FPaths::ProjectContentDir() + "Data\\currentProperties.txt";
-		FString baseProperties = FPaths::ProjectContentDir() + "Data\\baseProperties.txt";
-		if(GEngine)
-		GEngine->AddOnScreenDebugMessage(-1, 4, FColor::Green, baseProperties);
+	return ReloadFuzzPlan(FPaths::ConvertRelativePathToFull(AbsoluteFilePath));
+}
 
-		TMap<FString, FProperty*> property_map = LogCurrentProperties(Actor, currentProperties);
-		LogDefinedProperties(Actor, baseProperties, property_map);
+FBltFuzzPlanHandle UBltBPLibrary::ReloadFuzzPlan(const FString& AbsoluteFilePath)
+{
+	TArray<FBltFuzzClassSpec> Classes;
+	if (!FBltFuzzSpecReader::ReadFile(AbsoluteFilePath, Classes))
+		return FBltFuzzPlanHandle();
 
-		for (TFieldIterator<FProperty> Iterator(Actor->GetClass()); Iterator; ++Iterator)
+	for (FBltFuzzClassSpec& ClassSpec : Classes)
+	{
+		ClassSpec.Class = FindClass(ClassSpec.ClassName);
+		if (!ClassSpec.Class.IsValid())
 		{
-			const FProperty* const Property = *Iterator;
-			const FString& PropertyName = Property->GetNameCPP();
-			if (!ActorClassProperties.Contains(PropertyName))
-			{
-				if (property_map.Contains(PropertyName)) {
-					RandomiseNumericProperty(Property, nullptr, Actor);
-				}
-				continue;
-			}
-
-			const FJsonValue* const PropertyValue = ActorClassProperties.Find(PropertyName)->Get();
-			switch (PropertyValue->Type)
-			{
-			case EJson::Array:
-				RandomiseNumericProperty(Property, PropertyValue, Actor);
-				break;
-
-			case EJson::String:
-				RandomiseStringProperty(Property, PropertyValue, Actor);
-				break;
-				
-			default:
-				break;
-			}
+			UE_LOG(LogBlt, Warning, TEXT("Class %s could not be found!"), *ClassSpec.ClassName);
 		}
 	}
+
+	FBltFuzzPlanRegistry& Registry = FBltFuzzPlanRegistry::Get();
+	const FBltFuzzPlanPtr Previous = Registry.Find(Registry.FindByPath(AbsoluteFilePath));
+	FBltFuzzSpecWatcher::Get().Watch(FPaths::GetPath(AbsoluteFilePath));
+
+	return Registry.Register(
+		AbsoluteFilePath,
+		MakeShared<const FBltFuzzPlan, ESPMode::ThreadSafe>(AbsoluteFilePath, MoveTemp(Classes), Previous.Get())
+	);
 }
 
-void UBltBPLibrary::RandomiseNumericProperty(
-	const FProperty* const Property,
-	const FJsonValue* const PropertyValue,
-	AActor* const Actor
+void UBltBPLibrary::UnloadFuzzPlan(const FBltFuzzPlanHandle& Plan)
+{
+	FBltFuzzPlanRegistry::Get().Unregister(Plan);
+}
+
+void UBltBPLibrary::ApplyFuzzPlan(
+	const UObject* const WorldContextObject,
+	const FBltFuzzPlanHandle& Plan,
+	const TArray<AActor*>& AffectedActors,
+	const bool bUseArray,
+	const int64 Seed,
+	const int32 Iteration,
+	const bool bParallel
 )
 {
-	const FNumericProperty* const NumericProperty = CastField<const FNumericProperty>(Property);
-	if (!NumericProperty)
+	// Keeps the plan alive for the whole pass even if it gets reloaded meanwhile
+	const FBltFuzzPlanPtr FuzzPlan = FBltFuzzPlanRegistry::Get().Find(Plan);
+	if (!FuzzPlan)
+	{
+		UE_LOG(LogBlt, Error, TEXT("Fuzz plan %d is not loaded!"), Plan.Id);
 		return;
-	 float IntervalMin;
-	float IntervalMax;
-	if (PropertyValue) {
-		const TArray<TSharedPtr<FJsonValue>>& Interval = PropertyValue->AsArray();
-		IntervalMin = Interval[0u].Get()->AsNumber();
-		IntervalMax = Interval[1u].Get()->AsNumber();
 	}
-	else {
-		IntervalMin = 0;
-		IntervalMax = 1000000;
+
+	FBltFuzzPass Pass;
+	Pass.Seed = Seed;
+	Pass.Iteration = Iteration >= 0 ? Iteration : FBltFuzzPlanRegistry::Get().AdvanceIteration(Plan);
+	ApplyFuzzPass(WorldContextObject, *FuzzPlan, Pass, AffectedActors, bUseArray, bParallel);
+}
+
+void UBltBPLibrary::ApplyFuzzPass(
+	const UObject* const WorldContextObject,
+	const FBltFuzzPlan& FuzzPlan,
+	const FBltFuzzPass& Pass,
+	const TArray<AActor*>& AffectedActors,
+	const bool bUseArray,
+	const bool bParallel
+)
+{
+	UE_LOG(LogBlt, Verbose, TEXT("Fuzzing %s with seed %lld, iteration %d"), *FuzzPlan.GetSourcePath(), Pass.Seed, Pass.Iteration);
+
+	const TArray<AActor*> Targets = GatherFuzzTargets(WorldContextObject, FuzzPlan, AffectedActors, bUseArray);
+
+	FBltFuzzBatch Batch(Pass);
+	for (AActor* const Actor : Targets)
+	{
+		const FBltFuzzClassPlan* const ClassPlan = FuzzPlan.FindOrResolveActorPlan(Actor->GetClass());
+		if (!ClassPlan)
+			continue;
+
+		if (bParallel)
+		{
+			Batch.Add(Actor, *ClassPlan);
+		}
+		else
+		{
+			RandomiseProperties(Actor, *ClassPlan, Pass);
+		}
+	}
+
+	if (Batch.Num() > 0)
+	{
+		Batch.Compute();
+		Batch.Commit();
 	}
-	
-	float RandomValue = FMath::RandRange(IntervalMin, IntervalMax);
-							
-	NumericProperty->SetNumericPropertyValueFromString(
-		NumericProperty->ContainerPtrToValuePtr<float>(Actor),
-		*FString::Printf(TEXT("%f"), RandomValue)
-	);
-	GEngine->AddOnScreenDebugMessage(-1, 500, FColor::Green, *Property->GetNameCPP());
-	GEngine->AddOnScreenDebugMessage(-1, 500, FColor::Green, *FString::Printf(TEXT("%f"), RandomValue));
 
+	FBltMutationJournal::Get().ShowSummary();
+}
 
+void UBltBPLibrary::K2ApplyFuzzPlan(
+	const UObject* const WorldContextObject,
+	const FBltFuzzPlanHandle& Plan,
+	const TArray<AActor*>& AffectedActors,
+	const bool bUseArray,
+	const int64 Seed,
+	const int32 Iteration,
+	const bool bParallel
+)
+{
+	ApplyFuzzPlan(WorldContextObject, Plan, AffectedActors, bUseArray, Seed, Iteration, bParallel);
 }
 
-void UBltBPLibrary::RandomiseStringProperty(
-	const FProperty* const Property,
-	const FJsonValue* const PropertyValue,
-	AActor* const Actor
+bool UBltBPLibrary::ExportClassSchema(
+	const UClass* const Class,
+	const FString& FilePath,
+	const bool bUserDefinedOnly
 )
 {
-	const UPythonBridge* const PythonBridge = UPythonBridge::Get();
-	if (!PythonBridge)
-	{
-		UE_LOG(LogBlt, Error, TEXT("Python bridge could not be instantiated!"));
+	if (!Class)
+		return false;
+
+	return FBltClassSchemaCache::Get().Export(Class, FilePath, bUserDefinedOnly);
+}
+
+void UBltBPLibrary::LogNewProperties(const UObject* const TargetObject)
+{
+	if (!TargetObject)
 		return;
+
+	const FBltClassSchemaPtr Schema = FBltClassSchemaCache::Get().FindOrBuild(TargetObject->GetClass());
+	FBltSchemaSnapshot& Snapshot = FBltSchemaSnapshot::Get();
+
+	TArray<const FProperty*> AddedProperties;
+	int32 RemovedCount = 0;
+	if (Snapshot.HasChanged(*Schema))
+	{
+		Snapshot.Diff(*Schema, AddedProperties, RemovedCount);
+		Snapshot.Update(*Schema);
 	}
-	
-	const FString& RandomString = PythonBridge->GenerateStringFromRegex(PropertyValue->AsString());
 
-	const FStrProperty* const StringProperty = CastField<const FStrProperty>(Property);
-	if (StringProperty)
+	const FString ClassName = TargetObject->GetClass()->GetName();
+	for (const FProperty* const Property : AddedProperties)
 	{
-		StringProperty->SetPropertyValue_InContainer(Actor, RandomString);
-		return;
+		UE_LOG(LogBlt, Log, TEXT("New property %s.%s"), *ClassName, *Property->GetNameCPP());
 	}
-	
-	const FNameProperty* const NameProperty = CastField<const FNameProperty>(Property);
-	if (NameProperty)
+
+	// One line per class, replaced in place when the same class is checked again
+	if (GEngine)
 	{
-		NameProperty->SetPropertyValue_InContainer(Actor, FName(RandomString));
-		return;
+		GEngine->AddOnScreenDebugMessage(
+			static_cast<uint64>(GetTypeHash(ClassName)),
+			10.f,
+			FColor::Red,
+			AddedProperties.Num() > 0
+				? FString::Printf(TEXT("%s: %d new properties, see the log"), *ClassName, AddedProperties.Num())
+				: FString::Printf(TEXT("%s: no new properties"), *ClassName)
+		);
 	}
+}
+
+bool UBltBPLibrary::SavePropertySnapshot()
+{
+	return FBltSchemaSnapshot::Get().Flush();
+}
 
-	const FTextProperty* const TextProperty = CastField<const FTextProperty>(Property);
-	if (TextProperty)
+int32 UBltBPLibrary::RestoreFuzzedProperties()
+{
+	const int32 RestoredCount = FBltRestoreJournal::Get().Restore();
+	UE_LOG(LogBlt, Log, TEXT("Restored %d fuzzed properties"), RestoredCount);
+	return RestoredCount;
+}
+
+bool UBltBPLibrary::SaveWorldCheckpoint(const UObject* const WorldContextObject, const FBltFuzzPlanHandle& Plan)
+{
+	const FBltFuzzPlanPtr FuzzPlan = FBltFuzzPlanRegistry::Get().Find(Plan);
+	UWorld* const World = WorldContextObject ? WorldContextObject->GetWorld() : nullptr;
+	if (!FuzzPlan || !World)
 	{
-		TextProperty->SetPropertyValue_InContainer(Actor, FText::FromString(RandomString));
-		return;
+		UE_LOG(LogBlt, Error, TEXT("A checkpoint needs a loaded fuzz plan and a world!"));
+		return false;
 	}
 
-	UE_LOG(LogBlt, Fatal, TEXT("%s is not FString, FName or FText!"), *Property->GetFullName());
+	FBltWorldCheckpoint::Get(World).Capture(*FuzzPlan);
+	return true;
+}
+
+int32 UBltBPLibrary::ResetWorldCheckpoint(const UObject* const WorldContextObject)
+{
+	const UWorld* const World = WorldContextObject ? WorldContextObject->GetWorld() : nullptr;
+	FBltWorldCheckpoint* const Checkpoint = FBltWorldCheckpoint::Find(World);
+	if (!Checkpoint || !Checkpoint->IsCaptured())
+	{
+		UE_LOG(LogBlt, Warning, TEXT("No checkpoint was saved for this world"));
+		return 0;
+	}
+
+	return Checkpoint->Reset();
 }
 
-//////////
+void UBltBPLibrary::ReportFuzzFailure(const UObject* const WorldContextObject, const FString& Reason)
+{
+	const UWorld* const World = WorldContextObject ? WorldContextObject->GetWorld() : nullptr;
+	UE_LOG(LogBlt, Warning, TEXT("Fuzz failure reported: %s"), *Reason);
+	FBltFuzzFailures::Report(World, Reason);
+}
 
-TMap<FString, FProperty*> UBltBPLibrary::LogCurrentProperties(UObject* targetObject,  FString& currentProperties) {
-	std::fstream fsCurrent;
-	std::string strFilePath = std::string(TCHAR_TO_UTF8(*currentProperties));
-	fsCurrent.open(strFilePath, std::fstream::in | std::fstream::out | std::fstream::trunc);
+void UBltBPLibrary::RandomiseProperties(
+	AActor* const Actor,
+	const FBltFuzzClassPlan& ClassPlan,
+	const FBltFuzzPass& Pass
+)
+{
+	BLT_SCOPE_CYCLE_COUNTER(STAT_BltRandomiseProperties);
+	BLT_SCOPE_MUTATION_BATCH();
 
-	TMap<FString, FProperty*> property_map;
-	for (TFieldIterator<FProperty> PropIt(targetObject->GetClass()); PropIt; ++PropIt)
+	const uint32 ActorId = FBltRandomStream::HashObject(Actor);
+	for (const FBltFuzzPropertyPlan& PropertyPlan : ClassPlan.Properties)
 	{
-		FProperty* Property = *PropIt;
-		FString property_name = Property->GetNameCPP();
-		property_map.Add(property_name, Property);
+		RandomiseProperty(Actor, PropertyPlan, Pass, ActorId);
+	}
+}
+
+TArray<AActor*> UBltBPLibrary::GatherFuzzTargets(
+	const UObject* const WorldContextObject,
+	const FBltFuzzPlan& FuzzPlan,
+	const TArray<AActor*>& AffectedActors,
+	const bool bUseArray
+)
+{
+	UWorld* const World = WorldContextObject ? WorldContextObject->GetWorld() : nullptr;
+	FBltActorIndex* const ActorIndex = !bUseArray && World ? &FBltActorIndex::Get(World) : nullptr;
 
-		FString property_type = Property->GetCPPType();
-		fsCurrent << TCHAR_TO_UTF8(*property_name) << '\n';
+	TArray<AActor*> Targets;
+	TSet<const AActor*> Seen;
+	if (ActorIndex)
+	{
+		for (const FBltFuzzClassSpec& ClassSpec : FuzzPlan.GetClasses())
+		{
+			if (const UClass* const JsonActorClassType = ClassSpec.Class.Get())
+			{
+				TArray<AActor*> ClassActors;
+				ActorIndex->GetActorsOfClass(JsonActorClassType, ClassActors);
+				for (AActor* const Actor : ClassActors)
+				{
+					if (!Seen.Contains(Actor))
+					{
+						Seen.Add(Actor);
+						Targets.Add(Actor);
+					}
+				}
+			}
+		}
+	}
+	else if (bUseArray)
+	{
+		for (AActor* const Actor : AffectedActors)
+		{
+			if (Actor && !Seen.Contains(Actor))
+			{
+				Seen.Add(Actor);
+				Targets.Add(Actor);
+			}
+		}
 	}
 
-	fsCurrent.close();
-	return property_map;
+	return Targets;
+}
 
+bool UBltBPLibrary::IsBaseProperty(const FName PropertyName)
+{
+	return FBltClassSchemaCache::Get().IsBaseProperty(PropertyName);
 }
 
+void UBltBPLibrary::RandomiseProperty(
+	AActor* const Actor,
+	const FBltFuzzPropertyPlan& PropertyPlan,
+	const FBltFuzzPass& Pass,
+	const uint32 ActorId
+)
+{
+	BLT_SCOPE_MUTATION_BATCH();
 
-void UBltBPLibrary::LogNewProperties(UObject* targetObject,  FString& oldProperties,  FString& currentProperties) {
-	std::fstream fsOld, fsCurrent;
-	
-	std::string strFilePath0 = std::string(TCHAR_TO_UTF8(*oldProperties));
-	std::string strFilePath1 = std::string(TCHAR_TO_UTF8(*currentProperties));
-	LogCurrentProperties(targetObject, currentProperties);
-	TArray<FString> comparison;
+	FBltPropertyAccess::ForEachValue(Actor, PropertyPlan, [&](UObject* const Owner, void* const ValuePtr, const uint32 ValueId)
+	{
+		FBltRandomStream Stream(Pass.Seed, Pass.Iteration, ActorId, ValueId);
+
+		const FBltFuzzValue* const GuidedValue = Pass.Guide ? Pass.Guide->Pick(ActorId, ValueId, PropertyPlan, Stream) : nullptr;
+		if (!GuidedValue && Pass.Guide && Pass.Guide->IsExclusive())
+			return;
+
+		switch (PropertyPlan.Type)
+		{
+		case EBltFuzzValueType::String:
+		case EBltFuzzValueType::Name:
+		case EBltFuzzValueType::Text:
+			RandomiseStringProperty(PropertyPlan, Owner, ValuePtr, ActorId, ValueId, Stream, GuidedValue);
+			break;
+
+		default:
+			RandomiseNumericProperty(PropertyPlan, Owner, ValuePtr, ActorId, ValueId, Stream, GuidedValue);
+			break;
+		}
+	});
+}
+
+void UBltBPLibrary::RandomiseNumericProperty(
+	const FBltFuzzPropertyPlan& PropertyPlan,
+	UObject* const Owner,
+	void* const ValuePtr,
+	const uint32 ActorId,
+	const uint32 ValueId,
+	FBltRandomStream& Stream,
+	const FBltFuzzValue* const GuidedValue
+)
+{
+	BLT_SCOPE_CYCLE_COUNTER(STAT_BltNumericMutator);
 
-	std::string line;
+	uint64 OldBits;
+	if (!FBltNumericMutators::Read(PropertyPlan, ValuePtr, OldBits))
+		return;
 
-	fsCurrent.open(strFilePath1, std::fstream::in | std::fstream::out | std::fstream::app);
-	while (std::getline(fsCurrent, line))
+	uint64 NewBits = GuidedValue ? GuidedValue->Bits : 0u;
+	if (!GuidedValue && PropertyPlan.Strategy == EBltFuzzStrategy::Mutate)
 	{
-		FString p_name = UTF8_TO_TCHAR(line.c_str());
-		comparison.Add(p_name);
+		FBltNumericMutators::Perturb(PropertyPlan, Stream, OldBits, NewBits);
 	}
-	fsCurrent.close();
+	else if (!GuidedValue)
+	{
+		FBltNumericMutators::Sample(PropertyPlan, Stream, NewBits);
+	}
+	FBltRestoreJournal::Get().Capture(Owner, PropertyPlan.RootProperty);
+	FBltNumericMutators::Write(PropertyPlan, ValuePtr, NewBits);
+
+	BLT_COUNT_MUTATION(PropertyPlan.Property->ElementSize);
+	FBltMutationJournal::Get().Record(ActorId, ValueId, PropertyPlan.Type, OldBits, NewBits);
+}
+
+void UBltBPLibrary::RandomiseStringProperty(
+	const FBltFuzzPropertyPlan& PropertyPlan,
+	UObject* const Owner,
+	void* const ValuePtr,
+	const uint32 ActorId,
+	const uint32 ValueId,
+	FBltRandomStream& Stream,
+	const FBltFuzzValue* const GuidedValue
+)
+{
+	BLT_SCOPE_CYCLE_COUNTER(STAT_BltStringMutator);
 
-	fsOld.open(strFilePath0, std::fstream::in | std::fstream::out | std::fstream::app);
-	while (std::getline(fsOld, line))
+	FBltRestoreJournal::Get().Capture(Owner, PropertyPlan.RootProperty);
+	if (GuidedValue)
 	{
-		FString p_name = UTF8_TO_TCHAR(line.c_str());
-		comparison.Remove(p_name);
+		WriteStringProperty(PropertyPlan, ActorId, ValueId, ValuePtr, GuidedValue->String);
+		return;
 	}
-	fsOld.close();
 
-	if (comparison.Num() > 0)
-		GEngine->AddOnScreenDebugMessage(-1, 500, FColor::Red, "No new properties");
-	else {
-		GEngine->AddOnScreenDebugMessage(-1, 500, FColor::Red, "New properties:");
+	INC_DWORD_STAT(STAT_BltStringsGenerated);
 
-		for (const FString& elem : comparison) {
-			GEngine->AddOnScreenDebugMessage(-1, 4, FColor::Red, elem);
-		}
+	if (PropertyPlan.Strategy == EBltFuzzStrategy::Mutate)
+	{
+		FString Value;
+		FBltStringMutator::Read(PropertyPlan, ValuePtr, Value);
+		FBltStringMutator::Perturb(PropertyPlan, Stream, Value);
+		WriteStringProperty(PropertyPlan, ActorId, ValueId, ValuePtr, Value);
+		return;
 	}
 
-	fsOld.open(strFilePath0, std::fstream::in | std::fstream::out | std::fstream::trunc);
-	fsCurrent.open(strFilePath1, std::fstream::in | std::fstream::out | std::fstream::app);
-	while (std::getline(fsCurrent, line))
+	if (PropertyPlan.NamePool && PropertyPlan.NamePool->IsPregenerated())
 	{
-		fsOld << line << '\n';
+		BLT_COUNT_NAME_LOOKUP(true);
+		BLT_COUNT_MUTATION(sizeof(FName));
+		WriteNameProperty(ActorId, ValueId, ValuePtr, PropertyPlan.NamePool->GetName(PropertyPlan.NamePool->Pick(Stream)));
+		return;
 	}
-	fsOld.close();
-	fsCurrent.close();
 
+	if (PropertyPlan.Generator)
+	{
+		if (PropertyPlan.Type == EBltFuzzValueType::String)
+		{
+			// FString properties are rendered in place, the old value moves out for the journal
+			FString& Value = *static_cast<FString*>(ValuePtr);
+			const FString OldValue = MoveTemp(Value);
+			PropertyPlan.Generator->Generate(Stream, Value);
+
+			BLT_COUNT_MUTATION(Value.Len() * sizeof(TCHAR));
+			FBltMutationJournal::Get().RecordString(ActorId, ValueId, PropertyPlan.Type, OldValue, Value);
+			return;
+		}
 
-}
+		FString RandomString;
+		PropertyPlan.Generator->Generate(Stream, RandomString);
+		WriteStringProperty(PropertyPlan, ActorId, ValueId, ValuePtr, RandomString);
+		return;
+	}
 
-// take obj, baseprops filePath, map
-// eliminates baseprops from map
-// edits map to only contain user defined properties
+	const UPythonBridge* const PythonBridge = UPythonBridge::Get();
+	if (!PythonBridge)
+	{
+		UE_LOG(LogBlt, Error, TEXT("Python bridge could not be instantiated!"));
+		return;
+	}
+	
+	FString RandomString;
+	{
+		BLT_SCOPE_CYCLE_COUNTER(STAT_BltPythonBridge);
+		RandomString = PythonBridge->GenerateStringFromRegex(PropertyPlan.Regex);
+	}
 
-// LogDefinedProperties(Actor, "Data\\baseProperties.txt", property_map);
-void UBltBPLibrary::LogDefinedProperties(UObject* targetObject,  FString& baseProperties, TMap<FString, FProperty*>& property_map) {
+	WriteStringProperty(PropertyPlan, ActorId, ValueId, ValuePtr, RandomString);
+}
 
-	std::fstream fs;
-	std::string strFilePath0 = std::string(TCHAR_TO_UTF8(*baseProperties));
-	fs.open(strFilePath0, std::fstream::in | std::fstream::out | std::fstream::app);
-	std::string line;
+void UBltBPLibrary::WriteStringProperty(
+	const FBltFuzzPropertyPlan& PropertyPlan,
+	const uint32 ActorId,
+	const uint32 ValueId,
+	void* const ValuePtr,
+	const FString& RandomString
+)
+{
+	BLT_COUNT_MUTATION(RandomString.Len() * sizeof(TCHAR));
+
+	FBltMutationJournal& Journal = FBltMutationJournal::Get();
 
-	while (std::getline(fs, line))
+	switch (PropertyPlan.Type)
 	{
-		FString p_name = UTF8_TO_TCHAR(line.c_str());
-		property_map.Remove(p_name);
+	case EBltFuzzValueType::String:
+		Journal.RecordString(ActorId, ValueId, PropertyPlan.Type, *static_cast<FString*>(ValuePtr), RandomString);
+		*static_cast<FString*>(ValuePtr) = RandomString;
+		break;
+
+	case EBltFuzzValueType::Name:
+		WriteNameProperty(ActorId, ValueId, ValuePtr, PropertyPlan.NamePool->Intern(RandomString));
+		break;
+
+	case EBltFuzzValueType::Text:
+		Journal.RecordString(ActorId, ValueId, PropertyPlan.Type, static_cast<FText*>(ValuePtr)->ToString(), RandomString);
+		*static_cast<FText*>(ValuePtr) = FText::FromString(RandomString);
+		break;
+
+	default:
+		UE_LOG(LogBlt, Fatal, TEXT("%s is not FString, FName or FText!"), *PropertyPlan.Property->GetFullName());
 	}
-	fs.close();
+}
 
+void UBltBPLibrary::WriteNameProperty(
+	const uint32 ActorId,
+	const uint32 ValueId,
+	void* const ValuePtr,
+	const FName Name
+)
+{
+	FName& Value = *static_cast<FName*>(ValuePtr);
+	FBltMutationJournal::Get().RecordString(ActorId, ValueId, EBltFuzzValueType::Name, Value.ToString(), Name.ToString());
+	Value = Name;
 }
@@ -0,0 +1,180 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "BltClassSchema.h"
+
+#include "BltBPLibrary.h"
+#include "BltStats.h"
+#include "Hash/CityHash.h"
+
+#if WITH_EDITOR
+#include "Editor.h"
+#endif
+
+
+uint64 FBltClassSchemaCache::HashString(const FString& String)
+{
+	return CityHash64(reinterpret_cast<const char*>(*String), String.Len() * sizeof(TCHAR));
+}
+
+FBltClassSchemaCache& FBltClassSchemaCache::Get()
+{
+	static FBltClassSchemaCache Cache;
+	return Cache;
+}
+
+void FBltClassSchemaCache::RegisterInvalidationHooks()
+{
+	ReloadCompleteHandle = FCoreUObjectDelegates::ReloadCompleteDelegate.AddLambda(
+		[this](const EReloadCompleteReason)
+		{
+			Invalidate();
+		}
+	);
+
+#if WITH_EDITOR
+	// The module loads before the editor engine exists
+	PostEngineInitHandle = FCoreDelegates::OnPostEngineInit.AddLambda([this]()
+	{
+		if (GEditor)
+		{
+			BlueprintCompiledHandle = GEditor->OnBlueprintCompiled().AddRaw(this, &FBltClassSchemaCache::Invalidate);
+		}
+	});
+#endif
+}
+
+void FBltClassSchemaCache::UnregisterInvalidationHooks()
+{
+	FCoreUObjectDelegates::ReloadCompleteDelegate.Remove(ReloadCompleteHandle);
+
+#if WITH_EDITOR
+	FCoreDelegates::OnPostEngineInit.Remove(PostEngineInitHandle);
+	if (GEditor)
+	{
+		GEditor->OnBlueprintCompiled().Remove(BlueprintCompiledHandle);
+	}
+#endif
+}
+
+FBltClassSchemaPtr FBltClassSchemaCache::FindOrBuild(const UClass* const Class)
+{
+	{
+		FReadScopeLock ReadLock(Lock);
+		if (const FBltClassSchemaPtr* const Schema = Schemas.Find(Class))
+		{
+			if ((*Schema)->Class.IsValid())
+			{
+				INC_DWORD_STAT(STAT_BltSchemaCacheHits);
+				return *Schema;
+			}
+		}
+	}
+
+	INC_DWORD_STAT(STAT_BltSchemaCacheMisses);
+
+	FWriteScopeLock WriteLock(Lock);
+	FBltClassSchemaPtr& Schema = Schemas.FindOrAdd(Class);
+	if (!Schema || !Schema->Class.IsValid())
+	{
+		Schema = Build(Class);
+	}
+
+	return Schema;
+}
+
+void FBltClassSchemaCache::Invalidate()
+{
+	FWriteScopeLock WriteLock(Lock);
+
+	Schemas.Empty();
+	BaseProperties.Reset();
+	++Generation;
+}
+
+bool FBltClassSchemaCache::IsBaseProperty(const FName PropertyName)
+{
+	{
+		FReadScopeLock ReadLock(Lock);
+		if (BaseProperties.IsSet())
+			return BaseProperties->Contains(PropertyName);
+	}
+
+	// First call, or the first since an invalidation
+	FWriteScopeLock WriteLock(Lock);
+	return GetBaseProperties().Contains(PropertyName);
+}
+
+bool FBltClassSchemaCache::Export(const UClass* const Class, const FString& FilePath, const bool bUserDefinedOnly)
+{
+	const FBltClassSchemaPtr Schema = FindOrBuild(Class);
+
+	TArray<FString> Lines;
+	Lines.Reserve(Schema->Properties.Num());
+	for (const FBltSchemaProperty& SchemaProperty : Schema->Properties)
+	{
+		if (!bUserDefinedOnly || SchemaProperty.bUserDefined)
+		{
+			Lines.Add(SchemaProperty.Property->GetNameCPP());
+		}
+	}
+
+	if (!FFileHelper::SaveStringArrayToFile(Lines, *FilePath))
+	{
+		UE_LOG(LogBlt, Error, TEXT("Could not write the schema of %s to %s"), *Class->GetName(), *FilePath);
+		return false;
+	}
+
+	return true;
+}
+
+FBltClassSchemaPtr FBltClassSchemaCache::Build(const UClass* const Class)
+{
+	const TSet<FName>& Base = GetBaseProperties();
+
+	TSharedRef<FBltClassSchema, ESPMode::ThreadSafe> Schema = MakeShared<FBltClassSchema, ESPMode::ThreadSafe>();
+	Schema->Class = Class;
+	Schema->Generation = Generation.load();
+
+	for (TFieldIterator<FProperty> Iterator(Class); Iterator; ++Iterator)
+	{
+		FBltSchemaProperty& SchemaProperty = Schema->Properties.AddDefaulted_GetRef();
+		SchemaProperty.Property = *Iterator;
+		SchemaProperty.bUserDefined = !Base.Contains(Iterator->GetFName());
+
+		FBltSchemaLayoutEntry& LayoutEntry = Schema->Layout.AddDefaulted_GetRef();
+		LayoutEntry.NameHash = HashString(Iterator->GetName());
+		LayoutEntry.TypeHash = FCrc::StrCrc32(*Iterator->GetCPPType());
+		LayoutEntry.Offset = Iterator->GetOffset_ForInternal();
+	}
+
+	Schema->Layout.Sort([](const FBltSchemaLayoutEntry& A, const FBltSchemaLayoutEntry& B)
+	{
+		return A.NameHash < B.NameHash;
+	});
+
+	Schema->ClassHash = HashString(Class->GetPathName());
+	Schema->Fingerprint = CityHash64(
+		reinterpret_cast<const char*>(Schema->Layout.GetData()),
+		Schema->Layout.Num() * sizeof(FBltSchemaLayoutEntry)
+	);
+
+	return Schema;
+}
+
+const TSet<FName>& FBltClassSchemaCache::GetBaseProperties()
+{
+	if (!BaseProperties.IsSet())
+	{
+		TArray<FString> Lines;
+		FFileHelper::LoadFileToStringArray(Lines, *(FPaths::ProjectContentDir() + "Data\\baseProperties.txt"));
+
+		TSet<FName>& Names = BaseProperties.Emplace();
+		Names.Reserve(Lines.Num());
+		for (const FString& Line : Lines)
+		{
+			Names.Add(FName(*Line));
+		}
+	}
+
+	return BaseProperties.GetValue();
+}
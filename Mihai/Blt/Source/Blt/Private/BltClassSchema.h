@@ -0,0 +1,79 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include <atomic>
+
+
+struct FBltSchemaProperty
+{
+	const FProperty* Property = nullptr;
+
+	// False for everything listed in Data/baseProperties.txt (engine and shared base class fields)
+	bool bUserDefined = false;
+};
+
+// Persisted form of a property, see FBltSchemaSnapshot
+struct FBltSchemaLayoutEntry
+{
+	uint64 NameHash = 0u;
+	uint32 TypeHash = 0u;
+	int32 Offset = 0;
+};
+
+// Reflection data of one UClass that only changes when the class itself is rebuilt
+struct FBltClassSchema
+{
+	TWeakObjectPtr<const UClass> Class;
+	uint32 Generation = 0u;
+	TArray<FBltSchemaProperty> Properties;
+
+	// Hash of the class path, fingerprint of the whole layout and the layout sorted by name hash
+	uint64 ClassHash = 0u;
+	uint64 Fingerprint = 0u;
+	TArray<FBltSchemaLayoutEntry> Layout;
+};
+
+using FBltClassSchemaPtr = TSharedPtr<const FBltClassSchema, ESPMode::ThreadSafe>;
+
+
+// Schemas are built once per UClass and dropped on hot reload and Blueprint recompilation,
+// which replace classes and free their FProperty objects
+class FBltClassSchemaCache
+{
+public:
+	static FBltClassSchemaCache& Get();
+
+	void RegisterInvalidationHooks();
+	void UnregisterInvalidationHooks();
+
+	FBltClassSchemaPtr FindOrBuild(const UClass* const Class);
+	void Invalidate();
+
+	// Bumped by every invalidation; anything derived from a schema must be rebuilt once it changes
+	uint32 GetGeneration() const { return Generation.load(); }
+
+	// Stable across processes, used for class paths and property names
+	static uint64 HashString(const FString& String);
+
+	// Listed in Data/baseProperties.txt: engine properties, and fields such as the fuzz seed that no fuzzer may touch
+	bool IsBaseProperty(const FName PropertyName);
+
+	// Explicit, optional disk output of the property names of a class, one per line
+	bool Export(const UClass* const Class, const FString& FilePath, const bool bUserDefinedOnly);
+
+private:
+	FBltClassSchemaPtr Build(const UClass* const Class);
+
+	// Loads the list on first use; callers hold the write lock
+	const TSet<FName>& GetBaseProperties();
+
+	FRWLock Lock;
+	TMap<const UClass*, FBltClassSchemaPtr> Schemas;
+	TOptional<TSet<FName>> BaseProperties;
+	std::atomic<uint32> Generation{0u};
+
+	FDelegateHandle ReloadCompleteHandle;
+	FDelegateHandle PostEngineInitHandle;
+	FDelegateHandle BlueprintCompiledHandle;
+};
@@ -0,0 +1,241 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "BltCorpus.h"
+
+#include "BltBPLibrary.h"
+#include "BltRandom.h"
+#include "Hash/CityHash.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+
+
+namespace
+{
+	constexpr uint32 CorpusMagic = 0x43544C42u; // "BLTC"
+	constexpr uint32 CorpusVersion = 1u;
+	const TCHAR* const CorpusExtension = TEXT(".bltcorpus");
+
+	void SerializeValues(FArchive& Archive, TMap<uint64, FBltFuzzValue>& Values)
+	{
+		int32 ValueCount = Values.Num();
+		Archive << ValueCount;
+
+		if (Archive.IsLoading())
+		{
+			Values.Reserve(ValueCount);
+			for (int32 ValueIndex = 0; ValueIndex < ValueCount && !Archive.IsError(); ++ValueIndex)
+			{
+				uint64 Key = 0u;
+				uint8 Type = 0u;
+				FBltFuzzValue Value;
+				Archive << Key << Type << Value.Bits << Value.String;
+				Value.Type = static_cast<EBltFuzzValueType>(Type);
+				Values.Add(Key, MoveTemp(Value));
+			}
+			return;
+		}
+
+		for (TPair<uint64, FBltFuzzValue>& Pair : Values)
+		{
+			uint8 Type = static_cast<uint8>(Pair.Value.Type);
+			Archive << Pair.Key << Type << Pair.Value.Bits << Pair.Value.String;
+		}
+	}
+}
+
+
+void FBltCorpusEntry::ComputeHash()
+{
+	Values.KeySort(TLess<uint64>());
+
+	TArray<uint8> Bytes;
+	FMemoryWriter Writer(Bytes);
+	SerializeValues(Writer, Values);
+
+	Hash = CityHash64(reinterpret_cast<const char*>(Bytes.GetData()), Bytes.Num());
+}
+
+bool FBltCorpusEntry::Save(const FString& FilePath)
+{
+	TArray<uint8> Bytes;
+	FMemoryWriter Writer(Bytes);
+
+	uint32 Magic = CorpusMagic;
+	uint32 Version = CorpusVersion;
+	Writer << Magic << Version << Features;
+	SerializeValues(Writer, Values);
+
+	return FFileHelper::SaveArrayToFile(Bytes, *FilePath);
+}
+
+bool FBltCorpusEntry::Load(const FString& FilePath)
+{
+	TArray<uint8> Bytes;
+	if (!FFileHelper::LoadFileToArray(Bytes, *FilePath))
+		return false;
+
+	FMemoryReader Reader(Bytes);
+	uint32 Magic = 0u;
+	uint32 Version = 0u;
+	Reader << Magic << Version;
+	if (Magic != CorpusMagic || Version != CorpusVersion)
+	{
+		UE_LOG(LogBlt, Warning, TEXT("%s is not a corpus entry of this version"), *FilePath);
+		return false;
+	}
+
+	Reader << Features;
+	SerializeValues(Reader, Values);
+	if (Reader.IsError())
+	{
+		UE_LOG(LogBlt, Warning, TEXT("%s is truncated"), *FilePath);
+		return false;
+	}
+
+	ComputeHash();
+	return true;
+}
+
+
+void FBltValueCapture::OnMutation(const FBltMutationRecord& Record, const FString* const NewString)
+{
+	FBltFuzzValue Value;
+	Value.Type = Record.Type;
+	if (NewString)
+	{
+		Value.String = *NewString;
+	}
+	else
+	{
+		Value.Bits = Record.NewValue;
+	}
+
+	FScopeLock ScopeLock(&Lock);
+	Entry.Values.Add(FBltCorpusEntry::MakeKey(Record.ActorId, Record.PropertyId), MoveTemp(Value));
+}
+
+FBltCorpusEntry FBltValueCapture::Take()
+{
+	FScopeLock ScopeLock(&Lock);
+	return MoveTemp(Entry);
+}
+
+
+FBltFuzzGuide::FBltFuzzGuide(const FBltCorpusEntry& InEntry, const double InProbability, const bool bInExclusive)
+	: Entry(InEntry)
+	, Probability(InProbability)
+	, bExclusive(bInExclusive)
+{
+	if (bExclusive)
+		return;
+
+	for (const TPair<uint64, FBltFuzzValue>& Pair : Entry.Values)
+	{
+		ValuesById.FindOrAdd(static_cast<uint32>(Pair.Key), &Pair.Value);
+	}
+}
+
+const FBltFuzzValue* FBltFuzzGuide::Pick(const uint32 ActorId, const uint32 ValueId, const FBltFuzzPropertyPlan& PropertyPlan, FBltRandomStream& Stream) const
+{
+	const FBltFuzzValue* Value = Entry.Values.Find(FBltCorpusEntry::MakeKey(ActorId, ValueId));
+	if (!bExclusive)
+	{
+		if (Stream.GetFraction() >= Probability)
+			return nullptr;
+
+		if (!Value)
+		{
+			const FBltFuzzValue* const* const Borrowed = ValuesById.Find(ValueId);
+			Value = Borrowed ? *Borrowed : nullptr;
+		}
+	}
+
+	// The spec may have changed the property type since the entry was written
+	return Value && Value->Type == PropertyPlan.Type ? Value : nullptr;
+}
+
+
+bool FBltCorpus::Open(const FString& InDirectory)
+{
+	Directory = InDirectory;
+	Entries.Reset();
+	Hashes.Reset();
+	SeenFeatures.Reset();
+
+	TArray<FString> FileNames;
+	IFileManager::Get().FindFiles(FileNames, *(Directory / (FString(TEXT("*")) + CorpusExtension)), true, false);
+	for (const FString& FileName : FileNames)
+	{
+		TUniquePtr<FBltCorpusEntry> Entry = MakeUnique<FBltCorpusEntry>();
+		if (!Entry->Load(Directory / FileName))
+			continue;
+
+		bool bAlreadyLoaded = false;
+		Hashes.Add(Entry->Hash, &bAlreadyLoaded);
+		if (bAlreadyLoaded)
+			continue;
+
+		for (const uint32 Feature : Entry->Features)
+		{
+			bool bSeen = false;
+			SeenFeatures.Add(Feature, &bSeen);
+			Entry->NewFeatures += bSeen ? 0 : 1;
+		}
+
+		Entries.Add(MoveTemp(Entry));
+	}
+
+	UE_LOG(LogBlt, Display, TEXT("Corpus %s: %d entries, %d features"), *Directory, Entries.Num(), SeenFeatures.Num());
+	return true;
+}
+
+bool FBltCorpus::Add(FBltCorpusEntry&& Entry)
+{
+	int32 NewFeatures = 0;
+	for (const uint32 Feature : Entry.Features)
+	{
+		bool bSeen = false;
+		SeenFeatures.Add(Feature, &bSeen);
+		NewFeatures += bSeen ? 0 : 1;
+	}
+
+	if (NewFeatures == 0 || Entry.Values.Num() == 0)
+		return false;
+
+	Entry.ComputeHash();
+	bool bDuplicate = false;
+	Hashes.Add(Entry.Hash, &bDuplicate);
+	if (bDuplicate)
+		return false;
+
+	Entry.NewFeatures = NewFeatures;
+	Entry.Save(Directory / FString::Printf(TEXT("%016llx"), Entry.Hash) + CorpusExtension);
+	Entries.Add(MakeUnique<FBltCorpusEntry>(MoveTemp(Entry)));
+	return true;
+}
+
+const FBltCorpusEntry* FBltCorpus::Choose(FBltRandomStream& Stream)
+{
+	if (Entries.Num() == 0)
+		return nullptr;
+
+	double TotalWeight = 0.0;
+	for (const TUniquePtr<FBltCorpusEntry>& Entry : Entries)
+	{
+		TotalWeight += (1.0 + Entry->NewFeatures) / (1.0 + Entry->Picks);
+	}
+
+	double Target = Stream.GetFraction() * TotalWeight;
+	for (const TUniquePtr<FBltCorpusEntry>& Entry : Entries)
+	{
+		Target -= (1.0 + Entry->NewFeatures) / (1.0 + Entry->Picks);
+		if (Target <= 0.0)
+		{
+			++Entry->Picks;
+			return Entry.Get();
+		}
+	}
+
+	++Entries.Last()->Picks;
+	return Entries.Last().Get();
+}
@@ -0,0 +1,91 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "BltFuzzPlan.h"
+#include "BltMutationJournal.h"
+
+class FBltRandomStream;
+
+
+// Values written by one fuzz pass, keyed by actor and value id, with the state features it reached
+struct FBltCorpusEntry
+{
+	static uint64 MakeKey(const uint32 ActorId, const uint32 PropertyId)
+	{
+		return static_cast<uint64>(ActorId) << 32u | PropertyId;
+	}
+
+	TMap<uint64, FBltFuzzValue> Values;
+	TArray<uint32> Features;
+
+	// Of the values only, two passes that wrote the same values are the same entry
+	uint64 Hash = 0u;
+	int32 NewFeatures = 0;
+	int32 Picks = 0;
+
+	void ComputeHash();
+	bool Save(const FString& FilePath);
+	bool Load(const FString& FilePath);
+};
+
+
+// Collects the values of every mutation recorded while it is the listener of a journal
+class FBltValueCapture final : public IBltMutationListener
+{
+public:
+	virtual void OnMutation(const FBltMutationRecord& Record, const FString* const NewString) override;
+
+	// Hands the values over and starts empty again
+	FBltCorpusEntry Take();
+
+private:
+	FCriticalSection Lock;
+	FBltCorpusEntry Entry;
+};
+
+
+// Values a pass writes instead of sampling. A guided pass replays each value of the entry with the
+// given probability and borrows values of other actors for the same property, so corpus entries
+// cross over; an exclusive guide writes exactly the values of the entry and nothing else.
+class FBltFuzzGuide
+{
+public:
+	FBltFuzzGuide(const FBltCorpusEntry& InEntry, const double InProbability, const bool bInExclusive = false);
+
+	// Null when the property should be sampled as usual, or left alone by an exclusive guide
+	const FBltFuzzValue* Pick(const uint32 ActorId, const uint32 ValueId, const FBltFuzzPropertyPlan& PropertyPlan, FBltRandomStream& Stream) const;
+
+	bool IsExclusive() const { return bExclusive; }
+
+private:
+	const FBltCorpusEntry& Entry;
+	TMap<uint32, const FBltFuzzValue*> ValuesById;
+	double Probability = 0.0;
+	bool bExclusive = false;
+};
+
+
+// On-disk corpus of the guided mode, one file per entry named after its hash. An entry is only
+// kept when it reaches a state feature no earlier entry reached; entries bringing more new
+// features and picked less often are chosen more often as the guide of the next pass.
+class FBltCorpus
+{
+public:
+	// Loads every entry already in Directory, which may be shared by several campaigns
+	bool Open(const FString& InDirectory);
+
+	// Returns whether Entry reached a new feature and was kept
+	bool Add(FBltCorpusEntry&& Entry);
+
+	const FBltCorpusEntry* Choose(FBltRandomStream& Stream);
+
+	int32 Num() const { return Entries.Num(); }
+	int32 NumFeatures() const { return SeenFeatures.Num(); }
+
+private:
+	FString Directory;
+	TArray<TUniquePtr<FBltCorpusEntry>> Entries;
+	TSet<uint64> Hashes;
+	TSet<uint32> SeenFeatures;
+};
@@ -0,0 +1,63 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "BltFuzzAsyncAction.h"
+
+#include "BltBPLibrary.h"
+#include "BltFuzzTask.h"
+
+
+UBltFuzzAsyncAction* UBltFuzzAsyncAction::ApplyFuzzPlanAsync(
+	const UObject* const WorldContextObject,
+	const FBltFuzzPlanHandle& Plan,
+	const TArray<AActor*>& AffectedActors,
+	const bool bUseArray,
+	const int64 Seed,
+	const int32 Iteration,
+	const float BudgetMilliseconds
+)
+{
+	UBltFuzzAsyncAction* const Action = NewObject<UBltFuzzAsyncAction>();
+	Action->BudgetMilliseconds = BudgetMilliseconds;
+	Action->RegisterWithGameInstance(WorldContextObject);
+
+	const FBltFuzzPlanPtr FuzzPlan = FBltFuzzPlanRegistry::Get().Find(Plan);
+	if (!FuzzPlan)
+	{
+		UE_LOG(LogBlt, Error, TEXT("Fuzz plan %d is not loaded!"), Plan.Id);
+		return Action;
+	}
+
+	FBltFuzzPass Pass;
+	Pass.Seed = Seed;
+	Pass.Iteration = Iteration >= 0 ? Iteration : FBltFuzzPlanRegistry::Get().AdvanceIteration(Plan);
+	UE_LOG(LogBlt, Log, TEXT("Fuzzing %s with seed %lld, iteration %d over several frames"), *FuzzPlan->GetSourcePath(), Pass.Seed, Pass.Iteration);
+
+	Action->Task = MakeShared<FBltFuzzTask>(WorldContextObject, FuzzPlan, Pass, AffectedActors, bUseArray);
+	return Action;
+}
+
+void UBltFuzzAsyncAction::Activate()
+{
+	if (!Task)
+	{
+		OnCompleted.Broadcast(0, 0);
+		SetReadyToDestroy();
+		return;
+	}
+
+	Task->OnProgress.BindUObject(this, &UBltFuzzAsyncAction::HandleProgress);
+	Task->OnCompleted.BindUObject(this, &UBltFuzzAsyncAction::HandleCompleted);
+	Task->Start(BudgetMilliseconds);
+}
+
+void UBltFuzzAsyncAction::HandleProgress(const int32 ProcessedActors, const int32 TotalActors)
+{
+	OnProgress.Broadcast(ProcessedActors, TotalActors);
+}
+
+void UBltFuzzAsyncAction::HandleCompleted(const int32 ProcessedActors, const int32 TotalActors)
+{
+	OnCompleted.Broadcast(ProcessedActors, TotalActors);
+	Task.Reset();
+	SetReadyToDestroy();
+}
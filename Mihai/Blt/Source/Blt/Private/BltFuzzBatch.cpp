@@ -0,0 +1,369 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "BltFuzzBatch.h"
+
+#include "Async/ParallelFor.h"
+#include "BltBPLibrary.h"
+#include "BltCorpus.h"
+#include "BltMutationJournal.h"
+#include "BltNamePool.h"
+#include "BltNumericMutators.h"
+#include "BltRandom.h"
+#include "BltRegexGenerator.h"
+#include "BltRestoreJournal.h"
+#include "BltStats.h"
+#include "PythonBridge.h"
+
+
+namespace
+{
+	bool IsStringType(const EBltFuzzValueType Type)
+	{
+		return Type == EBltFuzzValueType::String || Type == EBltFuzzValueType::Name || Type == EBltFuzzValueType::Text;
+	}
+
+	// Mutated in one go by UBltBPLibrary::RandomiseProperty during the serial commit
+	bool IsSerial(const FBltFuzzPropertyPlan& PropertyPlan)
+	{
+		return PropertyPlan.Path.Num() > 0 || (IsStringType(PropertyPlan.Type) && PropertyPlan.Strategy == EBltFuzzStrategy::Mutate);
+	}
+}
+
+
+FBltFuzzBatch::FBltFuzzBatch(const FBltFuzzPass& InPass)
+	: Pass(InPass)
+{
+}
+
+void FBltFuzzBatch::Add(AActor* const Actor, const FBltFuzzClassPlan& ClassPlan)
+{
+	FJob& Job = Jobs.AddDefaulted_GetRef();
+	Job.Actor = Actor;
+	Job.ClassPlan = &ClassPlan;
+	Job.ActorId = FBltRandomStream::HashObject(Actor);
+	Job.FirstValue = Values.Num();
+
+	Values.AddDefaulted(ClassPlan.Properties.Num());
+
+	int32& GroupIndex = GroupIndices.FindOrAdd(&ClassPlan, INDEX_NONE);
+	if (GroupIndex == INDEX_NONE)
+	{
+		GroupIndex = Groups.Num();
+		FGroup& NewGroup = Groups.AddDefaulted_GetRef();
+		NewGroup.ClassPlan = &ClassPlan;
+		for (int32 PropertyIndex = 0; PropertyIndex < ClassPlan.Properties.Num(); ++PropertyIndex)
+		{
+			if (IsColumnar(ClassPlan.Properties[PropertyIndex]))
+			{
+				NewGroup.Columns.Add(PropertyIndex);
+			}
+		}
+	}
+
+	FGroup& Group = Groups[GroupIndex];
+	if (Group.Columns.Num() > 0)
+	{
+		Group.Actors.Add(Actor);
+		Group.ActorIds.Add(Job.ActorId);
+	}
+}
+
+template <typename FunctorType>
+void FBltFuzzBatch::ForEachIndex(const int32 Count, const int32 MaxConcurrency, const FunctorType& Functor)
+{
+	if (MaxConcurrency <= 0)
+	{
+		ParallelFor(Count, Functor);
+		return;
+	}
+
+	const int32 TaskCount = FMath::Min(MaxConcurrency, Count);
+	ParallelFor(TaskCount, [Count, &Functor, TaskCount](const int32 TaskIndex)
+	{
+		const int32 Begin = static_cast<int64>(Count) * TaskIndex / TaskCount;
+		const int32 End = static_cast<int64>(Count) * (TaskIndex + 1) / TaskCount;
+		for (int32 Index = Begin; Index < End; ++Index)
+		{
+			Functor(Index);
+		}
+	}, TaskCount == 1);
+}
+
+template <typename FunctorType>
+void FBltFuzzBatch::ForEachJob(const int32 MaxConcurrency, const FunctorType& Functor)
+{
+	ForEachIndex(Jobs.Num(), MaxConcurrency, [this, &Functor](const int32 JobIndex)
+	{
+		Functor(Jobs[JobIndex]);
+	});
+}
+
+bool FBltFuzzBatch::IsColumnar(const FBltFuzzPropertyPlan& PropertyPlan) const
+{
+	// A guide draws from the stream before sampling, distributions may draw twice and perturbations read the
+	// current value, so all of them keep the per-actor path
+	return !Pass.Guide && !PropertyPlan.Distribution && PropertyPlan.Strategy != EBltFuzzStrategy::Mutate && PropertyPlan.Path.Num() == 0
+		&& PropertyPlan.Type != EBltFuzzValueType::None && !IsStringType(PropertyPlan.Type);
+}
+
+void FBltFuzzBatch::Compute(const int32 MaxConcurrency)
+{
+	BLT_SCOPE_CYCLE_COUNTER(STAT_BltBatchCompute);
+
+	Blocks.Reset();
+	for (int32 GroupIndex = 0; GroupIndex < Groups.Num(); ++GroupIndex)
+	{
+		FGroup& Group = Groups[GroupIndex];
+		Group.Bits.SetNumUninitialized(Group.Columns.Num() * Group.Actors.Num());
+		for (int32 Begin = 0; Begin < Group.Actors.Num(); Begin += BlockSize)
+		{
+			Blocks.Add({ GroupIndex, Begin, FMath::Min(Begin + BlockSize, Group.Actors.Num()) });
+		}
+	}
+
+	ForEachIndex(Blocks.Num(), MaxConcurrency, [this](const int32 BlockIndex)
+	{
+		ComputeBlock(Blocks[BlockIndex]);
+	});
+
+	ForEachJob(MaxConcurrency, [this](const FJob& Job)
+	{
+		ComputeJob(Job);
+	});
+}
+
+void FBltFuzzBatch::Commit(const int32 MaxConcurrency)
+{
+	check(IsInGameThread());
+	BLT_SCOPE_CYCLE_COUNTER(STAT_BltBatchCommit);
+
+	// Originals are captured up front so the restore journal is only ever touched by the game thread
+	FBltRestoreJournal& RestoreJournal = FBltRestoreJournal::Get();
+	for (const FJob& Job : Jobs)
+	{
+		const TArray<FBltFuzzPropertyPlan>& Properties = Job.ClassPlan->Properties;
+		for (int32 PropertyIndex = 0; PropertyIndex < Properties.Num(); ++PropertyIndex)
+		{
+			const FBltFuzzPropertyPlan& PropertyPlan = Properties[PropertyIndex];
+			const FValue& Value = Values[Job.FirstValue + PropertyIndex];
+			if (Value.bReady || IsColumnar(PropertyPlan) || (!IsSerial(PropertyPlan) && IsStringType(PropertyPlan.Type) && !Value.bSkip))
+			{
+				RestoreJournal.Capture(Job.Actor, PropertyPlan.RootProperty);
+			}
+		}
+	}
+
+	ForEachIndex(Blocks.Num(), MaxConcurrency, [this](const int32 BlockIndex)
+	{
+		CommitBlock(Blocks[BlockIndex]);
+	});
+
+	ForEachJob(MaxConcurrency, [this](const FJob& Job)
+	{
+		CommitNumericJob(Job);
+	});
+
+	for (const FJob& Job : Jobs)
+	{
+		CommitSerialJob(Job);
+	}
+}
+
+void FBltFuzzBatch::ComputeJob(const FJob& Job)
+{
+	int32 StringCount = 0;
+	const TArray<FBltFuzzPropertyPlan>& Properties = Job.ClassPlan->Properties;
+	for (int32 PropertyIndex = 0; PropertyIndex < Properties.Num(); ++PropertyIndex)
+	{
+		const FBltFuzzPropertyPlan& PropertyPlan = Properties[PropertyIndex];
+		if (IsSerial(PropertyPlan) || IsColumnar(PropertyPlan))
+			continue;
+
+		FValue& Value = Values[Job.FirstValue + PropertyIndex];
+
+		FBltRandomStream Stream(Pass.Seed, Pass.Iteration, Job.ActorId, PropertyPlan.PropertyId);
+		if (Pass.Guide)
+		{
+			if (const FBltFuzzValue* const GuidedValue = Pass.Guide->Pick(Job.ActorId, PropertyPlan.PropertyId, PropertyPlan, Stream))
+			{
+				Value.Bits = GuidedValue->Bits;
+				Value.String = GuidedValue->String;
+				Value.bReady = true;
+				continue;
+			}
+
+			if (Pass.Guide->IsExclusive())
+			{
+				Value.bSkip = true;
+				continue;
+			}
+		}
+
+		if (!IsStringType(PropertyPlan.Type) && PropertyPlan.Strategy == EBltFuzzStrategy::Mutate)
+		{
+			uint64 OldBits = 0u;
+			FBltNumericMutators::Read(PropertyPlan, reinterpret_cast<const uint8*>(Job.Actor) + PropertyPlan.Offset, OldBits);
+			Value.bReady = FBltNumericMutators::Perturb(PropertyPlan, Stream, OldBits, Value.Bits);
+		}
+		else if (!IsStringType(PropertyPlan.Type))
+		{
+			Value.bReady = FBltNumericMutators::Sample(PropertyPlan, Stream, Value.Bits);
+		}
+		else if (PropertyPlan.NamePool && PropertyPlan.NamePool->IsPregenerated())
+		{
+			Value.Bits = static_cast<uint64>(PropertyPlan.NamePool->Pick(Stream));
+			Value.bPooled = true;
+			Value.bReady = true;
+			++StringCount;
+		}
+		else if (PropertyPlan.Generator)
+		{
+			PropertyPlan.Generator->Generate(Stream, Value.String);
+			Value.bReady = true;
+			++StringCount;
+		}
+	}
+
+	INC_DWORD_STAT_BY(STAT_BltStringsGenerated, StringCount);
+}
+
+void FBltFuzzBatch::ComputeBlock(const FBlock& Block)
+{
+	FGroup& Group = Groups[Block.Group];
+	const int32 Count = Block.End - Block.Begin;
+	const uint64 PassKey = FBltRandomStream::MakePassKey(Pass.Seed, Pass.Iteration);
+
+	uint64 Random[BlockSize];
+	for (int32 ColumnIndex = 0; ColumnIndex < Group.Columns.Num(); ++ColumnIndex)
+	{
+		const FBltFuzzPropertyPlan& PropertyPlan = Group.ClassPlan->Properties[Group.Columns[ColumnIndex]];
+		FBltRandomStream::DrawFirst(PassKey, PropertyPlan.PropertyId, Group.ActorIds.GetData() + Block.Begin, Random, Count);
+		FBltNumericMutators::SampleColumn(PropertyPlan, Random, Group.Bits.GetData() + ColumnIndex * Group.Actors.Num() + Block.Begin, Count);
+	}
+}
+
+void FBltFuzzBatch::CommitBlock(const FBlock& Block)
+{
+	const FGroup& Group = Groups[Block.Group];
+	const int32 Count = Block.End - Block.Begin;
+
+	// Actors are added once, so every column of an actor is written by the same task and bitfields sharing a byte never race
+	FBltMutationJournal& Journal = FBltMutationJournal::Get();
+	uint64 OldBits[BlockSize];
+	int64 Bytes = 0;
+	for (int32 ColumnIndex = 0; ColumnIndex < Group.Columns.Num(); ++ColumnIndex)
+	{
+		const FBltFuzzPropertyPlan& PropertyPlan = Group.ClassPlan->Properties[Group.Columns[ColumnIndex]];
+		const uint64* const Bits = Group.Bits.GetData() + ColumnIndex * Group.Actors.Num() + Block.Begin;
+		FBltNumericMutators::ScatterColumn(PropertyPlan, Group.Actors.GetData() + Block.Begin, Bits, OldBits, Count);
+
+		for (int32 Index = 0; Index < Count; ++Index)
+		{
+			Journal.Record(Group.ActorIds[Block.Begin + Index], PropertyPlan.PropertyId, PropertyPlan.Type, OldBits[Index], Bits[Index]);
+		}
+		Bytes += static_cast<int64>(PropertyPlan.Property->ElementSize) * Count;
+	}
+
+	BLT_COUNT_MUTATIONS(Count * Group.Columns.Num(), Bytes);
+}
+
+void FBltFuzzBatch::CommitNumericJob(const FJob& Job)
+{
+	FBltMutationJournal& Journal = FBltMutationJournal::Get();
+	int32 Mutations = 0;
+	int64 Bytes = 0;
+	const TArray<FBltFuzzPropertyPlan>& Properties = Job.ClassPlan->Properties;
+	for (int32 PropertyIndex = 0; PropertyIndex < Properties.Num(); ++PropertyIndex)
+	{
+		const FBltFuzzPropertyPlan& PropertyPlan = Properties[PropertyIndex];
+		const FValue& Value = Values[Job.FirstValue + PropertyIndex];
+		if (Value.bReady && !IsStringType(PropertyPlan.Type))
+		{
+			void* const ValuePtr = reinterpret_cast<uint8*>(Job.Actor) + PropertyPlan.Offset;
+
+			uint64 OldBits = 0u;
+			FBltNumericMutators::Read(PropertyPlan, ValuePtr, OldBits);
+			FBltNumericMutators::Write(PropertyPlan, ValuePtr, Value.Bits);
+			Journal.Record(Job.ActorId, PropertyPlan.PropertyId, PropertyPlan.Type, OldBits, Value.Bits);
+
+			++Mutations;
+			Bytes += PropertyPlan.Property->ElementSize;
+		}
+	}
+
+	BLT_COUNT_MUTATIONS(Mutations, Bytes);
+}
+
+void FBltFuzzBatch::CommitSerialJob(const FJob& Job)
+{
+	BLT_SCOPE_MUTATION_BATCH();
+
+	const TArray<FBltFuzzPropertyPlan>& Properties = Job.ClassPlan->Properties;
+	for (int32 PropertyIndex = 0; PropertyIndex < Properties.Num(); ++PropertyIndex)
+	{
+		const FBltFuzzPropertyPlan& PropertyPlan = Properties[PropertyIndex];
+
+		// Container sizes are only known once walked, and sets rehash, so these are mutated in one go here;
+		// so are edited strings, whose current value has to be read on the game thread
+		if (IsSerial(PropertyPlan))
+		{
+			UBltBPLibrary::RandomiseProperty(Job.Actor, PropertyPlan, Pass, Job.ActorId);
+			continue;
+		}
+
+		if (!IsStringType(PropertyPlan.Type))
+			continue;
+
+		FValue& Value = Values[Job.FirstValue + PropertyIndex];
+		if (Value.bSkip)
+			continue;
+
+		if (!Value.bReady)
+		{
+			// The Python bridge dispatches into a UObject, so it can only run here
+			const UPythonBridge* const PythonBridge = UPythonBridge::Get();
+			if (!PythonBridge)
+			{
+				UE_LOG(LogBlt, Error, TEXT("Python bridge could not be instantiated!"));
+				continue;
+			}
+
+			BLT_SCOPE_CYCLE_COUNTER(STAT_BltPythonBridge);
+			INC_DWORD_STAT(STAT_BltStringsGenerated);
+			Value.String = PythonBridge->GenerateStringFromRegex(PropertyPlan.Regex);
+		}
+
+		BLT_COUNT_MUTATION(Value.bPooled ? sizeof(FName) : Value.String.Len() * sizeof(TCHAR));
+
+		FBltMutationJournal& Journal = FBltMutationJournal::Get();
+		void* const ValuePtr = reinterpret_cast<uint8*>(Job.Actor) + PropertyPlan.Offset;
+		switch (PropertyPlan.Type)
+		{
+		case EBltFuzzValueType::String:
+			Journal.RecordString(Job.ActorId, PropertyPlan.PropertyId, PropertyPlan.Type, *static_cast<FString*>(ValuePtr), Value.String);
+			*static_cast<FString*>(ValuePtr) = MoveTemp(Value.String);
+			break;
+
+		case EBltFuzzValueType::Name:
+		{
+			if (Value.bPooled)
+			{
+				BLT_COUNT_NAME_LOOKUP(true);
+			}
+
+			const FName Name = Value.bPooled ? PropertyPlan.NamePool->GetName(static_cast<int32>(Value.Bits)) : PropertyPlan.NamePool->Intern(Value.String);
+			Journal.RecordString(Job.ActorId, PropertyPlan.PropertyId, PropertyPlan.Type, static_cast<FName*>(ValuePtr)->ToString(), Name.ToString());
+			*static_cast<FName*>(ValuePtr) = Name;
+			break;
+		}
+
+		case EBltFuzzValueType::Text:
+			Journal.RecordString(Job.ActorId, PropertyPlan.PropertyId, PropertyPlan.Type, static_cast<FText*>(ValuePtr)->ToString(), Value.String);
+			*static_cast<FText*>(ValuePtr) = FText::FromString(MoveTemp(Value.String));
+			break;
+
+		default:
+			break;
+		}
+	}
+}
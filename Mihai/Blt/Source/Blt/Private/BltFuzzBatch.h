@@ -0,0 +1,94 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "BltFuzzPlan.h"
+
+
+// Two phase fuzz pass: values are sampled and encoded per actor on worker threads, then a short
+// commit phase writes them. Numeric, bool and enum values only touch the bytes of their own actor,
+// so they are committed in parallel too; strings, the Python fallback and values behind containers
+// or subobject pointers stay on the game thread.
+//
+// Unguided numeric values of the actor itself are laid out as columns instead: per class plan and
+// property, one contiguous array over all actors, drawn and sampled by the column kernels and then
+// scattered at the property's precomputed offset. Values are bit identical to the per-actor path.
+class FBltFuzzBatch
+{
+public:
+	explicit FBltFuzzBatch(const FBltFuzzPass& InPass);
+
+	// Every actor goes in once, with FBltFuzzPlan::FindOrResolveActorPlan when it matches several entries
+	void Add(AActor* const Actor, const FBltFuzzClassPlan& ClassPlan);
+	int32 Num() const { return Jobs.Num(); }
+
+	// MaxConcurrency caps how many tasks the actors are split into, 0 leaves it to ParallelFor
+	void Compute(const int32 MaxConcurrency = 0);
+	void Commit(const int32 MaxConcurrency = 0);
+
+private:
+	struct FJob
+	{
+		AActor* Actor = nullptr;
+		const FBltFuzzClassPlan* ClassPlan = nullptr;
+		uint32 ActorId = 0u;
+		int32 FirstValue = 0;
+	};
+
+	// Actors sharing a class plan, with one column of values per columnar property
+	struct FGroup
+	{
+		const FBltFuzzClassPlan* ClassPlan = nullptr;
+		TArray<UObject*> Actors;
+		TArray<uint32> ActorIds;
+		TArray<int32> Columns;
+
+		// Column major, Bits[Column * Actors.Num() + ActorIndex]
+		TArray<uint64> Bits;
+	};
+
+	// Range of the actors of one group, the unit of work of the column kernels
+	struct FBlock
+	{
+		int32 Group = 0;
+		int32 Begin = 0;
+		int32 End = 0;
+	};
+
+	static constexpr int32 BlockSize = 1024;
+
+	struct FValue
+	{
+		uint64 Bits = 0u;
+		FString String;
+		bool bReady = false;
+
+		// Bits is an index into the name pool of the property instead of a value
+		bool bPooled = false;
+
+		// Left alone by an exclusive guide
+		bool bSkip = false;
+	};
+
+	template <typename FunctorType>
+	static void ForEachIndex(const int32 Count, const int32 MaxConcurrency, const FunctorType& Functor);
+
+	template <typename FunctorType>
+	void ForEachJob(const int32 MaxConcurrency, const FunctorType& Functor);
+
+	bool IsColumnar(const FBltFuzzPropertyPlan& PropertyPlan) const;
+
+	void ComputeJob(const FJob& Job);
+	void ComputeBlock(const FBlock& Block);
+	void CommitNumericJob(const FJob& Job);
+	void CommitBlock(const FBlock& Block);
+	void CommitSerialJob(const FJob& Job);
+
+	FBltFuzzPass Pass;
+	TArray<FJob> Jobs;
+	TArray<FValue> Values;
+
+	TArray<FGroup> Groups;
+	TMap<const FBltFuzzClassPlan*, int32> GroupIndices;
+	TArray<FBlock> Blocks;
+};
@@ -0,0 +1,340 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "BltFuzzCampaign.h"
+
+#include "BltBPLibrary.h"
+#include "BltFuzzFailures.h"
+#include "BltFuzzWorld.h"
+#include "BltMutationJournal.h"
+#include "BltRandom.h"
+#include "BltWorldCheckpoint.h"
+#include "Policies/PrettyJsonPrintPolicy.h"
+#include "Serialization/JsonWriter.h"
+
+
+namespace
+{
+	constexpr double ProgressInterval = 10.0;
+	const TCHAR* const ProgressFileName = TEXT("Progress.txt");
+}
+
+
+bool FBltFuzzCampaignSettings::Parse(const TCHAR* const CommandLine, const bool bNeedsLimit)
+{
+	if (!FParse::Value(CommandLine, TEXT("Map="), MapName) || !FParse::Value(CommandLine, TEXT("Spec="), SpecPath))
+	{
+		UE_LOG(LogBlt, Error, TEXT("A campaign needs -Map= and -Spec="));
+		return false;
+	}
+
+	FParse::Value(CommandLine, TEXT("Seed="), Seed);
+	FParse::Value(CommandLine, TEXT("FirstIteration="), FirstIteration);
+	FParse::Value(CommandLine, TEXT("Iterations="), Iterations);
+	FParse::Value(CommandLine, TEXT("Duration="), DurationSeconds);
+	FParse::Value(CommandLine, TEXT("TicksPerIteration="), StepsPerIteration);
+	bParallel = FParse::Param(CommandLine, TEXT("Parallel"));
+	bResetWorld = !FParse::Param(CommandLine, TEXT("NoReset"));
+	bGuided = FParse::Param(CommandLine, TEXT("Guided"));
+	FParse::Value(CommandLine, TEXT("GuideRate="), GuideRate);
+	FParse::Value(CommandLine, TEXT("Replay="), ReplayPath);
+
+	float TickRate = 0.0f;
+	if (FParse::Value(CommandLine, TEXT("TickRate="), TickRate) && TickRate > 0.0f)
+	{
+		StepSeconds = 1.0f / TickRate;
+	}
+
+	if (!FParse::Value(CommandLine, TEXT("Output="), OutputDirectory))
+	{
+		OutputDirectory = FPaths::ProjectSavedDir() / TEXT("Blt") / TEXT("Campaigns") / FDateTime::Now().ToString();
+	}
+	OutputDirectory = FPaths::ConvertRelativePathToFull(OutputDirectory);
+
+	if (!FParse::Value(CommandLine, TEXT("Corpus="), CorpusDirectory))
+	{
+		CorpusDirectory = OutputDirectory / TEXT("Corpus");
+	}
+	CorpusDirectory = FPaths::ConvertRelativePathToFull(CorpusDirectory);
+	GuideRate = FMath::Clamp(GuideRate, 0.0, 1.0);
+
+	if (!ReplayPath.IsEmpty())
+	{
+		ReplayPath = FPaths::ConvertRelativePathToFull(ReplayPath);
+	}
+
+	if (bNeedsLimit && Iterations <= 0 && DurationSeconds <= 0.0)
+	{
+		UE_LOG(LogBlt, Error, TEXT("A campaign needs -Iterations= or -Duration="));
+		return false;
+	}
+
+	StepsPerIteration = FMath::Max(StepsPerIteration, 1);
+	return true;
+}
+
+FString FBltFuzzCampaignSettings::ToCommandLine() const
+{
+	FString CommandLine = FString::Printf(
+		TEXT("-run=BltFuzz -Map=\"%s\" -Spec=\"%s\" -Output=\"%s\" -Seed=%lld -FirstIteration=%d -Iterations=%d -Duration=%f -TickRate=%f -TicksPerIteration=%d"),
+		*MapName,
+		*SpecPath,
+		*OutputDirectory,
+		Seed,
+		FirstIteration,
+		Iterations,
+		DurationSeconds,
+		1.0f / StepSeconds,
+		StepsPerIteration
+	);
+
+	if (bParallel)
+	{
+		CommandLine += TEXT(" -Parallel");
+	}
+
+	if (!bResetWorld)
+	{
+		CommandLine += TEXT(" -NoReset");
+	}
+
+	// The corpus directory is passed explicitly so workers of one campaign share it
+	if (bGuided)
+	{
+		CommandLine += FString::Printf(TEXT(" -Guided -Corpus=\"%s\" -GuideRate=%f"), *CorpusDirectory, GuideRate);
+	}
+
+	if (!ReplayPath.IsEmpty())
+	{
+		CommandLine += FString::Printf(TEXT(" -Replay=\"%s\""), *ReplayPath);
+	}
+
+	return CommandLine;
+}
+
+FProcHandle FBltFuzzCampaignSettings::Launch(const FString& LogPath) const
+{
+	const FString ProjectPath = FPaths::ConvertRelativePathToFull(FPaths::GetProjectFilePath());
+	const FString Arguments = FString::Printf(
+		TEXT("\"%s\" %s -abslog=\"%s\" -nullrhi -unattended -nosplash -nosound -nopause"),
+		*ProjectPath,
+		*ToCommandLine(),
+		*LogPath
+	);
+
+	return FPlatformProcess::CreateProc(FPlatformProcess::ExecutablePath(), *Arguments, false, true, true, nullptr, 0, nullptr, nullptr);
+}
+
+
+FBltFuzzCampaign::FBltFuzzCampaign(const FBltFuzzCampaignSettings& InSettings, FBltFuzzWorld& InWorld)
+	: Settings(InSettings)
+	, World(InWorld)
+{
+}
+
+bool FBltFuzzCampaign::Begin()
+{
+	Plan = UBltBPLibrary::LoadFuzzPlan(Settings.SpecPath);
+	const FBltFuzzPlanPtr FuzzPlan = FBltFuzzPlanRegistry::Get().Find(Plan);
+	if (!FuzzPlan)
+		return false;
+
+	if (Settings.bResetWorld)
+	{
+		FBltWorldCheckpoint::Get(World.Get()).Capture(*FuzzPlan);
+	}
+
+	if (!Settings.ReplayPath.IsEmpty() && !ReplayEntry.Load(Settings.ReplayPath))
+	{
+		UE_LOG(LogBlt, Error, TEXT("Could not load %s to replay!"), *Settings.ReplayPath);
+		return false;
+	}
+
+	if (Settings.bGuided)
+	{
+		Corpus.Open(Settings.CorpusDirectory);
+		Feedback.Begin(World.Get());
+	}
+
+	Journal.Start(Settings.OutputDirectory);
+
+	UE_LOG(LogBlt, Display, TEXT("Fuzzing %s with %s, seed %lld from iteration %d into %s"),
+		*Settings.MapName, *FuzzPlan->GetSourcePath(), Settings.Seed, Settings.FirstIteration, *Settings.OutputDirectory);
+
+	StartTime = FPlatformTime::Seconds();
+	NextProgressTime = StartTime + ProgressInterval;
+	return true;
+}
+
+void FBltFuzzCampaign::Step()
+{
+	const FBltMutationJournal::FScopedActive ActiveJournal(Journal);
+	if (IterationStep == 0)
+	{
+		BeginIteration();
+	}
+
+	World.Tick(Settings.StepSeconds);
+
+	if (++IterationStep == Settings.StepsPerIteration)
+	{
+		EndIteration();
+		IterationStep = 0;
+		++CompletedIterations;
+	}
+
+	const double Now = FPlatformTime::Seconds();
+	if (Now >= NextProgressTime)
+	{
+		NextProgressTime = Now + ProgressInterval;
+		UE_LOG(LogBlt, Display, TEXT("%s: %d iterations, %.1f per second"), *World.Get()->GetName(), CompletedIterations, CompletedIterations / (Now - StartTime));
+	}
+}
+
+void FBltFuzzCampaign::End()
+{
+	const double Seconds = FPlatformTime::Seconds() - StartTime;
+	UE_LOG(LogBlt, Display, TEXT("Campaign finished: %d iterations in %.1f seconds"), CompletedIterations, Seconds);
+
+	Feedback.End();
+	Journal.Stop();
+	WriteSummary(Seconds);
+}
+
+bool FBltFuzzCampaign::IsDone() const
+{
+	if (IterationStep != 0)
+		return false;
+
+	return (Settings.Iterations > 0 && CompletedIterations >= Settings.Iterations)
+		|| (Settings.DurationSeconds > 0.0 && FPlatformTime::Seconds() - StartTime >= Settings.DurationSeconds);
+}
+
+int32 FBltFuzzCampaign::ReadProgress(const FString& OutputDirectory)
+{
+	FString Progress;
+	if (!FFileHelper::LoadFileToString(Progress, *(OutputDirectory / ProgressFileName)) || !Progress.IsNumeric())
+		return INDEX_NONE;
+
+	return FCString::Atoi(*Progress);
+}
+
+void FBltFuzzCampaign::BeginIteration()
+{
+	if (Settings.bResetWorld && CompletedIterations > 0)
+	{
+		FBltWorldCheckpoint::Get(World.Get()).Reset();
+	}
+
+	const FBltFuzzPlanPtr FuzzPlan = FBltFuzzPlanRegistry::Get().Find(Plan);
+	if (!FuzzPlan)
+		return;
+
+	FBltFuzzPass Pass;
+	Pass.Seed = Settings.Seed;
+	Pass.Iteration = Settings.FirstIteration + CompletedIterations;
+
+	// Written before the pass, so a crash anywhere in the iteration is blamed on it
+	FFileHelper::SaveStringToFile(LexToString(Pass.Iteration), *(Settings.OutputDirectory / ProgressFileName));
+
+	TOptional<FBltFuzzGuide> Guide;
+	if (!Settings.ReplayPath.IsEmpty())
+	{
+		Guide.Emplace(ReplayEntry, 1.0, true);
+	}
+	else if (Settings.bGuided)
+	{
+		// Off the streams of the actors, so choosing an entry never shifts a sampled value
+		FBltRandomStream Stream(Pass.Seed, Pass.Iteration, 0u, 0u);
+		if (const FBltCorpusEntry* const Entry = Corpus.Choose(Stream))
+		{
+			Guide.Emplace(*Entry, Settings.GuideRate);
+		}
+	}
+	Pass.Guide = Guide.GetPtrOrNull();
+
+	if (Settings.bGuided)
+	{
+		Journal.SetListener(&Capture);
+	}
+
+	UBltBPLibrary::ApplyFuzzPass(World.Get(), *FuzzPlan, Pass, TArray<AActor*>(), false, Settings.bParallel);
+	Journal.SetListener(nullptr);
+}
+
+void FBltFuzzCampaign::EndIteration()
+{
+	const int32 Iteration = Settings.FirstIteration + CompletedIterations;
+
+	FBltCorpusEntry Entry = Capture.Take();
+
+	TArray<FString> Reasons;
+	if (FBltFuzzFailures::Consume(World.Get(), Reasons))
+	{
+		UE_LOG(LogBlt, Warning, TEXT("%s: iteration %d failed: %s"), *World.Get()->GetName(), Iteration, *FString::Join(Reasons, TEXT("; ")));
+		FailedIterations.Add(Iteration);
+
+		// Guided values cannot be regenerated from the seed, the minimizer replays them from here
+		if (Settings.bGuided)
+		{
+			Entry.Save(Settings.OutputDirectory / TEXT("Failures") / FString::Printf(TEXT("Iteration_%d.bltcorpus"), Iteration));
+		}
+	}
+
+	if (!Settings.bGuided)
+		return;
+
+	Feedback.Collect(Entry.Features);
+	if (Corpus.Add(MoveTemp(Entry)))
+	{
+		++NewEntries;
+	}
+}
+
+bool FBltFuzzCampaign::WriteSummary(const double Seconds) const
+{
+	const FPlatformMemoryStats MemoryStats = FPlatformMemory::GetStats();
+
+	FString Json;
+	const TSharedRef<TJsonWriter<TCHAR, TPrettyJsonPrintPolicy<TCHAR>>> JsonWriter
+		= TJsonWriterFactory<TCHAR, TPrettyJsonPrintPolicy<TCHAR>>::Create(&Json);
+
+	JsonWriter->WriteObjectStart();
+	JsonWriter->WriteValue(TEXT("map"), Settings.MapName);
+	JsonWriter->WriteValue(TEXT("spec"), Settings.SpecPath);
+	JsonWriter->WriteValue(TEXT("seed"), Settings.Seed);
+	JsonWriter->WriteValue(TEXT("firstIteration"), Settings.FirstIteration);
+	JsonWriter->WriteValue(TEXT("iterations"), CompletedIterations);
+	JsonWriter->WriteValue(TEXT("seconds"), Seconds);
+	JsonWriter->WriteValue(TEXT("iterationsPerSecond"), Seconds > 0.0 ? CompletedIterations / Seconds : 0.0);
+	JsonWriter->WriteValue(TEXT("mutations"), static_cast<int64>(Journal.GetRecordedCount()));
+	JsonWriter->WriteValue(TEXT("droppedMutations"), static_cast<int64>(Journal.GetDroppedCount()));
+
+	JsonWriter->WriteArrayStart(TEXT("failedIterations"));
+	for (const int32 Iteration : FailedIterations)
+	{
+		JsonWriter->WriteValue(Iteration);
+	}
+	JsonWriter->WriteArrayEnd();
+
+	if (Settings.bGuided)
+	{
+		JsonWriter->WriteValue(TEXT("features"), Corpus.NumFeatures());
+		JsonWriter->WriteValue(TEXT("corpusEntries"), Corpus.Num());
+		JsonWriter->WriteValue(TEXT("newEntries"), NewEntries);
+	}
+
+	// Process wide, campaigns sharing a process report the same figures
+	JsonWriter->WriteValue(TEXT("usedMemoryMB"), MemoryStats.UsedPhysical / (1024.0 * 1024.0));
+	JsonWriter->WriteValue(TEXT("peakMemoryMB"), MemoryStats.PeakUsedPhysical / (1024.0 * 1024.0));
+	JsonWriter->WriteObjectEnd();
+	JsonWriter->Close();
+
+	const FString SummaryPath = Settings.OutputDirectory / TEXT("Campaign.json");
+	if (!FFileHelper::SaveStringToFile(Json, *SummaryPath))
+	{
+		UE_LOG(LogBlt, Error, TEXT("Could not write %s!"), *SummaryPath);
+		return false;
+	}
+
+	return true;
+}
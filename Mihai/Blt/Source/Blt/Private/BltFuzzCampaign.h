@@ -0,0 +1,98 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "BltCorpus.h"
+#include "BltFuzzPlan.h"
+#include "BltMutationJournal.h"
+#include "BltStateFeedback.h"
+
+class FBltFuzzWorld;
+
+
+struct FBltFuzzCampaignSettings
+{
+	FString MapName;
+	FString SpecPath;
+	FString OutputDirectory;
+	int64 Seed = 0;
+	int32 FirstIteration = 0;
+
+	// A campaign stops at whichever limit comes first, zero disables a limit
+	int32 Iterations = 0;
+	double DurationSeconds = 0.0;
+
+	float StepSeconds = 1.0f / 30.0f;
+	int32 StepsPerIteration = 60;
+	bool bParallel = false;
+	bool bResetWorld = true;
+
+	// Guided mode: passes replay values of corpus entries that reached new state features
+	bool bGuided = false;
+	FString CorpusDirectory;
+	double GuideRate = 0.8;
+
+	// Corpus entry every iteration writes exactly, and nothing else
+	FString ReplayPath;
+
+	// -Map= -Spec= [-Seed=] [-FirstIteration=] [-Iterations=] [-Duration=] [-TickRate=] [-TicksPerIteration=] [-Output=] [-Parallel] [-NoReset]
+	// [-Guided] [-Corpus=] [-GuideRate=] [-Replay=]
+	bool Parse(const TCHAR* const CommandLine, const bool bNeedsLimit = true);
+
+	// Arguments of a BltFuzz commandlet running these settings
+	FString ToCommandLine() const;
+
+	// Starts a headless BltFuzz process running these settings, logging to LogPath
+	FProcHandle Launch(const FString& LogPath) const;
+};
+
+
+// Fuzz iterations on one headless world. Every iteration starts from the checkpoint taken when the
+// campaign began, applies the plan with its own iteration index and then simulates a fixed number
+// of steps. The caller drives it one step at a time. Mutations go to a journal of the campaign's
+// own in its output directory, so campaigns sharing a process never mix their records. In guided
+// mode every iteration's values are kept in the corpus when they reached a new state feature.
+class FBltFuzzCampaign
+{
+public:
+	FBltFuzzCampaign(const FBltFuzzCampaignSettings& InSettings, FBltFuzzWorld& InWorld);
+
+	bool Begin();
+	void Step();
+	void End();
+
+	bool IsDone() const;
+	int32 GetCompletedIterations() const { return CompletedIterations; }
+	uint64 GetMutations() const { return Journal.GetRecordedCount(); }
+
+	// Iterations for which gameplay code called ReportFuzzFailure
+	const TArray<int32>& GetFailedIterations() const { return FailedIterations; }
+
+	// Campaigns on the same spec share its plan, whoever runs them unloads it once all are done
+	const FBltFuzzPlanHandle& GetPlan() const { return Plan; }
+
+	// Iteration a campaign writing to OutputDirectory last began, INDEX_NONE if it never fuzzed
+	static int32 ReadProgress(const FString& OutputDirectory);
+
+private:
+	void BeginIteration();
+	void EndIteration();
+	bool WriteSummary(const double Seconds) const;
+
+	FBltFuzzCampaignSettings Settings;
+	FBltFuzzWorld& World;
+	FBltFuzzPlanHandle Plan;
+	FBltMutationJournal Journal;
+
+	FBltCorpus Corpus;
+	FBltStateFeedback Feedback;
+	FBltValueCapture Capture;
+	FBltCorpusEntry ReplayEntry;
+	int32 NewEntries = 0;
+	TArray<int32> FailedIterations;
+
+	int32 CompletedIterations = 0;
+	int32 IterationStep = 0;
+	double StartTime = 0.0;
+	double NextProgressTime = 0.0;
+};
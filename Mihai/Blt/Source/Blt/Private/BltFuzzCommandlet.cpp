@@ -0,0 +1,131 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "BltFuzzCommandlet.h"
+
+#include "BltBPLibrary.h"
+#include "BltFuzzCampaign.h"
+#include "BltFuzzWorld.h"
+#include "Policies/PrettyJsonPrintPolicy.h"
+#include "Serialization/JsonWriter.h"
+
+
+namespace
+{
+	// Totals of every world of the process, the in-process counterpart of Coordinator.json
+	bool WriteWorldsSummary(const FString& OutputDirectory, const TArray<TUniquePtr<FBltFuzzCampaign>>& Campaigns, const double Seconds)
+	{
+		int64 Iterations = 0;
+		int64 Mutations = 0;
+		for (const TUniquePtr<FBltFuzzCampaign>& Campaign : Campaigns)
+		{
+			Iterations += Campaign->GetCompletedIterations();
+			Mutations += static_cast<int64>(Campaign->GetMutations());
+		}
+
+		const FPlatformMemoryStats MemoryStats = FPlatformMemory::GetStats();
+
+		FString Json;
+		const TSharedRef<TJsonWriter<TCHAR, TPrettyJsonPrintPolicy<TCHAR>>> JsonWriter
+			= TJsonWriterFactory<TCHAR, TPrettyJsonPrintPolicy<TCHAR>>::Create(&Json);
+
+		JsonWriter->WriteObjectStart();
+		JsonWriter->WriteValue(TEXT("worlds"), Campaigns.Num());
+		JsonWriter->WriteValue(TEXT("iterations"), Iterations);
+		JsonWriter->WriteValue(TEXT("seconds"), Seconds);
+		JsonWriter->WriteValue(TEXT("iterationsPerSecond"), Seconds > 0.0 ? Iterations / Seconds : 0.0);
+		JsonWriter->WriteValue(TEXT("mutations"), Mutations);
+		JsonWriter->WriteValue(TEXT("usedMemoryMB"), MemoryStats.UsedPhysical / (1024.0 * 1024.0));
+		JsonWriter->WriteValue(TEXT("peakMemoryMB"), MemoryStats.PeakUsedPhysical / (1024.0 * 1024.0));
+		JsonWriter->WriteValue(TEXT("peakMemoryPerWorldMB"), MemoryStats.PeakUsedPhysical / (1024.0 * 1024.0) / Campaigns.Num());
+		JsonWriter->WriteObjectEnd();
+		JsonWriter->Close();
+
+		return FFileHelper::SaveStringToFile(Json, *(OutputDirectory / TEXT("Worlds.json")));
+	}
+}
+
+
+UBltFuzzCommandlet::UBltFuzzCommandlet()
+{
+	IsClient = false;
+	IsEditor = false;
+	IsServer = true;
+	LogToConsole = true;
+
+	HelpDescription = TEXT("Runs a headless fuzz campaign on a map");
+	HelpUsage = TEXT("-run=BltFuzz -Map=<map> -Spec=<spec> [-Worlds=] [-Seed=] [-FirstIteration=] [-Iterations=] [-Duration=] [-TickRate=] [-TicksPerIteration=] [-Output=] [-Parallel] [-NoReset] [-Guided] [-Corpus=] [-GuideRate=] [-Replay=]");
+}
+
+int32 UBltFuzzCommandlet::Main(const FString& Params)
+{
+	FBltFuzzCampaignSettings Settings;
+	if (!Settings.Parse(*Params))
+		return 1;
+
+	int32 WorldCount = 1;
+	FParse::Value(*Params, TEXT("Worlds="), WorldCount);
+	WorldCount = FMath::Max(WorldCount, 1);
+
+	// Every world runs its own campaign with its own seed; a single world keeps the plain layout
+	TArray<TUniquePtr<FBltFuzzWorld>> Worlds;
+	TArray<TUniquePtr<FBltFuzzCampaign>> Campaigns;
+	for (int32 WorldIndex = 0; WorldIndex < WorldCount; ++WorldIndex)
+	{
+		TUniquePtr<FBltFuzzWorld> World = FBltFuzzWorld::Create(Settings.MapName, WorldIndex);
+		if (!World)
+			return 1;
+
+		FBltFuzzCampaignSettings WorldSettings = Settings;
+		if (WorldCount > 1)
+		{
+			WorldSettings.Seed = Settings.Seed + WorldIndex;
+			WorldSettings.OutputDirectory = Settings.OutputDirectory / FString::Printf(TEXT("World_%d"), WorldIndex);
+		}
+
+		TUniquePtr<FBltFuzzCampaign> Campaign = MakeUnique<FBltFuzzCampaign>(WorldSettings, *World);
+		if (!Campaign->Begin())
+			return 1;
+
+		Worlds.Add(MoveTemp(World));
+		Campaigns.Add(MoveTemp(Campaign));
+	}
+
+	// World ticks are bound to the game thread, so the worlds take turns; fuzz passes still fan out with -Parallel
+	const double StartTime = FPlatformTime::Seconds();
+	for (bool bRunning = true; bRunning && !IsEngineExitRequested(); )
+	{
+		FBltFuzzWorld::AdvanceFrame(Settings.StepSeconds);
+
+		bRunning = false;
+		for (const TUniquePtr<FBltFuzzCampaign>& Campaign : Campaigns)
+		{
+			if (!Campaign->IsDone())
+			{
+				Campaign->Step();
+				bRunning = true;
+			}
+		}
+	}
+
+	for (const TUniquePtr<FBltFuzzCampaign>& Campaign : Campaigns)
+	{
+		Campaign->End();
+	}
+
+	if (WorldCount > 1)
+	{
+		WriteWorldsSummary(Settings.OutputDirectory, Campaigns, FPlatformTime::Seconds() - StartTime);
+	}
+
+	// A replay tells the minimizer whether the candidate still fails through its exit code
+	bool bFailed = false;
+	for (const TUniquePtr<FBltFuzzCampaign>& Campaign : Campaigns)
+	{
+		bFailed |= Campaign->GetFailedIterations().Num() > 0;
+	}
+
+	UBltBPLibrary::UnloadFuzzPlan(Campaigns[0]->GetPlan());
+	Campaigns.Empty();
+	Worlds.Empty();
+	return bFailed && !Settings.ReplayPath.IsEmpty() ? 2 : 0;
+}
@@ -0,0 +1,21 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "Commandlets/Commandlet.h"
+#include "BltFuzzCommandlet.generated.h"
+
+
+// Headless fuzz campaign without the editor UI or rendering:
+//   UE4Editor-Cmd <Project> -run=BltFuzz -Map=/Game/Maps/Arena -Spec=Data/fuzzing.json -Seed=7 -Duration=28800 -nullrhi -unattended
+// -Worlds=N runs N copies of the map side by side in this process, each with seed Seed + index
+UCLASS()
+class UBltFuzzCommandlet final : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UBltFuzzCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
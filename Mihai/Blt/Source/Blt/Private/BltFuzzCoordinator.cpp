@@ -0,0 +1,326 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "BltFuzzCoordinator.h"
+
+#include "BltBPLibrary.h"
+#include "Hash/CityHash.h"
+#include "Policies/PrettyJsonPrintPolicy.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonSerializer.h"
+#include "Serialization/JsonWriter.h"
+
+
+namespace
+{
+	constexpr float PollSeconds = 0.1f;
+	constexpr int32 MaxCrashIterations = 16;
+
+	// Frames of the crash callstack without addresses, so the same crash hashes the same in every process
+	FString ExtractCallstack(const FString& Log, FString& OutMessage)
+	{
+		TArray<FString> Lines;
+		Log.ParseIntoArrayLines(Lines);
+
+		FString Callstack;
+		for (const FString& Line : Lines)
+		{
+			const int32 FrameIndex = Line.Find(TEXT("[Callstack]"), ESearchCase::CaseSensitive);
+			if (FrameIndex == INDEX_NONE)
+			{
+				if (OutMessage.IsEmpty() && (Line.Contains(TEXT("Assertion failed")) || Line.Contains(TEXT("Fatal error")) || Line.Contains(TEXT("Unhandled Exception"))))
+				{
+					OutMessage = Line.TrimStartAndEnd();
+				}
+				continue;
+			}
+
+			FString Frame = Line.Mid(FrameIndex + 11).TrimStart();
+			int32 SeparatorIndex;
+			if (Frame.FindChar(TEXT(' '), SeparatorIndex))
+			{
+				Frame.RightChopInline(SeparatorIndex + 1);
+			}
+
+			Callstack += Frame.TrimStartAndEnd();
+			Callstack += TEXT('\n');
+		}
+
+		return Callstack;
+	}
+
+	bool ReadCampaignSummary(const FString& RunDirectory, TSharedPtr<FJsonObject>& OutSummary)
+	{
+		FString Json;
+		return FFileHelper::LoadFileToString(Json, *(RunDirectory / TEXT("Campaign.json")))
+			&& FJsonSerializer::Deserialize(TJsonReaderFactory<TCHAR>::Create(Json), OutSummary)
+			&& OutSummary.IsValid();
+	}
+}
+
+
+FBltFuzzCoordinator::FBltFuzzCoordinator(const FBltFuzzCampaignSettings& InSettings, const int32 WorkerCount, const int32 InMaxRestarts)
+	: Settings(InSettings)
+	, MaxRestarts(InMaxRestarts)
+{
+	Workers.SetNum(FMath::Max(WorkerCount, 1));
+	for (int32 WorkerIndex = 0; WorkerIndex < Workers.Num(); ++WorkerIndex)
+	{
+		FWorker& Worker = Workers[WorkerIndex];
+		Worker.Index = WorkerIndex;
+
+		// Ranges are computed in 64 bits, iterations themselves have to stay within int32
+		int64 NextIteration;
+		int64 EndIteration;
+		if (Settings.Iterations > 0)
+		{
+			NextIteration = Settings.FirstIteration + static_cast<int64>(Settings.Iterations) * WorkerIndex / Workers.Num();
+			EndIteration = Settings.FirstIteration + static_cast<int64>(Settings.Iterations) * (WorkerIndex + 1) / Workers.Num();
+		}
+		else
+		{
+			NextIteration = Settings.FirstIteration + static_cast<int64>(IterationBlock) * WorkerIndex;
+			EndIteration = NextIteration + IterationBlock;
+		}
+
+		if (EndIteration > MAX_int32)
+		{
+			bRangesValid = false;
+			continue;
+		}
+
+		Worker.NextIteration = static_cast<int32>(NextIteration);
+		Worker.EndIteration = static_cast<int32>(EndIteration);
+	}
+}
+
+bool FBltFuzzCoordinator::Run()
+{
+	if (!bRangesValid)
+	{
+		UE_LOG(LogBlt, Error, TEXT("%d workers starting at iteration %d go past the last iteration, %d!"), Workers.Num(), Settings.FirstIteration, MAX_int32);
+		return false;
+	}
+
+	StartTime = FPlatformTime::Seconds();
+	UE_LOG(LogBlt, Display, TEXT("Coordinating %d workers into %s"), Workers.Num(), *Settings.OutputDirectory);
+
+	for (FWorker& Worker : Workers)
+	{
+		Launch(Worker);
+	}
+
+	for (;;)
+	{
+		bool bRunning = false;
+		for (FWorker& Worker : Workers)
+		{
+			if (Worker.bFinished)
+				continue;
+
+			int32 ReturnCode = 0;
+			if (FPlatformProcess::GetProcReturnCode(Worker.Process, &ReturnCode))
+			{
+				FPlatformProcess::CloseProc(Worker.Process);
+				OnExited(Worker, ReturnCode);
+			}
+
+			bRunning |= !Worker.bFinished;
+		}
+
+		if (!bRunning)
+			break;
+
+		if (IsEngineExitRequested())
+		{
+			UE_LOG(LogBlt, Warning, TEXT("Exit requested, stopping the workers"));
+			for (FWorker& Worker : Workers)
+			{
+				if (!Worker.bFinished)
+				{
+					FPlatformProcess::TerminateProc(Worker.Process, true);
+					FPlatformProcess::CloseProc(Worker.Process);
+					Worker.bFinished = true;
+				}
+			}
+			break;
+		}
+
+		FPlatformProcess::Sleep(PollSeconds);
+	}
+
+	const double Seconds = FPlatformTime::Seconds() - StartTime;
+	UE_LOG(LogBlt, Display, TEXT("%lld iterations in %.1f seconds, %d unique crashes"), Iterations, Seconds, Crashes.Num());
+	return WriteSummary(Seconds) && FailedRuns == 0;
+}
+
+bool FBltFuzzCoordinator::Launch(FWorker& Worker)
+{
+	if (Worker.NextIteration >= Worker.EndIteration)
+	{
+		Worker.bFinished = true;
+		return false;
+	}
+
+	FBltFuzzCampaignSettings WorkerSettings = Settings;
+	WorkerSettings.FirstIteration = Worker.NextIteration;
+	WorkerSettings.Iterations = Worker.EndIteration - Worker.NextIteration;
+	WorkerSettings.OutputDirectory = Settings.OutputDirectory / FString::Printf(TEXT("Worker_%d"), Worker.Index) / FString::Printf(TEXT("Run_%d"), Worker.Runs++);
+	Worker.RunDirectory = WorkerSettings.OutputDirectory;
+
+	if (Settings.DurationSeconds > 0.0)
+	{
+		WorkerSettings.DurationSeconds = Settings.DurationSeconds - (FPlatformTime::Seconds() - StartTime);
+		if (WorkerSettings.DurationSeconds <= 0.0)
+		{
+			Worker.bFinished = true;
+			return false;
+		}
+	}
+
+	Worker.Process = WorkerSettings.Launch(Worker.RunDirectory / TEXT("Worker.log"));
+	if (!Worker.Process.IsValid())
+	{
+		UE_LOG(LogBlt, Error, TEXT("Could not start worker %d!"), Worker.Index);
+		Worker.bFinished = true;
+		++FailedRuns;
+		return false;
+	}
+
+	UE_LOG(LogBlt, Display, TEXT("Worker %d: iterations %d to %d"), Worker.Index, Worker.NextIteration, Worker.EndIteration);
+	return true;
+}
+
+void FBltFuzzCoordinator::OnExited(FWorker& Worker, const int32 ReturnCode)
+{
+	TSharedPtr<FJsonObject> Summary;
+	if (ReturnCode == 0 && ReadCampaignSummary(Worker.RunDirectory, Summary))
+	{
+		Iterations += static_cast<int64>(Summary->GetNumberField(TEXT("iterations")));
+		Mutations += static_cast<int64>(Summary->GetNumberField(TEXT("mutations")));
+		Worker.PeakMemoryMB = FMath::Max(Worker.PeakMemoryMB, Summary->GetNumberField(TEXT("peakMemoryMB")));
+		Worker.bFinished = true;
+		return;
+	}
+
+	// A worker that never got to fuzz fails the same way on every restart
+	const int32 CrashIteration = FBltFuzzCampaign::ReadProgress(Worker.RunDirectory);
+	if (CrashIteration == INDEX_NONE)
+	{
+		UE_LOG(LogBlt, Error, TEXT("Worker %d exited with %d before fuzzing, see %s"), Worker.Index, ReturnCode, *Worker.RunDirectory);
+		Worker.bFinished = true;
+		++FailedRuns;
+		return;
+	}
+
+	FString Log;
+	FFileHelper::LoadFileToString(Log, *(Worker.RunDirectory / TEXT("Worker.log")));
+
+	Iterations += CrashIteration - Worker.NextIteration;
+	RecordCrash(Worker, Log, CrashIteration, ReturnCode);
+
+	Worker.NextIteration = CrashIteration + 1;
+	if (Worker.NextIteration >= Worker.EndIteration)
+	{
+		Worker.bFinished = true;
+		return;
+	}
+
+	if (++Worker.Restarts > MaxRestarts)
+	{
+		UE_LOG(LogBlt, Error, TEXT("Worker %d crashed %d times, giving up on it"), Worker.Index, Worker.Restarts);
+		Worker.bFinished = true;
+		++FailedRuns;
+		return;
+	}
+
+	Launch(Worker);
+}
+
+void FBltFuzzCoordinator::RecordCrash(const FWorker& Worker, const FString& Log, const int32 Iteration, const int32 ReturnCode)
+{
+	FString Message;
+	FString Callstack = ExtractCallstack(Log, Message);
+	if (Callstack.IsEmpty())
+	{
+		// Killed from outside or by the OS, nothing to tell these apart but the exit code
+		Callstack = FString::Printf(TEXT("Exit code %d\n"), ReturnCode);
+	}
+
+	const FTCHARToUTF8 Utf8Callstack(*Callstack);
+	const uint64 Hash = CityHash64(Utf8Callstack.Get(), Utf8Callstack.Length());
+
+	FCrash& Crash = Crashes.FindOrAdd(Hash);
+	if (Crash.Count++ == 0)
+	{
+		Crash.Callstack = MoveTemp(Callstack);
+		Crash.Message = MoveTemp(Message);
+		FFileHelper::SaveStringToFile(Log, *(Settings.OutputDirectory / TEXT("Crashes") / FString::Printf(TEXT("%016llx.log"), Hash)));
+		UE_LOG(LogBlt, Warning, TEXT("Worker %d: new crash %016llx at iteration %d"), Worker.Index, Hash, Iteration);
+	}
+	else
+	{
+		UE_LOG(LogBlt, Display, TEXT("Worker %d: crash %016llx again at iteration %d"), Worker.Index, Hash, Iteration);
+	}
+
+	if (Crash.Iterations.Num() < MaxCrashIterations)
+	{
+		Crash.Iterations.Add(Iteration);
+	}
+}
+
+bool FBltFuzzCoordinator::WriteSummary(const double Seconds) const
+{
+	// Sum of the worker peaks, compared against peakMemoryMB of Worlds.json for in-process worlds
+	double PeakMemoryMB = 0.0;
+	for (const FWorker& Worker : Workers)
+	{
+		PeakMemoryMB += Worker.PeakMemoryMB;
+	}
+
+	FString Json;
+	const TSharedRef<TJsonWriter<TCHAR, TPrettyJsonPrintPolicy<TCHAR>>> JsonWriter
+		= TJsonWriterFactory<TCHAR, TPrettyJsonPrintPolicy<TCHAR>>::Create(&Json);
+
+	JsonWriter->WriteObjectStart();
+	JsonWriter->WriteValue(TEXT("map"), Settings.MapName);
+	JsonWriter->WriteValue(TEXT("spec"), Settings.SpecPath);
+	JsonWriter->WriteValue(TEXT("seed"), Settings.Seed);
+	JsonWriter->WriteValue(TEXT("workers"), Workers.Num());
+	JsonWriter->WriteValue(TEXT("iterations"), Iterations);
+	JsonWriter->WriteValue(TEXT("seconds"), Seconds);
+	JsonWriter->WriteValue(TEXT("iterationsPerSecond"), Seconds > 0.0 ? Iterations / Seconds : 0.0);
+	JsonWriter->WriteValue(TEXT("mutations"), Mutations);
+	JsonWriter->WriteValue(TEXT("failedRuns"), FailedRuns);
+	JsonWriter->WriteValue(TEXT("peakMemoryMB"), PeakMemoryMB);
+	JsonWriter->WriteValue(TEXT("peakMemoryPerWorkerMB"), PeakMemoryMB / Workers.Num());
+
+	JsonWriter->WriteArrayStart(TEXT("crashes"));
+	for (const TPair<uint64, FCrash>& Pair : Crashes)
+	{
+		JsonWriter->WriteObjectStart();
+		JsonWriter->WriteValue(TEXT("hash"), FString::Printf(TEXT("%016llx"), Pair.Key));
+		JsonWriter->WriteValue(TEXT("count"), Pair.Value.Count);
+		JsonWriter->WriteValue(TEXT("message"), Pair.Value.Message);
+		JsonWriter->WriteValue(TEXT("callstack"), Pair.Value.Callstack);
+		JsonWriter->WriteArrayStart(TEXT("iterations"));
+		for (const int32 Iteration : Pair.Value.Iterations)
+		{
+			JsonWriter->WriteValue(Iteration);
+		}
+		JsonWriter->WriteArrayEnd();
+		JsonWriter->WriteObjectEnd();
+	}
+	JsonWriter->WriteArrayEnd();
+
+	JsonWriter->WriteObjectEnd();
+	JsonWriter->Close();
+
+	const FString SummaryPath = Settings.OutputDirectory / TEXT("Coordinator.json");
+	if (!FFileHelper::SaveStringToFile(Json, *SummaryPath))
+	{
+		UE_LOG(LogBlt, Error, TEXT("Could not write %s!"), *SummaryPath);
+		return false;
+	}
+
+	return true;
+}
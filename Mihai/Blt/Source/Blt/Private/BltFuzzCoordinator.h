@@ -0,0 +1,62 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "BltFuzzCampaign.h"
+
+
+// Splits a campaign across local BltFuzz worker processes. Every worker owns a disjoint iteration
+// range and writes its journal, summary and log into its own directory; the coordinator only
+// watches process exits and reads those files, so nothing leaves the machine. A worker that dies
+// is restarted right after the iteration it died on, and its crash is bucketed by callstack hash.
+class FBltFuzzCoordinator
+{
+public:
+	FBltFuzzCoordinator(const FBltFuzzCampaignSettings& InSettings, const int32 WorkerCount, const int32 InMaxRestarts);
+
+	bool Run();
+
+private:
+	// Duration-only campaigns give every worker a block of this many iterations
+	static constexpr int32 IterationBlock = 1 << 24;
+
+	struct FWorker
+	{
+		int32 Index = 0;
+		int32 NextIteration = 0;
+		int32 EndIteration = 0;
+		int32 Runs = 0;
+		int32 Restarts = 0;
+		double PeakMemoryMB = 0.0;
+		FString RunDirectory;
+		FProcHandle Process;
+		bool bFinished = false;
+	};
+
+	struct FCrash
+	{
+		FString Callstack;
+		FString Message;
+		int32 Count = 0;
+		TArray<int32> Iterations;
+	};
+
+	bool Launch(FWorker& Worker);
+	void OnExited(FWorker& Worker, const int32 ReturnCode);
+	void RecordCrash(const FWorker& Worker, const FString& Log, const int32 Iteration, const int32 ReturnCode);
+	bool WriteSummary(const double Seconds) const;
+
+	FBltFuzzCampaignSettings Settings;
+	int32 MaxRestarts = 0;
+	double StartTime = 0.0;
+
+	// False when the iteration ranges of the workers do not fit in int32
+	bool bRangesValid = true;
+
+	TArray<FWorker> Workers;
+	TMap<uint64, FCrash> Crashes;
+
+	int64 Iterations = 0;
+	int64 Mutations = 0;
+	int32 FailedRuns = 0;
+};
@@ -0,0 +1,34 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "BltFuzzCoordinatorCommandlet.h"
+
+#include "BltFuzzCoordinator.h"
+
+
+UBltFuzzCoordinatorCommandlet::UBltFuzzCoordinatorCommandlet()
+{
+	IsClient = false;
+	IsEditor = false;
+	IsServer = false;
+	LogToConsole = true;
+
+	HelpDescription = TEXT("Shards a headless fuzz campaign across local worker processes");
+	HelpUsage = TEXT("-run=BltFuzzCoordinator [-Workers=] [-MaxRestarts=] <BltFuzz arguments>");
+}
+
+int32 UBltFuzzCoordinatorCommandlet::Main(const FString& Params)
+{
+	FBltFuzzCampaignSettings Settings;
+	if (!Settings.Parse(*Params))
+		return 1;
+
+	// Leaves a core for the coordinator itself
+	int32 WorkerCount = FMath::Max(FPlatformMisc::NumberOfCoresIncludingHyperthreads() - 1, 1);
+	FParse::Value(*Params, TEXT("Workers="), WorkerCount);
+
+	int32 MaxRestarts = 100;
+	FParse::Value(*Params, TEXT("MaxRestarts="), MaxRestarts);
+
+	FBltFuzzCoordinator Coordinator(Settings, WorkerCount, MaxRestarts);
+	return Coordinator.Run() ? 0 : 1;
+}
@@ -0,0 +1,20 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "Commandlets/Commandlet.h"
+#include "BltFuzzCoordinatorCommandlet.generated.h"
+
+
+// Runs a campaign on several local BltFuzz worker processes and merges their results:
+//   UE4Editor-Cmd <Project> -run=BltFuzzCoordinator -Workers=60 -Map=/Game/Maps/Arena -Spec=Data/fuzzing.json -Duration=28800
+UCLASS()
+class UBltFuzzCoordinatorCommandlet final : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UBltFuzzCoordinatorCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
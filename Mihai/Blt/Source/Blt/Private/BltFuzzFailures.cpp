@@ -0,0 +1,25 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "BltFuzzFailures.h"
+
+
+FCriticalSection FBltFuzzFailures::Lock;
+TMap<FObjectKey, TArray<FString>> FBltFuzzFailures::Reasons;
+
+void FBltFuzzFailures::Report(const UWorld* const World, const FString& Reason)
+{
+	FScopeLock ScopeLock(&Lock);
+	Reasons.FindOrAdd(FObjectKey(World)).Add(Reason);
+}
+
+bool FBltFuzzFailures::Consume(const UWorld* const World, TArray<FString>& OutReasons)
+{
+	FScopeLock ScopeLock(&Lock);
+
+	TArray<FString> WorldReasons;
+	if (!Reasons.RemoveAndCopyValue(FObjectKey(World), WorldReasons))
+		return false;
+
+	OutReasons.Append(MoveTemp(WorldReasons));
+	return true;
+}
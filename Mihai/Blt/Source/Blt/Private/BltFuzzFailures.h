@@ -0,0 +1,20 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "UObject/ObjectKey.h"
+
+
+// Failures reported from gameplay code, kept per world until the campaign driving it picks them up
+class FBltFuzzFailures
+{
+public:
+	static void Report(const UWorld* const World, const FString& Reason);
+
+	// Moves the failures reported for World into OutReasons; returns whether there were any
+	static bool Consume(const UWorld* const World, TArray<FString>& OutReasons);
+
+private:
+	static FCriticalSection Lock;
+	static TMap<FObjectKey, TArray<FString>> Reasons;
+};
@@ -0,0 +1,604 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "BltFuzzPlan.h"
+
+#include "BltBPLibrary.h"
+#include "BltClassSchema.h"
+#include "BltNamePool.h"
+#include "BltRandom.h"
+#include "BltRegexGenerator.h"
+#include "BltStats.h"
+#include "BltValueDistribution.h"
+
+
+namespace
+{
+	EBltFuzzValueType GetValueType(const FProperty* const Property)
+	{
+		if (Property->IsA<FEnumProperty>())
+			return EBltFuzzValueType::Enum;
+
+		if (const FByteProperty* const ByteProperty = CastField<const FByteProperty>(Property))
+			return ByteProperty->Enum ? EBltFuzzValueType::Enum : EBltFuzzValueType::UInt8;
+
+		if (Property->IsA<FInt8Property>())
+			return EBltFuzzValueType::Int8;
+
+		if (Property->IsA<FInt16Property>())
+			return EBltFuzzValueType::Int16;
+
+		if (Property->IsA<FIntProperty>())
+			return EBltFuzzValueType::Int32;
+
+		if (Property->IsA<FInt64Property>())
+			return EBltFuzzValueType::Int64;
+
+		if (Property->IsA<FUInt16Property>())
+			return EBltFuzzValueType::UInt16;
+
+		if (Property->IsA<FUInt32Property>())
+			return EBltFuzzValueType::UInt32;
+
+		if (Property->IsA<FUInt64Property>())
+			return EBltFuzzValueType::UInt64;
+
+		if (Property->IsA<FFloatProperty>())
+			return EBltFuzzValueType::Float;
+
+		if (Property->IsA<FDoubleProperty>())
+			return EBltFuzzValueType::Double;
+
+		if (Property->IsA<FBoolProperty>())
+			return EBltFuzzValueType::Bool;
+
+		if (Property->IsA<FStrProperty>())
+			return EBltFuzzValueType::String;
+
+		if (Property->IsA<FNameProperty>())
+			return EBltFuzzValueType::Name;
+
+		if (Property->IsA<FTextProperty>())
+			return EBltFuzzValueType::Text;
+
+		return EBltFuzzValueType::None;
+	}
+
+	bool IsNumericType(const EBltFuzzValueType Type)
+	{
+		return (Type >= EBltFuzzValueType::Int8 && Type <= EBltFuzzValueType::Double) || Type == EBltFuzzValueType::Enum;
+	}
+
+	template <typename T>
+	T ClampToInteger(const double Value)
+	{
+		if (Value <= static_cast<double>(TNumericLimits<T>::Lowest()))
+			return TNumericLimits<T>::Lowest();
+
+		if (Value >= static_cast<double>(TNumericLimits<T>::Max()))
+			return TNumericLimits<T>::Max();
+
+		return static_cast<T>(Value);
+	}
+
+	template <typename T>
+	void DecodeIntegerRange(FBltFuzzPropertyPlan& PropertyPlan)
+	{
+		PropertyPlan.IntegerMin = static_cast<uint64>(ClampToInteger<T>(FMath::Min(PropertyPlan.Min, PropertyPlan.Max)));
+		PropertyPlan.IntegerMax = static_cast<uint64>(ClampToInteger<T>(FMath::Max(PropertyPlan.Min, PropertyPlan.Max)));
+	}
+
+	bool DecodeEnum(FBltFuzzPropertyPlan& PropertyPlan)
+	{
+		const FProperty* const Property = PropertyPlan.Property;
+		const FEnumProperty* const EnumProperty = CastField<const FEnumProperty>(Property);
+		const UEnum* const Enum = EnumProperty ? EnumProperty->GetEnum() : CastFieldChecked<const FByteProperty>(Property)->Enum;
+
+		const int32 EntryCount = Enum->ContainsExistingMax() ? Enum->NumEnums() - 1 : Enum->NumEnums();
+		for (int32 EntryIndex = 0; EntryIndex < EntryCount; ++EntryIndex)
+		{
+			const int64 Value = Enum->GetValueByIndex(EntryIndex);
+			if (PropertyPlan.Source != EBltFuzzRangeSource::Interval
+				|| (Value >= PropertyPlan.Min && Value <= PropertyPlan.Max))
+			{
+				PropertyPlan.EnumValues.Add(Value);
+			}
+		}
+
+		PropertyPlan.EnumSize = static_cast<uint8>(Property->ElementSize);
+		return PropertyPlan.EnumValues.Num() > 0;
+	}
+
+	bool DecodeLayout(FBltFuzzPropertyPlan& PropertyPlan)
+	{
+		switch (PropertyPlan.Type)
+		{
+		case EBltFuzzValueType::Int8:   DecodeIntegerRange<int8>(PropertyPlan);   return true;
+		case EBltFuzzValueType::Int16:  DecodeIntegerRange<int16>(PropertyPlan);  return true;
+		case EBltFuzzValueType::Int32:  DecodeIntegerRange<int32>(PropertyPlan);  return true;
+		case EBltFuzzValueType::Int64:  DecodeIntegerRange<int64>(PropertyPlan);  return true;
+		case EBltFuzzValueType::UInt8:  DecodeIntegerRange<uint8>(PropertyPlan);  return true;
+		case EBltFuzzValueType::UInt16: DecodeIntegerRange<uint16>(PropertyPlan); return true;
+		case EBltFuzzValueType::UInt32: DecodeIntegerRange<uint32>(PropertyPlan); return true;
+		case EBltFuzzValueType::UInt64: DecodeIntegerRange<uint64>(PropertyPlan); return true;
+
+		case EBltFuzzValueType::Bool:
+		{
+			const FBoolProperty* const BoolProperty = CastFieldChecked<const FBoolProperty>(PropertyPlan.Property);
+			PropertyPlan.ByteOffset = BoolProperty->GetByteOffset();
+			PropertyPlan.FieldMask = BoolProperty->GetFieldMask();
+			PropertyPlan.ByteMask = BoolProperty->GetByteMask();
+			return true;
+		}
+
+		case EBltFuzzValueType::Enum:
+			return DecodeEnum(PropertyPlan);
+
+		default:
+			return true;
+		}
+	}
+
+	bool IsStringType(const EBltFuzzValueType Type)
+	{
+		return Type == EBltFuzzValueType::String || Type == EBltFuzzValueType::Name || Type == EBltFuzzValueType::Text;
+	}
+
+	bool IsSubobjectReference(const FObjectProperty* const ObjectProperty)
+	{
+		return ObjectProperty->HasAnyPropertyFlags(CPF_InstancedReference | CPF_ExportObject)
+			|| ObjectProperty->PropertyClass->IsChildOf<UActorComponent>();
+	}
+
+	constexpr int32 MaxPathDepth = 8;
+
+	// Spec entry holding the defaults of its class
+	const FName DefaultsEntryName(TEXT("*"));
+
+	bool IsIntervalType(const EBltFuzzValueType Type)
+	{
+		return Type >= EBltFuzzValueType::Int8 && Type <= EBltFuzzValueType::Double;
+	}
+}
+
+
+FBltFuzzPlan::FBltFuzzPlan(
+	const FString& InSourcePath,
+	TArray<FBltFuzzClassSpec>&& InClasses,
+	const FBltFuzzPlan* const Previous
+)
+	: SourcePath(InSourcePath)
+	, Classes(MoveTemp(InClasses))
+{
+	ResolvedPlans.SetNum(Classes.Num());
+	if (!Previous)
+		return;
+
+	TMap<FString, int32> PreviousIndices;
+	for (int32 ClassIndex = 0; ClassIndex < Previous->Classes.Num(); ++ClassIndex)
+	{
+		PreviousIndices.Add(Previous->Classes[ClassIndex].ClassName, ClassIndex);
+	}
+
+	FReadScopeLock ReadLock(Previous->ResolvedLock);
+	int32 ReusedCount = 0;
+	for (int32 ClassIndex = 0; ClassIndex < Classes.Num(); ++ClassIndex)
+	{
+		const int32* const PreviousIndex = PreviousIndices.Find(Classes[ClassIndex].ClassName);
+		if (PreviousIndex && Previous->Classes[*PreviousIndex].SourceHash == Classes[ClassIndex].SourceHash)
+		{
+			ResolvedPlans[ClassIndex] = Previous->ResolvedPlans[*PreviousIndex];
+			++ReusedCount;
+		}
+	}
+
+	UE_LOG(LogBlt, Log, TEXT("Reloaded %s, %d of %d class entries changed"), *SourcePath, Classes.Num() - ReusedCount, Classes.Num());
+}
+
+void FBltFuzzPlan::ClassifyObjectEntry(FBltFuzzPropertySpec& PropertySpec)
+{
+	if (PropertySpec.Source == EBltFuzzRangeSource::Regex)
+		return;
+
+	const FBltFuzzDistributionSpec& Distribution = PropertySpec.Distribution;
+	if (Distribution.Buckets.Num() == 1 && Distribution.Edges.Num() == 0 && Distribution.BoundaryRate <= 0.0 && !Distribution.bLogScale)
+	{
+		PropertySpec.Source = EBltFuzzRangeSource::Interval;
+		PropertySpec.Min = Distribution.Buckets[0].Min;
+		PropertySpec.Max = Distribution.Buckets[0].Max;
+	}
+	else if (Distribution.Buckets.Num() > 0 || Distribution.Edges.Num() > 0 || Distribution.BoundaryRate > 0.0)
+	{
+		PropertySpec.Source = EBltFuzzRangeSource::Distribution;
+	}
+	else
+	{
+		PropertySpec.Source = EBltFuzzRangeSource::Default;
+	}
+}
+
+void FBltFuzzPlan::DecodeEdgeString(const FString& Text, FBltFuzzEdgeSpec& OutEdge)
+{
+	if (Text.Len() > 2 && Text.StartsWith(TEXT("0x")))
+	{
+		TCHAR* End = nullptr;
+		const uint64 Bits = FCString::Strtoui64(*Text + 2, &End, 16);
+		if (End && *End == TEXT('\0'))
+		{
+			OutEdge.Bits = Bits;
+			OutEdge.bRawBits = true;
+			return;
+		}
+	}
+
+	OutEdge.Name = FName(*Text);
+}
+
+const FBltFuzzClassPlan& FBltFuzzPlan::FindOrResolveClassPlan(const int32 ClassIndex, const UClass* const ActorClass) const
+{
+	check(Classes.IsValidIndex(ClassIndex));
+
+	const uint32 SchemaGeneration = FBltClassSchemaCache::Get().GetGeneration();
+	{
+		FReadScopeLock ReadLock(ResolvedLock);
+		if (const TSharedRef<FBltFuzzClassPlan, ESPMode::ThreadSafe>* const ClassPlan
+			= ResolvedPlans[ClassIndex].Find(ActorClass))
+		{
+			if ((*ClassPlan)->SchemaGeneration == SchemaGeneration)
+			{
+				INC_DWORD_STAT(STAT_BltPlanCacheHits);
+				return ClassPlan->Get();
+			}
+		}
+	}
+
+	INC_DWORD_STAT(STAT_BltPlanCacheMisses);
+
+	TSharedRef<FBltFuzzClassPlan, ESPMode::ThreadSafe> ClassPlan
+		= MakeShared<FBltFuzzClassPlan, ESPMode::ThreadSafe>(ResolveClassPlan(Classes[ClassIndex], ActorClass));
+
+	FWriteScopeLock WriteLock(ResolvedLock);
+	if (const TSharedRef<FBltFuzzClassPlan, ESPMode::ThreadSafe>* const Existing = ResolvedPlans[ClassIndex].Find(ActorClass))
+	{
+		if ((*Existing)->SchemaGeneration == ClassPlan->SchemaGeneration)
+			return Existing->Get();
+	}
+
+	return ResolvedPlans[ClassIndex].Add(ActorClass, ClassPlan).Get();
+}
+
+const FBltFuzzClassPlan* FBltFuzzPlan::FindOrResolveActorPlan(const UClass* const ActorClass) const
+{
+	TArray<const FBltFuzzClassPlan*, TInlineAllocator<4>> ClassPlans;
+	for (int32 ClassIndex = 0; ClassIndex < Classes.Num(); ++ClassIndex)
+	{
+		const UClass* const SpecClass = Classes[ClassIndex].Class.Get();
+		if (SpecClass && ActorClass->IsChildOf(SpecClass))
+		{
+			ClassPlans.Add(&FindOrResolveClassPlan(ClassIndex, ActorClass));
+		}
+	}
+
+	if (ClassPlans.Num() <= 1)
+		return ClassPlans.Num() == 1 ? ClassPlans[0] : nullptr;
+
+	const uint32 SchemaGeneration = FBltClassSchemaCache::Get().GetGeneration();
+	{
+		FReadScopeLock ReadLock(ResolvedLock);
+		if (const TSharedRef<FBltFuzzClassPlan, ESPMode::ThreadSafe>* const ClassPlan = MergedPlans.Find(ActorClass))
+		{
+			if ((*ClassPlan)->SchemaGeneration == SchemaGeneration)
+				return &ClassPlan->Get();
+		}
+	}
+
+	TSharedRef<FBltFuzzClassPlan, ESPMode::ThreadSafe> ClassPlan
+		= MakeShared<FBltFuzzClassPlan, ESPMode::ThreadSafe>(MergeClassPlans(ClassPlans));
+
+	FWriteScopeLock WriteLock(ResolvedLock);
+	if (const TSharedRef<FBltFuzzClassPlan, ESPMode::ThreadSafe>* const Existing = MergedPlans.Find(ActorClass))
+	{
+		if ((*Existing)->SchemaGeneration == ClassPlan->SchemaGeneration)
+			return &Existing->Get();
+	}
+
+	return &MergedPlans.Add(ActorClass, ClassPlan).Get();
+}
+
+FBltFuzzClassPlan FBltFuzzPlan::MergeClassPlans(const TArray<const FBltFuzzClassPlan*, TInlineAllocator<4>>& ClassPlans)
+{
+	FBltFuzzClassPlan Merged;
+	Merged.Class = ClassPlans[0]->Class;
+	Merged.SchemaGeneration = ClassPlans[0]->SchemaGeneration;
+
+	TMap<FName, int32> Indices;
+	for (const FBltFuzzClassPlan* const ClassPlan : ClassPlans)
+	{
+		for (const FBltFuzzPropertyPlan& PropertyPlan : ClassPlan->Properties)
+		{
+			int32& Index = Indices.FindOrAdd(PropertyPlan.PathName, INDEX_NONE);
+			if (Index == INDEX_NONE)
+			{
+				Index = Merged.Properties.Add(PropertyPlan);
+			}
+			else if (PropertyPlan.Source != EBltFuzzRangeSource::Default || Merged.Properties[Index].Source == EBltFuzzRangeSource::Default)
+			{
+				Merged.Properties[Index] = PropertyPlan;
+			}
+		}
+	}
+
+	return Merged;
+}
+
+FBltFuzzClassPlan FBltFuzzPlan::ResolveClassPlan(const FBltFuzzClassSpec& ClassSpec, const UClass* const ActorClass) const
+{
+	BLT_SCOPE_CYCLE_COUNTER(STAT_BltPlanResolve);
+
+	const FBltClassSchemaPtr Schema = FBltClassSchemaCache::Get().FindOrBuild(ActorClass);
+
+	FBltFuzzClassPlan ClassPlan;
+	ClassPlan.Class = ActorClass;
+	ClassPlan.SchemaGeneration = Schema->Generation;
+
+	// Every proper prefix of a dotted spec path, the nodes the walk has to descend into
+	TSet<FString> PathPrefixes;
+	for (const TPair<FName, FBltFuzzPropertySpec>& Pair : ClassSpec.Properties)
+	{
+		FString Prefix = Pair.Key.ToString();
+		int32 SeparatorIndex;
+		while (Prefix.FindLastChar(TEXT('.'), SeparatorIndex))
+		{
+			Prefix.LeftInline(SeparatorIndex);
+			PathPrefixes.Add(Prefix);
+		}
+	}
+
+	for (const FBltSchemaProperty& SchemaProperty : Schema->Properties)
+	{
+		const FProperty* const Property = SchemaProperty.Property;
+
+		FBltFuzzPropertyPlan PropertyPlan;
+		PropertyPlan.Offset = Property->GetOffset_ForInternal();
+		PropertyPlan.RootProperty = Property;
+		ResolveProperty(ClassSpec, PathPrefixes, Property, Property->GetName(), PropertyPlan, SchemaProperty.bUserDefined, 0, ClassPlan.Properties);
+	}
+
+	return ClassPlan;
+}
+
+void FBltFuzzPlan::ResolveProperty(
+	const FBltFuzzClassSpec& ClassSpec,
+	const TSet<FString>& PathPrefixes,
+	const FProperty* const Property,
+	const FString& PathName,
+	const FBltFuzzPropertyPlan& Node,
+	const bool bUserDefined,
+	const int32 Depth,
+	TArray<FBltFuzzPropertyPlan>& OutProperties
+) const
+{
+	const FBltFuzzPropertySpec* PropertySpec = ClassSpec.Properties.Find(FName(*PathName, FNAME_Find));
+
+	const EBltFuzzValueType Type = GetValueType(Property);
+	if (Type != EBltFuzzValueType::None)
+	{
+		if (!PropertySpec && (!bUserDefined || !IsNumericType(Type)))
+			return;
+
+		const FBltFuzzPropertySpec* const ClassDefaults = ClassSpec.Properties.Find(DefaultsEntryName);
+		if (!PropertySpec && ClassDefaults && !ClassDefaults->bFuzzUnlisted)
+			return;
+
+		if (!PropertySpec && IsIntervalType(Type) && ClassDefaults && ClassDefaults->Source != EBltFuzzRangeSource::Regex)
+		{
+			PropertySpec = ClassDefaults;
+		}
+
+		FBltFuzzPropertyPlan PropertyPlan = Node;
+		PropertyPlan.Property = Property;
+		PropertyPlan.PathName = FName(*PathName);
+		PropertyPlan.PropertyId = FBltRandomStream::HashName(PropertyPlan.PathName);
+		PropertyPlan.Type = Type;
+		PropertyPlan.Min = 0.0;
+		PropertyPlan.Max = 1000000.0;
+
+		if (PropertySpec)
+		{
+			const bool bIsRegex = PropertySpec->Source == EBltFuzzRangeSource::Regex;
+			const bool bHasRange = PropertySpec->Source == EBltFuzzRangeSource::Interval || PropertySpec->Source == EBltFuzzRangeSource::Distribution;
+			if (bIsRegex ? !IsStringType(Type) : bHasRange && IsStringType(Type))
+			{
+				UE_LOG(LogBlt, Error, TEXT("%s does not match its JSON entry type!"), *PathName);
+				return;
+			}
+
+			PropertyPlan.Source = PropertySpec->Source;
+			PropertyPlan.Regex = PropertySpec->Regex;
+			if (PropertySpec->Source == EBltFuzzRangeSource::Interval)
+			{
+				PropertyPlan.Min = PropertySpec->Min;
+				PropertyPlan.Max = PropertySpec->Max;
+			}
+			else if (bIsRegex)
+			{
+				PropertyPlan.Generator = FBltRegexCache::Get().FindOrCompile(PropertySpec->Regex);
+			}
+			else if (PropertySpec->Source == EBltFuzzRangeSource::Distribution)
+			{
+				FString Error;
+				PropertyPlan.Distribution = FBltValueDistribution::Compile(PropertySpec->Distribution, Type, Error);
+				if (!PropertyPlan.Distribution)
+				{
+					UE_LOG(LogBlt, Error, TEXT("%s: %s!"), *PathName, *Error);
+					return;
+				}
+
+				const FBltFuzzDistributionSpec& Distribution = PropertySpec->Distribution;
+				PropertyPlan.bUnbounded = Distribution.Edges.Num() > 0 || Distribution.BoundaryRate > 0.0;
+				if (Distribution.Buckets.Num() > 0)
+				{
+					PropertyPlan.Min = MAX_dbl;
+					PropertyPlan.Max = -MAX_dbl;
+					for (const FBltFuzzBucketSpec& Bucket : Distribution.Buckets)
+					{
+						PropertyPlan.Min = FMath::Min3(PropertyPlan.Min, Bucket.Min, Bucket.Max);
+						PropertyPlan.Max = FMath::Max3(PropertyPlan.Max, Bucket.Min, Bucket.Max);
+					}
+				}
+			}
+		}
+
+		EBltFuzzStrategy Strategy = PropertySpec ? PropertySpec->Strategy : EBltFuzzStrategy::Default;
+		if (Strategy == EBltFuzzStrategy::Default && ClassDefaults)
+		{
+			Strategy = ClassDefaults->Strategy;
+		}
+		PropertyPlan.Strategy = Strategy == EBltFuzzStrategy::Default ? EBltFuzzStrategy::Sample : Strategy;
+
+		// Without a regex a string can only be edited
+		if (IsStringType(Type) && PropertyPlan.Source != EBltFuzzRangeSource::Regex && PropertyPlan.Strategy != EBltFuzzStrategy::Mutate)
+		{
+			UE_LOG(LogBlt, Error, TEXT("%s has no regex to sample from!"), *PathName);
+			return;
+		}
+
+		if (!DecodeLayout(PropertyPlan))
+		{
+			UE_LOG(LogBlt, Error, TEXT("%s has no value inside its JSON interval!"), *PathName);
+			return;
+		}
+
+		const int32 NamePoolSize = PropertySpec ? PropertySpec->NamePoolSize : 0;
+		if (Type == EBltFuzzValueType::Name)
+		{
+			PropertyPlan.NamePool = FBltNamePoolCache::Get().FindOrAdd(SourcePath, PropertyPlan, NamePoolSize > 0 ? NamePoolSize : FBltNamePool::DefaultSize);
+		}
+		else if (NamePoolSize > 0)
+		{
+			UE_LOG(LogBlt, Warning, TEXT("%s is not an FName, its NamePool is ignored"), *PathName);
+		}
+
+		OutProperties.Add(MoveTemp(PropertyPlan));
+		return;
+	}
+
+	// User defined aggregates are walked like their top level counterparts, anything else only down to spec paths
+	const bool bInSpec = PropertySpec || PathPrefixes.Contains(PathName);
+	if (Depth >= MaxPathDepth || (!bUserDefined && !bInSpec))
+		return;
+
+	if (const FStructProperty* const StructProperty = CastField<const FStructProperty>(Property))
+	{
+		for (TFieldIterator<FProperty> Iterator(StructProperty->Struct); Iterator; ++Iterator)
+		{
+			FBltFuzzPropertyPlan Member = Node;
+			Member.Offset += Iterator->GetOffset_ForInternal();
+			ResolveProperty(ClassSpec, PathPrefixes, *Iterator, PathName + TEXT(".") + Iterator->GetName(), Member, bUserDefined, Depth + 1, OutProperties);
+		}
+		return;
+	}
+
+	// Container elements share the path of their container. Set elements are their own keys, so like map keys
+	// they are left alone: mutating them in place would leave duplicates behind
+	const FProperty* ElementProperty = nullptr;
+	EBltFuzzAccessKind Kind = EBltFuzzAccessKind::Array;
+	if (const FArrayProperty* const ArrayProperty = CastField<const FArrayProperty>(Property))
+	{
+		ElementProperty = ArrayProperty->Inner;
+	}
+	else if (const FMapProperty* const MapProperty = CastField<const FMapProperty>(Property))
+	{
+		ElementProperty = MapProperty->ValueProp;
+		Kind = EBltFuzzAccessKind::Map;
+	}
+
+	if (ElementProperty)
+	{
+		FBltFuzzPropertyPlan Element = Node;
+		Element.Path.Add({ Kind, Node.Offset, Property });
+		Element.Offset = 0;
+		ResolveProperty(ClassSpec, PathPrefixes, ElementProperty, PathName, Element, bUserDefined, Depth + 1, OutProperties);
+		return;
+	}
+
+	// Components and other instanced subobjects are only entered when the spec names a path through them
+	const FObjectProperty* const ObjectProperty = CastField<const FObjectProperty>(Property);
+	if (!ObjectProperty || !PathPrefixes.Contains(PathName) || !IsSubobjectReference(ObjectProperty))
+		return;
+
+	FBltFuzzPropertyPlan Subobject = Node;
+	Subobject.Path.Add({ EBltFuzzAccessKind::Object, Node.Offset, Property });
+	for (TFieldIterator<FProperty> Iterator(ObjectProperty->PropertyClass); Iterator; ++Iterator)
+	{
+		FBltFuzzPropertyPlan Member = Subobject;
+		Member.Offset = Iterator->GetOffset_ForInternal();
+		Member.RootProperty = *Iterator;
+		ResolveProperty(ClassSpec, PathPrefixes, *Iterator, PathName + TEXT(".") + Iterator->GetName(), Member, false, Depth + 1, OutProperties);
+	}
+}
+
+
+FBltFuzzPlanRegistry& FBltFuzzPlanRegistry::Get()
+{
+	static FBltFuzzPlanRegistry Registry;
+	return Registry;
+}
+
+FBltFuzzPlanHandle FBltFuzzPlanRegistry::Register(const FString& SourcePath, const FBltFuzzPlanPtr& Plan)
+{
+	FScopeLock ScopeLock(&Lock);
+
+	FBltFuzzPlanHandle Handle;
+	if (const int32* const ExistingId = HandlesByPath.Find(SourcePath))
+	{
+		Handle.Id = *ExistingId;
+	}
+	else
+	{
+		Handle.Id = NextId++;
+		HandlesByPath.Add(SourcePath, Handle.Id);
+	}
+
+	Plans.Add(Handle.Id, Plan);
+	return Handle;
+}
+
+void FBltFuzzPlanRegistry::Unregister(const FBltFuzzPlanHandle& Handle)
+{
+	FScopeLock ScopeLock(&Lock);
+
+	FBltFuzzPlanPtr Plan;
+	if (!Plans.RemoveAndCopyValue(Handle.Id, Plan))
+		return;
+
+	Iterations.Remove(Handle.Id);
+	HandlesByPath.Remove(Plan->GetSourcePath());
+}
+
+FBltFuzzPlanPtr FBltFuzzPlanRegistry::Find(const FBltFuzzPlanHandle& Handle) const
+{
+	FScopeLock ScopeLock(&Lock);
+
+	const FBltFuzzPlanPtr* const Plan = Plans.Find(Handle.Id);
+	return Plan ? *Plan : FBltFuzzPlanPtr();
+}
+
+FBltFuzzPlanHandle FBltFuzzPlanRegistry::FindByPath(const FString& SourcePath) const
+{
+	FScopeLock ScopeLock(&Lock);
+
+	FBltFuzzPlanHandle Handle;
+	if (const int32* const Id = HandlesByPath.Find(SourcePath))
+	{
+		Handle.Id = *Id;
+	}
+
+	return Handle;
+}
+
+int32 FBltFuzzPlanRegistry::AdvanceIteration(const FBltFuzzPlanHandle& Handle)
+{
+	FScopeLock ScopeLock(&Lock);
+
+	return Iterations.FindOrAdd(Handle.Id)++;
+}
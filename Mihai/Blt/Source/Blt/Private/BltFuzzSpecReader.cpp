@@ -0,0 +1,739 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "BltFuzzSpecReader.h"
+
+#include "BltBPLibrary.h"
+#include "BltStats.h"
+
+
+namespace
+{
+	bool IsNumberChar(const int32 Char)
+	{
+		return (Char >= '0' && Char <= '9') || Char == '-' || Char == '+' || Char == '.' || Char == 'e' || Char == 'E';
+	}
+
+	int32 HexValue(const int32 Char)
+	{
+		if (Char >= '0' && Char <= '9')
+			return Char - '0';
+
+		if (Char >= 'a' && Char <= 'f')
+			return Char - 'a' + 10;
+
+		if (Char >= 'A' && Char <= 'F')
+			return Char - 'A' + 10;
+
+		return INDEX_NONE;
+	}
+
+	void AppendUtf8(TArray<ANSICHAR>& Bytes, const uint32 CodePoint)
+	{
+		if (CodePoint < 0x80u)
+		{
+			Bytes.Add(static_cast<ANSICHAR>(CodePoint));
+		}
+		else if (CodePoint < 0x800u)
+		{
+			Bytes.Add(static_cast<ANSICHAR>(0xC0u | CodePoint >> 6u));
+			Bytes.Add(static_cast<ANSICHAR>(0x80u | (CodePoint & 0x3Fu)));
+		}
+		else if (CodePoint < 0x10000u)
+		{
+			Bytes.Add(static_cast<ANSICHAR>(0xE0u | CodePoint >> 12u));
+			Bytes.Add(static_cast<ANSICHAR>(0x80u | (CodePoint >> 6u & 0x3Fu)));
+			Bytes.Add(static_cast<ANSICHAR>(0x80u | (CodePoint & 0x3Fu)));
+		}
+		else
+		{
+			Bytes.Add(static_cast<ANSICHAR>(0xF0u | CodePoint >> 18u));
+			Bytes.Add(static_cast<ANSICHAR>(0x80u | (CodePoint >> 12u & 0x3Fu)));
+			Bytes.Add(static_cast<ANSICHAR>(0x80u | (CodePoint >> 6u & 0x3Fu)));
+			Bytes.Add(static_cast<ANSICHAR>(0x80u | (CodePoint & 0x3Fu)));
+		}
+	}
+}
+
+
+bool FBltFuzzSpecReader::ReadFile(const FString& FilePath, TArray<FBltFuzzClassSpec>& OutClasses)
+{
+	BLT_SCOPE_CYCLE_COUNTER(STAT_BltSpecLoad);
+
+	const TUniquePtr<FArchive> Archive(IFileManager::Get().CreateFileReader(*FilePath));
+	if (!Archive)
+	{
+		UE_LOG(LogBlt, Error, TEXT("Could not open %s"), *FilePath);
+		return false;
+	}
+
+	FBltFuzzSpecReader Reader(*Archive);
+	if (!Reader.Read(OutClasses))
+	{
+		UE_LOG(LogBlt, Error, TEXT("Could not deserialize %s [check if file is JSON]"), *FilePath);
+		return false;
+	}
+
+	return true;
+}
+
+FBltFuzzSpecReader::FBltFuzzSpecReader(FArchive& InArchive)
+	: Archive(InArchive)
+{
+	Window.SetNumUninitialized(WindowSize);
+}
+
+bool FBltFuzzSpecReader::Read(TArray<FBltFuzzClassSpec>& OutClasses)
+{
+	// UTF-8 byte order mark
+	if (Peek() == 0xEF)
+	{
+		Next();
+		if (Next() != 0xBB || Next() != 0xBF)
+			return Fail(TEXT("only UTF-8 files are supported"));
+	}
+
+	// Repeated class keys merge into one entry, a property named again replacing the earlier one
+	TMap<FString, int32> ClassIndices;
+
+	SkipWhitespace();
+	if (!Consume('{'))
+		return Fail(TEXT("expected an object at the top level"));
+
+	SkipWhitespace();
+	if (Consume('}'))
+		return true;
+
+	FString ClassName;
+	do
+	{
+		SkipWhitespace();
+		if (!ReadString(ClassName))
+			return false;
+
+		SkipWhitespace();
+		if (!Consume(':'))
+			return Fail(TEXT("expected ':' after a class name"));
+
+		SkipWhitespace();
+		if (Peek() != '{')
+		{
+			UE_LOG(LogBlt, Error, TEXT("Entry %s must have an Object type value!"), *ClassName);
+			if (!SkipValue())
+				return false;
+		}
+		else
+		{
+			const int32* const ExistingIndex = ClassIndices.Find(ClassName);
+			FBltFuzzClassSpec& ClassSpec = ExistingIndex ? OutClasses[*ExistingIndex] : OutClasses.AddDefaulted_GetRef();
+			if (!ExistingIndex)
+			{
+				ClassIndices.Add(ClassName, OutClasses.Num() - 1);
+				ClassSpec.ClassName = ClassName;
+			}
+
+			SourceHash = 2166136261u;
+			if (!ReadClass(ClassSpec))
+				return false;
+
+			ClassSpec.SourceHash = ExistingIndex ? HashCombine(ClassSpec.SourceHash, SourceHash) : SourceHash;
+		}
+
+		SkipWhitespace();
+	}
+	while (Consume(','));
+
+	if (!Consume('}'))
+		return Fail(TEXT("expected ',' or '}' after a class entry"));
+
+	SkipWhitespace();
+	if (Peek() != INDEX_NONE)
+		return Fail(TEXT("unexpected data after the top level object"));
+
+	return true;
+}
+
+bool FBltFuzzSpecReader::ReadClass(FBltFuzzClassSpec& ClassSpec)
+{
+	Consume('{');
+
+	SkipWhitespace();
+	if (Consume('}'))
+		return true;
+
+	FString PropertyName;
+	do
+	{
+		SkipWhitespace();
+		if (!ReadString(PropertyName))
+			return false;
+
+		SkipWhitespace();
+		if (!Consume(':'))
+			return Fail(TEXT("expected ':' after a property name"));
+
+		SkipWhitespace();
+
+		FBltFuzzPropertySpec PropertySpec;
+		PropertySpec.PropertyName = FName(*PropertyName);
+
+		bool bValid = false;
+		if (!ReadProperty(ClassSpec.ClassName, PropertySpec, bValid))
+			return false;
+
+		if (bValid)
+		{
+			ClassSpec.Properties.Add(PropertySpec.PropertyName, MoveTemp(PropertySpec));
+		}
+
+		SkipWhitespace();
+	}
+	while (Consume(','));
+
+	if (!Consume('}'))
+		return Fail(TEXT("expected ',' or '}' after a property entry"));
+
+	return true;
+}
+
+bool FBltFuzzSpecReader::ReadProperty(const FString& ClassName, FBltFuzzPropertySpec& PropertySpec, bool& bOutValid)
+{
+	switch (Peek())
+	{
+	case '[':
+		if (!ReadInterval(PropertySpec.Min, PropertySpec.Max, bOutValid))
+			return false;
+
+		if (!bOutValid)
+		{
+			UE_LOG(LogBlt, Error, TEXT("%s.%s must be a [min, max] interval!"), *ClassName, *PropertySpec.PropertyName.ToString());
+		}
+
+		PropertySpec.Source = EBltFuzzRangeSource::Interval;
+		return true;
+
+	case '"':
+		PropertySpec.Source = EBltFuzzRangeSource::Regex;
+		bOutValid = true;
+		return ReadString(PropertySpec.Regex);
+
+	case '{':
+		return ReadObjectEntry(ClassName + TEXT(".") + PropertySpec.PropertyName.ToString(), PropertySpec, bOutValid);
+
+	default:
+		UE_LOG(LogBlt, Warning, TEXT("%s.%s has an unsupported value type"), *ClassName, *PropertySpec.PropertyName.ToString());
+		return SkipValue();
+	}
+}
+
+bool FBltFuzzSpecReader::ReadInterval(double& OutMin, double& OutMax, bool& bOutValid)
+{
+	Consume('[');
+
+	int32 Count = 0;
+	bool bAllNumbers = true;
+
+	SkipWhitespace();
+	if (!Consume(']'))
+	{
+		do
+		{
+			SkipWhitespace();
+
+			const int32 Char = Peek();
+			if (Char == '-' || (Char >= '0' && Char <= '9'))
+			{
+				double Number;
+				if (!ReadNumber(Number))
+					return false;
+
+				if (Count < 2)
+				{
+					(Count == 0 ? OutMin : OutMax) = Number;
+				}
+			}
+			else
+			{
+				bAllNumbers = false;
+				if (!SkipValue(1))
+					return false;
+			}
+
+			++Count;
+			SkipWhitespace();
+		}
+		while (Consume(','));
+
+		if (!Consume(']'))
+			return Fail(TEXT("expected ',' or ']' inside an interval"));
+	}
+
+	bOutValid = bAllNumbers && Count == 2;
+	return true;
+}
+
+bool FBltFuzzSpecReader::ReadObjectEntry(const FString& EntryName, FBltFuzzPropertySpec& PropertySpec, bool& bOutValid)
+{
+	Consume('{');
+	bOutValid = true;
+
+	SkipWhitespace();
+	if (Consume('}'))
+		return true;
+
+	// Semantic checks of distributions are left to FBltValueDistribution::Compile, which knows the property type
+	FBltFuzzDistributionSpec& OutSpec = PropertySpec.Distribution;
+	FString Key;
+	do
+	{
+		SkipWhitespace();
+		if (!ReadString(Key))
+			return false;
+
+		SkipWhitespace();
+		if (!Consume(':'))
+			return Fail(TEXT("expected ':' after an entry field"));
+
+		SkipWhitespace();
+
+		bool bFieldValid = true;
+		if (Key == TEXT("Strategy") || Key == TEXT("Regex"))
+		{
+			FString Text;
+			if (Peek() != '"' || !ReadString(Text))
+				return Fail(TEXT("expected a string"));
+
+			if (Key == TEXT("Regex"))
+			{
+				PropertySpec.Source = EBltFuzzRangeSource::Regex;
+				PropertySpec.Regex = MoveTemp(Text);
+			}
+			else if (Text == TEXT("Sample") || Text == TEXT("Mutate"))
+			{
+				PropertySpec.Strategy = Text == TEXT("Sample") ? EBltFuzzStrategy::Sample : EBltFuzzStrategy::Mutate;
+			}
+			else
+			{
+				bFieldValid = false;
+			}
+		}
+		else if ((Key == TEXT("Range") || Key == TEXT("Buckets")) && Peek() != '[')
+		{
+			bFieldValid = false;
+			if (!SkipValue(1))
+				return false;
+		}
+		else if (Key == TEXT("Range"))
+		{
+			FBltFuzzBucketSpec Bucket;
+			if (!ReadInterval(Bucket.Min, Bucket.Max, bFieldValid))
+				return false;
+
+			OutSpec.Buckets.Add(Bucket);
+		}
+		else if (Key == TEXT("Buckets"))
+		{
+			Consume('[');
+			SkipWhitespace();
+			if (!Consume(']'))
+			{
+				do
+				{
+					SkipWhitespace();
+
+					TArray<double, TInlineAllocator<4>> Numbers;
+					bool bBucketValid = false;
+					if (!ReadNumbers(Numbers, bBucketValid))
+						return false;
+
+					if (bBucketValid && Numbers.Num() == 3)
+					{
+						OutSpec.Buckets.Add({ Numbers[0], Numbers[1], Numbers[2] });
+					}
+					else
+					{
+						bFieldValid = false;
+					}
+
+					SkipWhitespace();
+				}
+				while (Consume(','));
+
+				if (!Consume(']'))
+					return Fail(TEXT("expected ',' or ']' inside the buckets"));
+			}
+		}
+		else if (Key == TEXT("Scale"))
+		{
+			FString Scale;
+			if (Peek() != '"' || !ReadString(Scale))
+				return Fail(TEXT("expected Log or Linear"));
+
+			OutSpec.bLogScale = Scale == TEXT("Log");
+			if (!OutSpec.bLogScale && Scale != TEXT("Linear"))
+			{
+				UE_LOG(LogBlt, Warning, TEXT("%s.Scale must be Log or Linear"), *EntryName);
+			}
+		}
+		else if (Key == TEXT("Edges"))
+		{
+			if (!ReadEdges(OutSpec.Edges, bFieldValid))
+				return false;
+		}
+		else if (Key == TEXT("EdgeRate") || Key == TEXT("Boundaries"))
+		{
+			if (!ReadNumber(Key == TEXT("EdgeRate") ? OutSpec.EdgeRate : OutSpec.BoundaryRate))
+				return false;
+		}
+		else if (Key == TEXT("NamePool"))
+		{
+			double Size = 0.0;
+			if (!ReadNumber(Size))
+				return false;
+
+			PropertySpec.NamePoolSize = static_cast<int32>(Size);
+		}
+		else if (Key == TEXT("FuzzUnlisted"))
+		{
+			// SkipValue takes the true or false literal
+			const int32 Char = Peek();
+			bFieldValid = Char == 't' || Char == 'f';
+			PropertySpec.bFuzzUnlisted = Char != 'f';
+			if (!SkipValue(1))
+				return false;
+		}
+		else
+		{
+			UE_LOG(LogBlt, Warning, TEXT("%s.%s is not an entry field"), *EntryName, *Key);
+			if (!SkipValue(1))
+				return false;
+		}
+
+		if (!bFieldValid)
+		{
+			UE_LOG(LogBlt, Error, TEXT("%s.%s is malformed!"), *EntryName, *Key);
+			bOutValid = false;
+		}
+
+		SkipWhitespace();
+	}
+	while (Consume(','));
+
+	if (!Consume('}'))
+		return Fail(TEXT("expected ',' or '}' after an entry field"));
+
+	FBltFuzzPlan::ClassifyObjectEntry(PropertySpec);
+	return true;
+}
+
+bool FBltFuzzSpecReader::ReadNumbers(TArray<double, TInlineAllocator<4>>& OutNumbers, bool& bOutValid)
+{
+	bOutValid = Peek() == '[';
+	if (!bOutValid)
+		return SkipValue(1);
+
+	Consume('[');
+	SkipWhitespace();
+	if (Consume(']'))
+		return true;
+
+	do
+	{
+		SkipWhitespace();
+
+		const int32 Char = Peek();
+		if (Char == '-' || (Char >= '0' && Char <= '9'))
+		{
+			double Number;
+			if (!ReadNumber(Number))
+				return false;
+
+			OutNumbers.Add(Number);
+		}
+		else
+		{
+			bOutValid = false;
+			if (!SkipValue(1))
+				return false;
+		}
+
+		SkipWhitespace();
+	}
+	while (Consume(','));
+
+	return Consume(']') || Fail(TEXT("expected ',' or ']' inside an array of numbers"));
+}
+
+bool FBltFuzzSpecReader::ReadEdges(TArray<FBltFuzzEdgeSpec>& OutEdges, bool& bOutValid)
+{
+	bOutValid = Peek() == '[';
+	if (!bOutValid)
+		return SkipValue(1);
+
+	Consume('[');
+	SkipWhitespace();
+	if (Consume(']'))
+		return true;
+
+	FString Name;
+	do
+	{
+		SkipWhitespace();
+
+		const int32 Char = Peek();
+		if (Char == '"')
+		{
+			if (!ReadString(Name))
+				return false;
+
+			FBltFuzzPlan::DecodeEdgeString(Name, OutEdges.AddDefaulted_GetRef());
+		}
+		else if (Char == '-' || (Char >= '0' && Char <= '9'))
+		{
+			if (!ReadNumber(OutEdges.AddDefaulted_GetRef().Value))
+				return false;
+		}
+		else
+		{
+			bOutValid = false;
+			if (!SkipValue(1))
+				return false;
+		}
+
+		SkipWhitespace();
+	}
+	while (Consume(','));
+
+	return Consume(']') || Fail(TEXT("expected ',' or ']' inside the edges"));
+}
+
+bool FBltFuzzSpecReader::ReadString(FString& OutString)
+{
+	if (!Consume('"'))
+		return Fail(TEXT("expected a string"));
+
+	Scratch.Reset();
+	for (;;)
+	{
+		const int32 Char = Next();
+		if (Char == '"')
+			break;
+
+		if (Char == INDEX_NONE)
+			return Fail(TEXT("unterminated string"));
+
+		if (Char < 0x20)
+			return Fail(TEXT("control character inside a string"));
+
+		if (Char == '\\')
+		{
+			if (!ReadEscape())
+				return false;
+		}
+		else
+		{
+			Scratch.Add(static_cast<ANSICHAR>(Char));
+		}
+	}
+
+	const FUTF8ToTCHAR Converted(Scratch.GetData(), Scratch.Num());
+	OutString = FString(Converted.Length(), Converted.Get());
+	return true;
+}
+
+bool FBltFuzzSpecReader::ReadEscape()
+{
+	const int32 Escape = Next();
+	switch (Escape)
+	{
+	case '"':
+	case '\\':
+	case '/':
+		Scratch.Add(static_cast<ANSICHAR>(Escape));
+		return true;
+
+	case 'b': Scratch.Add('\b'); return true;
+	case 'f': Scratch.Add('\f'); return true;
+	case 'n': Scratch.Add('\n'); return true;
+	case 'r': Scratch.Add('\r'); return true;
+	case 't': Scratch.Add('\t'); return true;
+
+	case 'u':
+	{
+		const auto ReadCodeUnit = [this](uint32& OutUnit)
+		{
+			OutUnit = 0u;
+			for (int32 Digit = 0; Digit < 4; ++Digit)
+			{
+				const int32 Value = HexValue(Next());
+				if (Value == INDEX_NONE)
+					return false;
+
+				OutUnit = OutUnit << 4u | static_cast<uint32>(Value);
+			}
+			return true;
+		};
+
+		uint32 CodePoint;
+		if (!ReadCodeUnit(CodePoint))
+			return Fail(TEXT("invalid \\u escape"));
+
+		if (CodePoint >= 0xD800u && CodePoint <= 0xDBFFu)
+		{
+			uint32 LowSurrogate;
+			if (Next() != '\\' || Next() != 'u' || !ReadCodeUnit(LowSurrogate)
+				|| LowSurrogate < 0xDC00u || LowSurrogate > 0xDFFFu)
+			{
+				return Fail(TEXT("unpaired UTF-16 surrogate"));
+			}
+
+			CodePoint = 0x10000u + ((CodePoint - 0xD800u) << 10u) + (LowSurrogate - 0xDC00u);
+		}
+
+		AppendUtf8(Scratch, CodePoint);
+		return true;
+	}
+
+	default:
+		return Fail(TEXT("invalid escape sequence"));
+	}
+}
+
+bool FBltFuzzSpecReader::ReadNumber(double& OutNumber)
+{
+	ANSICHAR Digits[64];
+	int32 Length = 0;
+	while (IsNumberChar(Peek()))
+	{
+		if (Length == UE_ARRAY_COUNT(Digits) - 1)
+			return Fail(TEXT("number too long"));
+
+		Digits[Length++] = static_cast<ANSICHAR>(Next());
+	}
+
+	Digits[Length] = '\0';
+	if (Length == 0)
+		return Fail(TEXT("expected a number"));
+
+	OutNumber = FCStringAnsi::Atod(Digits);
+	return true;
+}
+
+bool FBltFuzzSpecReader::SkipValue(const int32 Depth)
+{
+	if (Depth > MaxDepth)
+		return Fail(TEXT("nesting too deep"));
+
+	const int32 Char = Peek();
+	if (Char == '{' || Char == '[')
+	{
+		const ANSICHAR Close = Char == '{' ? '}' : ']';
+		Next();
+
+		SkipWhitespace();
+		if (Consume(Close))
+			return true;
+
+		do
+		{
+			SkipWhitespace();
+			if (Char == '{')
+			{
+				FString Key;
+				if (!ReadString(Key))
+					return false;
+
+				SkipWhitespace();
+				if (!Consume(':'))
+					return Fail(TEXT("expected ':' after a key"));
+
+				SkipWhitespace();
+			}
+
+			if (!SkipValue(Depth + 1))
+				return false;
+
+			SkipWhitespace();
+		}
+		while (Consume(','));
+
+		return Consume(Close) || Fail(TEXT("unterminated object or array"));
+	}
+
+	if (Char == '"')
+	{
+		FString Ignored;
+		return ReadString(Ignored);
+	}
+
+	if (IsNumberChar(Char))
+	{
+		double Ignored;
+		return ReadNumber(Ignored);
+	}
+
+	// true, false and null
+	int32 Length = 0;
+	while (Peek() >= 'a' && Peek() <= 'z')
+	{
+		Next();
+		++Length;
+	}
+
+	return Length > 0 || Fail(TEXT("unexpected character"));
+}
+
+int32 FBltFuzzSpecReader::Peek()
+{
+	if (Position == Size && !Refill())
+		return INDEX_NONE;
+
+	return Window[Position];
+}
+
+int32 FBltFuzzSpecReader::Next()
+{
+	const int32 Char = Peek();
+	if (Char != INDEX_NONE)
+	{
+		++Position;
+		Line += Char == '\n';
+		SourceHash = (SourceHash ^ static_cast<uint32>(Char)) * 16777619u;
+	}
+
+	return Char;
+}
+
+bool FBltFuzzSpecReader::Refill()
+{
+	const int64 Remaining = Archive.TotalSize() - Archive.Tell();
+	if (Remaining <= 0 || Archive.IsError())
+		return false;
+
+	Size = static_cast<int32>(FMath::Min<int64>(Remaining, WindowSize));
+	Position = 0;
+	Archive.Serialize(Window.GetData(), Size);
+	return !Archive.IsError();
+}
+
+void FBltFuzzSpecReader::SkipWhitespace()
+{
+	for (int32 Char = Peek(); Char == ' ' || Char == '\t' || Char == '\n' || Char == '\r'; Char = Peek())
+	{
+		Next();
+	}
+}
+
+bool FBltFuzzSpecReader::Consume(const ANSICHAR Expected)
+{
+	if (Peek() != Expected)
+		return false;
+
+	Next();
+	return true;
+}
+
+bool FBltFuzzSpecReader::Fail(const TCHAR* const Message)
+{
+	UE_LOG(LogBlt, Error, TEXT("Fuzz spec line %d: %s"), Line, Message);
+	return false;
+}
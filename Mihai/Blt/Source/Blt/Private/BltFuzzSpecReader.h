@@ -0,0 +1,55 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "BltFuzzPlan.h"
+
+
+// Pull parser turning a fuzz spec straight into FBltFuzzClassSpec entries. The file is read through
+// a fixed window, UTF-8 is only decoded for keys and regexes, and numbers are converted as they are
+// scanned, so memory stays at one window plus the decoded specs whatever the size of the file.
+class FBltFuzzSpecReader
+{
+public:
+	static bool ReadFile(const FString& FilePath, TArray<FBltFuzzClassSpec>& OutClasses);
+
+	explicit FBltFuzzSpecReader(FArchive& InArchive);
+
+	bool Read(TArray<FBltFuzzClassSpec>& OutClasses);
+
+private:
+	static constexpr int32 WindowSize = 64 * 1024;
+	static constexpr int32 MaxDepth = 256;
+
+	int32 Peek();
+	int32 Next();
+	bool Refill();
+	void SkipWhitespace();
+	bool Consume(const ANSICHAR Expected);
+
+	bool ReadClass(FBltFuzzClassSpec& ClassSpec);
+	bool ReadProperty(const FString& ClassName, FBltFuzzPropertySpec& PropertySpec, bool& bOutValid);
+	bool ReadInterval(double& OutMin, double& OutMax, bool& bOutValid);
+	bool ReadObjectEntry(const FString& EntryName, FBltFuzzPropertySpec& PropertySpec, bool& bOutValid);
+	bool ReadNumbers(TArray<double, TInlineAllocator<4>>& OutNumbers, bool& bOutValid);
+	bool ReadEdges(TArray<FBltFuzzEdgeSpec>& OutEdges, bool& bOutValid);
+
+	bool ReadString(FString& OutString);
+	bool ReadNumber(double& OutNumber);
+	bool ReadEscape();
+	bool SkipValue(const int32 Depth = 0);
+
+	bool Fail(const TCHAR* const Message);
+
+	FArchive& Archive;
+	TArray<uint8> Window;
+	int32 Position = 0;
+	int32 Size = 0;
+	int32 Line = 1;
+
+	// FNV-1a of everything consumed since the last reset, used to fingerprint class entries
+	uint32 SourceHash = 0u;
+
+	// UTF-8 bytes of the string being read, reused for every string of the file
+	TArray<ANSICHAR> Scratch;
+};
@@ -0,0 +1,81 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "BltFuzzSpecWatcher.h"
+
+#include "BltBPLibrary.h"
+
+#if WITH_EDITOR
+#include "DirectoryWatcherModule.h"
+#include "IDirectoryWatcher.h"
+#endif
+
+
+FBltFuzzSpecWatcher& FBltFuzzSpecWatcher::Get()
+{
+	static FBltFuzzSpecWatcher Watcher;
+	return Watcher;
+}
+
+void FBltFuzzSpecWatcher::Watch(const FString& Directory)
+{
+#if WITH_EDITOR
+	const FString FullDirectory = FPaths::ConvertRelativePathToFull(Directory);
+	if (WatchedDirectories.Contains(FullDirectory))
+		return;
+
+	FDirectoryWatcherModule& DirectoryWatcherModule = FModuleManager::LoadModuleChecked<FDirectoryWatcherModule>(TEXT("DirectoryWatcher"));
+	IDirectoryWatcher* const DirectoryWatcher = DirectoryWatcherModule.Get();
+	if (!DirectoryWatcher)
+		return;
+
+	FDelegateHandle Handle;
+	DirectoryWatcher->RegisterDirectoryChangedCallback_Handle(
+		FullDirectory,
+		IDirectoryWatcher::FDirectoryChanged::CreateRaw(this, &FBltFuzzSpecWatcher::OnDirectoryChanged),
+		Handle
+	);
+
+	WatchedDirectories.Add(FullDirectory, Handle);
+#endif
+}
+
+void FBltFuzzSpecWatcher::UnwatchAll()
+{
+#if WITH_EDITOR
+	FDirectoryWatcherModule* const DirectoryWatcherModule = FModuleManager::GetModulePtr<FDirectoryWatcherModule>(TEXT("DirectoryWatcher"));
+	IDirectoryWatcher* const DirectoryWatcher = DirectoryWatcherModule ? DirectoryWatcherModule->Get() : nullptr;
+	if (DirectoryWatcher)
+	{
+		for (const TPair<FString, FDelegateHandle>& Directory : WatchedDirectories)
+		{
+			DirectoryWatcher->UnregisterDirectoryChangedCallback_Handle(Directory.Key, Directory.Value);
+		}
+	}
+#endif
+
+	WatchedDirectories.Empty();
+}
+
+void FBltFuzzSpecWatcher::OnDirectoryChanged(const TArray<FFileChangeData>& Changes)
+{
+#if WITH_EDITOR
+	// Editors usually save through several events, every file is reloaded once per batch
+	TSet<FString> ChangedPlans;
+	for (const FFileChangeData& Change : Changes)
+	{
+		if (Change.Action == FFileChangeData::FCA_Removed)
+			continue;
+
+		const FString FilePath = FPaths::ConvertRelativePathToFull(Change.Filename);
+		if (FBltFuzzPlanRegistry::Get().FindByPath(FilePath).IsValid())
+		{
+			ChangedPlans.Add(FilePath);
+		}
+	}
+
+	for (const FString& FilePath : ChangedPlans)
+	{
+		UBltBPLibrary::ReloadFuzzPlan(FilePath);
+	}
+#endif
+}
@@ -0,0 +1,20 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+
+// Reloads registered fuzz plans when their spec file changes on disk. Directory watching only
+// exists in editor builds; elsewhere plans stay as first loaded.
+class FBltFuzzSpecWatcher
+{
+public:
+	static FBltFuzzSpecWatcher& Get();
+
+	void Watch(const FString& Directory);
+	void UnwatchAll();
+
+private:
+	void OnDirectoryChanged(const TArray<struct FFileChangeData>& Changes);
+
+	TMap<FString, FDelegateHandle> WatchedDirectories;
+};
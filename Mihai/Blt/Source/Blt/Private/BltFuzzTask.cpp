@@ -0,0 +1,134 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "BltFuzzTask.h"
+
+#include "BltActorIndex.h"
+#include "BltBPLibrary.h"
+#include "BltMutationJournal.h"
+#include "BltRandom.h"
+
+
+FBltFuzzTask::FBltFuzzTask(
+	const UObject* const WorldContextObject,
+	const FBltFuzzPlanPtr& InPlan,
+	const FBltFuzzPass& InPass,
+	const TArray<AActor*>& AffectedActors,
+	const bool bUseArray
+)
+	: Plan(InPlan)
+	, Pass(InPass)
+{
+	check(Plan);
+
+	for (AActor* const Actor : UBltBPLibrary::GatherFuzzTargets(WorldContextObject, *Plan, AffectedActors, bUseArray))
+	{
+		if (Plan->FindOrResolveActorPlan(Actor->GetClass()))
+		{
+			Targets.Add(Actor);
+		}
+	}
+
+	TotalActors = Targets.Num();
+}
+
+FBltFuzzTask::~FBltFuzzTask()
+{
+	if (TickerHandle.IsValid())
+	{
+		FTicker::GetCoreTicker().RemoveTicker(TickerHandle);
+	}
+}
+
+void FBltFuzzTask::Start(const float InBudgetMilliseconds)
+{
+	BudgetSeconds = FMath::Max(InBudgetMilliseconds, 0.f) / 1000.0;
+	if (TickerHandle.IsValid())
+		return;
+
+	SelfReference = AsShared();
+	TickerHandle = FTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateSP(this, &FBltFuzzTask::Tick));
+}
+
+void FBltFuzzTask::Cancel()
+{
+	if (TickerHandle.IsValid())
+	{
+		FTicker::GetCoreTicker().RemoveTicker(TickerHandle);
+		TickerHandle.Reset();
+	}
+
+	SelfReference.Reset();
+}
+
+bool FBltFuzzTask::Step(const double InBudgetSeconds)
+{
+	const double EndTime = FPlatformTime::Seconds() + InBudgetSeconds;
+
+	// At least one property per step, so a zero budget still makes progress
+	bool bFirstProperty = true;
+	while (!IsDone())
+	{
+		// Actors destroyed between frames are skipped, the plan is looked up again since a
+		// recompile in between may have replaced it
+		AActor* const Actor = Targets[ActorIndex].Get();
+		const FBltFuzzClassPlan* const ClassPlan = Actor ? Plan->FindOrResolveActorPlan(Actor->GetClass()) : nullptr;
+
+		if (ClassPlan)
+		{
+			// The properties of a replaced plan can sit at other indices, the paths already mutated tell them apart
+			if (PropertyIndex > 0 && ClassPlan->SchemaGeneration != PlanGeneration)
+			{
+				PropertyIndex = 0;
+				bPlanReplaced = true;
+			}
+			PlanGeneration = ClassPlan->SchemaGeneration;
+
+			const uint32 ActorId = FBltRandomStream::HashObject(Actor);
+			while (PropertyIndex < ClassPlan->Properties.Num())
+			{
+				if (!bFirstProperty && FPlatformTime::Seconds() >= EndTime)
+					return false;
+
+				const FBltFuzzPropertyPlan& PropertyPlan = ClassPlan->Properties[PropertyIndex++];
+				if (bPlanReplaced && MutatedPaths.Contains(PropertyPlan.PathName))
+					continue;
+
+				UBltBPLibrary::RandomiseProperty(Actor, PropertyPlan, Pass, ActorId);
+				MutatedPaths.Add(PropertyPlan.PathName);
+				bFirstProperty = false;
+			}
+		}
+
+		++ActorIndex;
+		++ProcessedActors;
+		PropertyIndex = 0;
+		MutatedPaths.Reset();
+		bPlanReplaced = false;
+	}
+
+	return true;
+}
+
+bool FBltFuzzTask::Tick(const float DeltaTime)
+{
+	const bool bDone = Step(BudgetSeconds);
+	OnProgress.ExecuteIfBound(ProcessedActors, TotalActors);
+
+	if (!bDone)
+		return true;
+
+	Finish();
+	return false;
+}
+
+void FBltFuzzTask::Finish()
+{
+	UE_LOG(LogBlt, Log, TEXT("Time sliced fuzzing of %s done, %d actors"), *Plan->GetSourcePath(), ProcessedActors);
+
+	// Returning false from Tick already removes the ticker
+	TickerHandle.Reset();
+
+	const TSharedPtr<FBltFuzzTask> KeepAlive = MoveTemp(SelfReference);
+	FBltMutationJournal::Get().ShowSummary();
+	OnCompleted.ExecuteIfBound(ProcessedActors, TotalActors);
+}
@@ -0,0 +1,122 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "BltFuzzWorld.h"
+
+#include "BltBPLibrary.h"
+#include "Containers/Ticker.h"
+#include "Engine/Engine.h"
+#include "Engine/GameInstance.h"
+#include "Engine/World.h"
+#include "GameMapsSettings.h"
+
+
+TUniquePtr<FBltFuzzWorld> FBltFuzzWorld::Create(const FString& MapName, const int32 InstanceIndex)
+{
+	UPackage* const Package = LoadMapPackage(MapName, InstanceIndex);
+	UWorld* const World = Package ? UWorld::FindWorldInPackage(Package) : nullptr;
+	if (!World)
+	{
+		UE_LOG(LogBlt, Error, TEXT("Map %s could not be loaded!"), *MapName);
+		return nullptr;
+	}
+
+	UClass* GameInstanceClass = GetDefault<UGameMapsSettings>()->GameInstanceClass.TryLoadClass<UGameInstance>();
+	if (!GameInstanceClass)
+	{
+		GameInstanceClass = UGameInstance::StaticClass();
+	}
+
+	// The standalone instance comes with an empty world of its own, which the map replaces
+	UGameInstance* const GameInstance = NewObject<UGameInstance>(GEngine, GameInstanceClass);
+	GameInstance->AddToRoot();
+	GameInstance->InitializeStandalone();
+
+	FWorldContext* const WorldContext = GameInstance->GetWorldContext();
+	UWorld* const PlaceholderWorld = WorldContext->World();
+	WorldContext->SetCurrentWorld(World);
+	PlaceholderWorld->DestroyWorld(false);
+
+	World->AddToRoot();
+	World->WorldType = EWorldType::Game;
+	World->SetGameInstance(GameInstance);
+#if WITH_EDITOR
+	if (InstanceIndex > 0)
+	{
+		World->StreamingLevelsPrefix = UWorld::BuildPIEPackagePrefix(InstanceIndex);
+	}
+#endif
+	World->InitWorld();
+
+	FURL URL;
+	URL.Map = MapName;
+	World->SetGameMode(URL);
+	World->InitializeActorsForPlay(URL);
+	World->BeginPlay();
+
+	UE_LOG(LogBlt, Log, TEXT("Loaded %s as instance %d for headless fuzzing"), *MapName, InstanceIndex);
+	return TUniquePtr<FBltFuzzWorld>(new FBltFuzzWorld(GameInstance, World, InstanceIndex));
+}
+
+FBltFuzzWorld::FBltFuzzWorld(UGameInstance* const InGameInstance, UWorld* const InWorld, const int32 InInstanceIndex)
+	: GameInstance(InGameInstance)
+	, World(InWorld)
+	, InstanceIndex(InInstanceIndex)
+{
+}
+
+UPackage* FBltFuzzWorld::LoadMapPackage(const FString& MapName, const int32 InstanceIndex)
+{
+	if (InstanceIndex == 0)
+		return LoadPackage(nullptr, *MapName, LOAD_None);
+
+#if WITH_EDITOR
+	const FString InstancePackageName = UWorld::ConvertToPIEPackageName(MapName, InstanceIndex);
+	UPackage* const InstancePackage = CreatePackage(*InstancePackageName);
+	InstancePackage->SetPackageFlags(PKG_PlayInEditor);
+	InstancePackage->SetPIEInstanceID(InstanceIndex);
+	FSoftObjectPath::AddPIEPackageName(*InstancePackageName);
+
+	return LoadPackage(InstancePackage, *MapName, LOAD_PackageForPIE);
+#else
+	UE_LOG(LogBlt, Error, TEXT("More than one world per map needs an editor build"));
+	return nullptr;
+#endif
+}
+
+FBltFuzzWorld::~FBltFuzzWorld()
+{
+	World->BeginTearingDown();
+
+	// The game instance context would otherwise stay in GEngine's list, pointing at a destroyed world
+	GEngine->DestroyWorldContext(World);
+	GameInstance->Shutdown();
+	World->DestroyWorld(false);
+
+	World->RemoveFromRoot();
+	GameInstance->RemoveFromRoot();
+	CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+}
+
+void FBltFuzzWorld::Tick(const float DeltaSeconds)
+{
+	// Gameplay code still reaches for GWorld, and soft paths of instances resolve through the PIE id
+	UWorld* const PreviousWorld = GWorld;
+	GWorld = World;
+#if WITH_EDITOR
+	TGuardValue<int32> InstanceGuard(GPlayInEditorID, InstanceIndex > 0 ? InstanceIndex : GPlayInEditorID);
+#endif
+
+	World->Tick(LEVELTICK_All, DeltaSeconds);
+	GWorld = PreviousWorld;
+}
+
+void FBltFuzzWorld::AdvanceFrame(const float DeltaSeconds)
+{
+	FApp::SetDeltaTime(DeltaSeconds);
+	FApp::SetCurrentTime(FApp::GetCurrentTime() + DeltaSeconds);
+	++GFrameCounter;
+
+	FTicker::GetCoreTicker().Tick(DeltaSeconds);
+	FTaskGraphInterface::Get().ProcessThreadUntilIdle(ENamedThreads::GameThread);
+	GEngine->ConditionalCollectGarbage();
+}
@@ -0,0 +1,36 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+class UGameInstance;
+
+
+// A map loaded into a standalone game world with its own game instance, ticked by whoever owns it
+// instead of by the engine loop. Used by the headless campaigns, where nothing renders and the
+// world advances at a fixed step as fast as the game thread allows. Instances above zero load the
+// map into a renamed package the way PIE instances do, so one process can hold the same map
+// several times without the worlds sharing any object.
+class FBltFuzzWorld
+{
+public:
+	// Null when the map cannot be loaded
+	static TUniquePtr<FBltFuzzWorld> Create(const FString& MapName, const int32 InstanceIndex = 0);
+
+	~FBltFuzzWorld();
+
+	void Tick(const float DeltaSeconds);
+
+	// Everything the engine loop does between world ticks: frame counters, core tickers, game thread tasks and GC
+	static void AdvanceFrame(const float DeltaSeconds);
+
+	UWorld* Get() const { return World; }
+
+private:
+	FBltFuzzWorld(UGameInstance* const InGameInstance, UWorld* const InWorld, const int32 InInstanceIndex);
+
+	static UPackage* LoadMapPackage(const FString& MapName, const int32 InstanceIndex);
+
+	UGameInstance* GameInstance = nullptr;
+	UWorld* World = nullptr;
+	int32 InstanceIndex = 0;
+};
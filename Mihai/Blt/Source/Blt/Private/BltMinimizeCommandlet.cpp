@@ -0,0 +1,48 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "BltMinimizeCommandlet.h"
+
+#include "BltBPLibrary.h"
+#include "BltMinimizer.h"
+
+
+UBltMinimizeCommandlet::UBltMinimizeCommandlet()
+{
+	IsClient = false;
+	IsEditor = false;
+	IsServer = true;
+	LogToConsole = true;
+
+	HelpDescription = TEXT("Minimizes the mutations of a failing fuzz iteration into a small reproducer");
+	HelpUsage = TEXT("-run=BltMinimize -Map=<map> -Spec=<spec> -Iteration=<n> [-Seed=] [-Replay=<entry>] [-Worlds=] [-Processes=] [-TickRate=] [-TicksPerIteration=] [-Output=] [-Parallel]");
+}
+
+int32 UBltMinimizeCommandlet::Main(const FString& Params)
+{
+	FBltFuzzCampaignSettings Settings;
+	if (!Settings.Parse(*Params, false))
+		return 1;
+
+	if (!FParse::Value(*Params, TEXT("Iteration="), Settings.FirstIteration))
+	{
+		UE_LOG(LogBlt, Error, TEXT("Minimizing needs the failing -Iteration="));
+		return 1;
+	}
+	Settings.Iterations = 1;
+
+	FString OutputDirectory;
+	if (!FParse::Value(*Params, TEXT("Output="), OutputDirectory))
+	{
+		Settings.OutputDirectory = FPaths::ConvertRelativePathToFull(
+			FPaths::ProjectSavedDir() / TEXT("Blt") / TEXT("Minimized") / FString::Printf(TEXT("Iteration_%d"), Settings.FirstIteration));
+	}
+
+	int32 WorldCount = 1;
+	FParse::Value(*Params, TEXT("Worlds="), WorldCount);
+
+	int32 ProcessCount = 0;
+	FParse::Value(*Params, TEXT("Processes="), ProcessCount);
+
+	FBltMinimizer Minimizer(Settings, WorldCount, ProcessCount);
+	return Minimizer.Run() ? 0 : 1;
+}
@@ -0,0 +1,21 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "Commandlets/Commandlet.h"
+#include "BltMinimizeCommandlet.generated.h"
+
+
+// Shrinks a failing iteration to the few mutations that still make it fail:
+//   UE4Editor-Cmd <Project> -run=BltMinimize -Map=/Game/Maps/Arena -Spec=Data/fuzzing.json -Seed=7 -Iteration=1234 -Worlds=8 -nullrhi -unattended
+// -Processes=N replays candidates in N BltFuzz processes instead, for iterations that crash
+UCLASS()
+class UBltMinimizeCommandlet final : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UBltMinimizeCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
@@ -0,0 +1,489 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "BltMinimizer.h"
+
+#include "BltActorIndex.h"
+#include "BltBPLibrary.h"
+#include "BltFuzzFailures.h"
+#include "BltFuzzWorld.h"
+#include "BltMutationJournal.h"
+#include "BltPropertyAccess.h"
+#include "BltRandom.h"
+#include "BltWorldCheckpoint.h"
+#include "Dom/JsonObject.h"
+#include "Policies/PrettyJsonPrintPolicy.h"
+#include "Serialization/JsonSerializer.h"
+#include "Serialization/JsonWriter.h"
+
+
+namespace
+{
+	double DecodeNumber(const FBltFuzzValue& Value)
+	{
+		switch (Value.Type)
+		{
+		case EBltFuzzValueType::Int8:   return static_cast<int8>(Value.Bits);
+		case EBltFuzzValueType::Int16:  return static_cast<int16>(Value.Bits);
+		case EBltFuzzValueType::Int32:  return static_cast<int32>(Value.Bits);
+		case EBltFuzzValueType::UInt8:  return static_cast<uint8>(Value.Bits);
+		case EBltFuzzValueType::UInt16: return static_cast<uint16>(Value.Bits);
+		case EBltFuzzValueType::UInt32: return static_cast<uint32>(Value.Bits);
+		case EBltFuzzValueType::UInt64: return static_cast<double>(Value.Bits);
+
+		case EBltFuzzValueType::Float:
+		{
+			float Number = 0.0f;
+			FMemory::Memcpy(&Number, &Value.Bits, sizeof(Number));
+			return Number;
+		}
+
+		case EBltFuzzValueType::Double:
+		{
+			double Number = 0.0;
+			FMemory::Memcpy(&Number, &Value.Bits, sizeof(Number));
+			return Number;
+		}
+
+		default:
+			return static_cast<double>(static_cast<int64>(Value.Bits));
+		}
+	}
+
+	bool IsExactAsDouble(const FBltFuzzValue& Value)
+	{
+		constexpr uint64 Exact = 1ull << 53;
+		switch (Value.Type)
+		{
+		case EBltFuzzValueType::Int64:  return Value.Bits + Exact <= 2 * Exact;
+		case EBltFuzzValueType::UInt64: return Value.Bits <= Exact;
+		default:                        return true;
+		}
+	}
+
+	TSharedRef<FJsonValue> EncodeEdge(const FString& Edge)
+	{
+		const TSharedRef<FJsonObject> Distribution = MakeShared<FJsonObject>();
+		Distribution->SetArrayField(TEXT("Edges"), { MakeShared<FJsonValueString>(Edge) });
+		return MakeShared<FJsonValueObject>(Distribution);
+	}
+
+	// A [v, v] interval, or an edge value for what a JSON number cannot hold
+	TSharedRef<FJsonValue> EncodeNumber(const double Number)
+	{
+		const TCHAR* Edge = nullptr;
+		if (FMath::IsNaN(Number))
+		{
+			Edge = TEXT("NaN");
+		}
+		else if (!FMath::IsFinite(Number))
+		{
+			Edge = Number > 0.0 ? TEXT("Inf") : TEXT("-Inf");
+		}
+		else if (Number == 0.0 && FMath::IsNegativeDouble(Number))
+		{
+			Edge = TEXT("-0");
+		}
+
+		if (!Edge)
+			return MakeShared<FJsonValueArray>(TArray<TSharedPtr<FJsonValue>>{ MakeShared<FJsonValueNumber>(Number), MakeShared<FJsonValueNumber>(Number) });
+
+		return EncodeEdge(Edge);
+	}
+
+	// 64 bit integers a double cannot hold exactly are written as their raw bits
+	TSharedRef<FJsonValue> EncodeValue(const FBltFuzzValue& Value)
+	{
+		if (!IsExactAsDouble(Value))
+			return EncodeEdge(FString::Printf(TEXT("0x%016llx"), Value.Bits));
+
+		return EncodeNumber(DecodeNumber(Value));
+	}
+
+	FString FormatValue(const FBltFuzzValue& Value)
+	{
+		switch (Value.Type)
+		{
+		case EBltFuzzValueType::Int64:  return LexToString(static_cast<int64>(Value.Bits));
+		case EBltFuzzValueType::UInt64: return LexToString(Value.Bits);
+		default:                        return LexToString(DecodeNumber(Value));
+		}
+	}
+
+	// A regex matching exactly Literal, so the spec generates the minimized string and nothing else
+	FString EscapeRegex(const FString& Literal)
+	{
+		FString Escaped;
+		Escaped.Reserve(Literal.Len() * 2);
+		for (const TCHAR Character : Literal)
+		{
+			if (FCString::Strchr(TEXT("\\^$.|?*+()[]{}"), Character))
+			{
+				Escaped += TEXT('\\');
+			}
+			Escaped += Character;
+		}
+		return Escaped;
+	}
+
+	bool IsStringType(const EBltFuzzValueType Type)
+	{
+		return Type == EBltFuzzValueType::String || Type == EBltFuzzValueType::Name || Type == EBltFuzzValueType::Text;
+	}
+}
+
+
+FBltMinimizer::FBltMinimizer(const FBltFuzzCampaignSettings& InSettings, const int32 InWorldCount, const int32 InProcessCount)
+	: Settings(InSettings)
+	, WorldCount(FMath::Max(InWorldCount, 1))
+	, ProcessCount(FMath::Max(InProcessCount, 0))
+{
+}
+
+FBltMinimizer::~FBltMinimizer()
+{
+	Worlds.Empty();
+	if (Plan.IsValid())
+	{
+		UBltBPLibrary::UnloadFuzzPlan(Plan);
+	}
+}
+
+bool FBltMinimizer::Run()
+{
+	const double StartTime = FPlatformTime::Seconds();
+	if (!Setup() || !LoadOriginal())
+		return false;
+
+	TArray<uint64> Keys;
+	Original.Values.GenerateKeyArray(Keys);
+	Keys.Sort();
+	UE_LOG(LogBlt, Display, TEXT("Minimizing iteration %d: %d mutations"), Settings.FirstIteration, Keys.Num());
+
+	// Anything else in the iteration that is not replayed, gameplay randomness included, shows up here
+	if (FindFailing({ Keys }) == INDEX_NONE)
+	{
+		UE_LOG(LogBlt, Error, TEXT("Iteration %d does not fail when replayed, nothing to minimize"), Settings.FirstIteration);
+		return false;
+	}
+
+	int32 Granularity = 2;
+	while (Keys.Num() >= 2)
+	{
+		Granularity = FMath::Min(Granularity, Keys.Num());
+
+		// Subsets first, then their complements; with two chunks the complements are the subsets
+		TArray<TArray<uint64>> Candidates;
+		for (int32 ChunkIndex = 0; ChunkIndex < Granularity; ++ChunkIndex)
+		{
+			const int32 Begin = static_cast<int64>(Keys.Num()) * ChunkIndex / Granularity;
+			const int32 End = static_cast<int64>(Keys.Num()) * (ChunkIndex + 1) / Granularity;
+			Candidates.Emplace(Keys.GetData() + Begin, End - Begin);
+		}
+
+		if (Granularity > 2)
+		{
+			for (int32 ChunkIndex = 0; ChunkIndex < Granularity; ++ChunkIndex)
+			{
+				const int32 Begin = static_cast<int64>(Keys.Num()) * ChunkIndex / Granularity;
+				const int32 End = static_cast<int64>(Keys.Num()) * (ChunkIndex + 1) / Granularity;
+
+				TArray<uint64>& Complement = Candidates.AddDefaulted_GetRef();
+				Complement.Append(Keys.GetData(), Begin);
+				Complement.Append(Keys.GetData() + End, Keys.Num() - End);
+			}
+		}
+
+		const int32 Failing = FindFailing(Candidates);
+		if (Failing == INDEX_NONE)
+		{
+			if (Granularity >= Keys.Num())
+				break;
+
+			Granularity = FMath::Min(Granularity * 2, Keys.Num());
+			continue;
+		}
+
+		Keys = MoveTemp(Candidates[Failing]);
+		Granularity = Failing < Granularity ? 2 : FMath::Max(Granularity - 1, 2);
+		UE_LOG(LogBlt, Display, TEXT("%d mutations left after %d candidates"), Keys.Num(), Evaluations);
+	}
+
+	FBltCorpusEntry Minimized = MakeEntry(Keys);
+	const FString EntryPath = Settings.OutputDirectory / TEXT("Minimized.bltcorpus");
+	if (!Minimized.Save(EntryPath) || !WriteSpec(Minimized))
+	{
+		UE_LOG(LogBlt, Error, TEXT("Could not write the minimized reproducer into %s!"), *Settings.OutputDirectory);
+		return false;
+	}
+
+	UE_LOG(LogBlt, Display, TEXT("Minimized iteration %d from %d to %d mutations in %d candidates, %.1f seconds. Replay with -Replay=\"%s\""),
+		Settings.FirstIteration, Original.Values.Num(), Keys.Num(), Evaluations, FPlatformTime::Seconds() - StartTime, *EntryPath);
+	return true;
+}
+
+bool FBltMinimizer::Setup()
+{
+	Plan = UBltBPLibrary::LoadFuzzPlan(Settings.SpecPath);
+	const FBltFuzzPlanPtr FuzzPlan = FBltFuzzPlanRegistry::Get().Find(Plan);
+	if (!FuzzPlan)
+		return false;
+
+	// Out of process candidates still need one world to regenerate the values and name the actors
+	const int32 LocalWorldCount = ProcessCount > 0 ? 1 : WorldCount;
+	for (int32 WorldIndex = 0; WorldIndex < LocalWorldCount; ++WorldIndex)
+	{
+		TUniquePtr<FBltFuzzWorld> World = FBltFuzzWorld::Create(Settings.MapName, WorldIndex);
+		if (!World)
+			return false;
+
+		FBltWorldCheckpoint::Get(World->Get()).Capture(*FuzzPlan);
+		Worlds.Add(MoveTemp(World));
+	}
+
+	return true;
+}
+
+bool FBltMinimizer::LoadOriginal()
+{
+	if (!Settings.ReplayPath.IsEmpty())
+	{
+		if (!Original.Load(Settings.ReplayPath))
+		{
+			UE_LOG(LogBlt, Error, TEXT("Could not load %s!"), *Settings.ReplayPath);
+			return false;
+		}
+		return true;
+	}
+
+	const FBltFuzzPlanPtr FuzzPlan = FBltFuzzPlanRegistry::Get().Find(Plan);
+	UWorld* const World = Worlds[0]->Get();
+
+	FBltFuzzPass Pass;
+	Pass.Seed = Settings.Seed;
+	Pass.Iteration = Settings.FirstIteration;
+
+	// Only applied, never ticked, so an iteration that crashes the game does not crash the minimizer
+	FBltMutationJournal Journal;
+	FBltValueCapture Capture;
+	Journal.SetListener(&Capture);
+	{
+		const FBltMutationJournal::FScopedActive ActiveJournal(Journal);
+		UBltBPLibrary::ApplyFuzzPass(World, *FuzzPlan, Pass, TArray<AActor*>(), false, Settings.bParallel);
+	}
+	Journal.SetListener(nullptr);
+
+	Original = Capture.Take();
+	FBltWorldCheckpoint::Get(World).Reset();
+
+	if (Original.Values.Num() == 0)
+	{
+		UE_LOG(LogBlt, Error, TEXT("Iteration %d does not mutate anything"), Settings.FirstIteration);
+		return false;
+	}
+
+	return true;
+}
+
+int32 FBltMinimizer::FindFailing(const TArray<TArray<uint64>>& Candidates)
+{
+	const int32 BatchSize = ProcessCount > 0 ? ProcessCount : Worlds.Num();
+	for (int32 Begin = 0; Begin < Candidates.Num(); Begin += BatchSize)
+	{
+		TArray<FBltCorpusEntry> Batch;
+		for (int32 CandidateIndex = Begin; CandidateIndex < FMath::Min(Begin + BatchSize, Candidates.Num()); ++CandidateIndex)
+		{
+			Batch.Add(MakeEntry(Candidates[CandidateIndex]));
+		}
+
+		TArray<bool> Failing;
+		Failing.SetNumZeroed(Batch.Num());
+		if (ProcessCount > 0)
+		{
+			EvaluateInProcesses(Batch, Failing);
+		}
+		else
+		{
+			EvaluateInWorlds(Batch, Failing);
+		}
+		Evaluations += Batch.Num();
+
+		const int32 FailingIndex = Failing.Find(true);
+		if (FailingIndex != INDEX_NONE)
+			return Begin + FailingIndex;
+	}
+
+	return INDEX_NONE;
+}
+
+void FBltMinimizer::EvaluateInWorlds(const TArray<FBltCorpusEntry>& Batch, TArray<bool>& OutFailing)
+{
+	const FBltFuzzPlanPtr FuzzPlan = FBltFuzzPlanRegistry::Get().Find(Plan);
+
+	// Keeps the replays out of the process journal
+	FBltMutationJournal Journal;
+	const FBltMutationJournal::FScopedActive ActiveJournal(Journal);
+
+	TArray<FBltFuzzGuide> Guides;
+	Guides.Reserve(Batch.Num());
+	for (int32 CandidateIndex = 0; CandidateIndex < Batch.Num(); ++CandidateIndex)
+	{
+		UWorld* const World = Worlds[CandidateIndex]->Get();
+		FBltWorldCheckpoint::Get(World).Reset();
+
+		TArray<FString> StaleReasons;
+		FBltFuzzFailures::Consume(World, StaleReasons);
+
+		FBltFuzzPass Pass;
+		Pass.Seed = Settings.Seed;
+		Pass.Iteration = Settings.FirstIteration;
+		Pass.Guide = &Guides.Emplace_GetRef(Batch[CandidateIndex], 1.0, true);
+		UBltBPLibrary::ApplyFuzzPass(World, *FuzzPlan, Pass, TArray<AActor*>(), false, Settings.bParallel);
+	}
+
+	for (int32 Step = 0; Step < Settings.StepsPerIteration && !IsEngineExitRequested(); ++Step)
+	{
+		FBltFuzzWorld::AdvanceFrame(Settings.StepSeconds);
+		for (int32 CandidateIndex = 0; CandidateIndex < Batch.Num(); ++CandidateIndex)
+		{
+			Worlds[CandidateIndex]->Tick(Settings.StepSeconds);
+		}
+	}
+
+	for (int32 CandidateIndex = 0; CandidateIndex < Batch.Num(); ++CandidateIndex)
+	{
+		TArray<FString> Reasons;
+		OutFailing[CandidateIndex] = FBltFuzzFailures::Consume(Worlds[CandidateIndex]->Get(), Reasons);
+	}
+}
+
+void FBltMinimizer::EvaluateInProcesses(TArray<FBltCorpusEntry>& Batch, TArray<bool>& OutFailing)
+{
+	TArray<FProcHandle> Processes;
+	TArray<FString> OutputDirectories;
+	for (int32 CandidateIndex = 0; CandidateIndex < Batch.Num(); ++CandidateIndex)
+	{
+		FBltFuzzCampaignSettings CandidateSettings = Settings;
+		CandidateSettings.OutputDirectory = Settings.OutputDirectory / TEXT("Candidates") / FString::Printf(TEXT("Candidate_%d"), Evaluations + CandidateIndex);
+		CandidateSettings.ReplayPath = CandidateSettings.OutputDirectory / TEXT("Candidate.bltcorpus");
+		CandidateSettings.Iterations = 1;
+		CandidateSettings.DurationSeconds = 0.0;
+		CandidateSettings.bGuided = false;
+
+		Batch[CandidateIndex].Save(CandidateSettings.ReplayPath);
+		OutputDirectories.Add(CandidateSettings.OutputDirectory);
+		Processes.Add(CandidateSettings.Launch(CandidateSettings.OutputDirectory / TEXT("Worker.log")));
+	}
+
+	for (int32 CandidateIndex = 0; CandidateIndex < Processes.Num(); ++CandidateIndex)
+	{
+		FProcHandle& Process = Processes[CandidateIndex];
+		if (!Process.IsValid())
+		{
+			UE_LOG(LogBlt, Error, TEXT("Could not start candidate %d!"), Evaluations + CandidateIndex);
+			continue;
+		}
+
+		FPlatformProcess::WaitForProc(Process);
+
+		int32 ReturnCode = 0;
+		FPlatformProcess::GetProcReturnCode(Process, &ReturnCode);
+		FPlatformProcess::CloseProc(Process);
+
+		// Reported failures exit with 2 and crashes with whatever the crash left; a process that never
+		// got to fuzz failed for some other reason and does not count
+		OutFailing[CandidateIndex] = ReturnCode != 0 && FBltFuzzCampaign::ReadProgress(OutputDirectories[CandidateIndex]) != INDEX_NONE;
+	}
+}
+
+FBltCorpusEntry FBltMinimizer::MakeEntry(const TArray<uint64>& Keys) const
+{
+	FBltCorpusEntry Entry;
+	Entry.Values.Reserve(Keys.Num());
+	for (const uint64 Key : Keys)
+	{
+		Entry.Values.Add(Key, Original.Values.FindChecked(Key));
+	}
+	return Entry;
+}
+
+bool FBltMinimizer::WriteSpec(const FBltCorpusEntry& Entry) const
+{
+	const FBltFuzzPlanPtr FuzzPlan = FBltFuzzPlanRegistry::Get().Find(Plan);
+	UWorld* const World = Worlds[0]->Get();
+	FBltActorIndex& ActorIndex = FBltActorIndex::Get(World);
+
+	// A spec pins values per class, so actors and elements sharing a class and property keep the first value met
+	const TSharedRef<FJsonObject> Spec = MakeShared<FJsonObject>();
+	TMap<FString, const FBltFuzzValue*> Written;
+
+	const TArray<FBltFuzzClassSpec>& Classes = FuzzPlan->GetClasses();
+	for (int32 ClassIndex = 0; ClassIndex < Classes.Num(); ++ClassIndex)
+	{
+		const UClass* const SpecClass = Classes[ClassIndex].Class.Get();
+		if (!SpecClass)
+			continue;
+
+		TArray<AActor*> ClassActors;
+		ActorIndex.GetActorsOfClass(SpecClass, ClassActors);
+		for (AActor* const Actor : ClassActors)
+		{
+			const uint32 ActorId = FBltRandomStream::HashObject(Actor);
+			const FBltFuzzClassPlan& ClassPlan = FuzzPlan->FindOrResolveClassPlan(ClassIndex, Actor->GetClass());
+			for (const FBltFuzzPropertyPlan& PropertyPlan : ClassPlan.Properties)
+			{
+				FBltPropertyAccess::ForEachValue(Actor, PropertyPlan, [&](UObject* const Owner, void* const ValuePtr, const uint32 ValueId)
+				{
+					const FBltFuzzValue* const Value = Entry.Values.Find(FBltCorpusEntry::MakeKey(ActorId, ValueId));
+					if (!Value)
+						return;
+
+					const FString& ClassName = Classes[ClassIndex].ClassName;
+					const FString PropertyName = PropertyPlan.PathName.ToString();
+					UE_LOG(LogBlt, Display, TEXT("  %s.%s = %s"), *Actor->GetName(), *PropertyName,
+						IsStringType(Value->Type) ? *Value->String : *FormatValue(*Value));
+
+					// Elements of a container end up here one by one too
+					const FBltFuzzValue*& WrittenValue = Written.FindOrAdd(ClassName + TEXT(".") + PropertyName);
+					if (WrittenValue)
+					{
+						if (WrittenValue->Bits != Value->Bits || WrittenValue->String != Value->String)
+						{
+							UE_LOG(LogBlt, Warning, TEXT("%s.%s needs different values per actor or element, the spec keeps the first"), *ClassName, *PropertyName);
+						}
+						return;
+					}
+					WrittenValue = Value;
+
+					// Properties left out of the minimized set keep the values the level gives them
+					if (!Spec->HasField(ClassName))
+					{
+						const TSharedRef<FJsonObject> Defaults = MakeShared<FJsonObject>();
+						Defaults->SetBoolField(TEXT("FuzzUnlisted"), false);
+
+						const TSharedRef<FJsonObject> ClassObject = MakeShared<FJsonObject>();
+						ClassObject->SetObjectField(TEXT("*"), Defaults);
+						Spec->SetObjectField(ClassName, ClassObject);
+					}
+
+					const TSharedPtr<FJsonObject> ClassObject = Spec->GetObjectField(ClassName);
+					if (IsStringType(Value->Type))
+					{
+						ClassObject->SetStringField(PropertyName, EscapeRegex(Value->String));
+					}
+					else
+					{
+						ClassObject->SetField(PropertyName, EncodeValue(*Value));
+					}
+				});
+			}
+		}
+	}
+
+	FString Json;
+	const TSharedRef<TJsonWriter<TCHAR, TPrettyJsonPrintPolicy<TCHAR>>> JsonWriter
+		= TJsonWriterFactory<TCHAR, TPrettyJsonPrintPolicy<TCHAR>>::Create(&Json);
+	if (!FJsonSerializer::Serialize(Spec, JsonWriter))
+		return false;
+
+	return FFileHelper::SaveStringToFile(Json, *(Settings.OutputDirectory / TEXT("Minimized.json")));
+}
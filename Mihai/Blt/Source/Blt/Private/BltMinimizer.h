@@ -0,0 +1,45 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "BltCorpus.h"
+#include "BltFuzzCampaign.h"
+
+class FBltFuzzWorld;
+
+
+// Delta debugging (ddmin) of one failing iteration down to a minimal set of (actor, property, value)
+// mutations. The values of the iteration are regenerated from its random streams, or loaded from a
+// corpus entry for guided campaigns, then subsets of them are replayed with an exclusive guide from
+// the checkpoint the iteration started from. Candidates run side by side, either on several worlds
+// of this process in lockstep or on BltFuzz replay processes, which also survive candidates that crash.
+class FBltMinimizer
+{
+public:
+	// Settings.FirstIteration is the failing iteration; a ProcessCount above zero evaluates out of process
+	FBltMinimizer(const FBltFuzzCampaignSettings& InSettings, const int32 InWorldCount, const int32 InProcessCount);
+	~FBltMinimizer();
+
+	bool Run();
+
+private:
+	bool Setup();
+	bool LoadOriginal();
+
+	// Index of the first candidate that still fails, INDEX_NONE when none does
+	int32 FindFailing(const TArray<TArray<uint64>>& Candidates);
+	void EvaluateInWorlds(const TArray<FBltCorpusEntry>& Batch, TArray<bool>& OutFailing);
+	void EvaluateInProcesses(TArray<FBltCorpusEntry>& Batch, TArray<bool>& OutFailing);
+
+	FBltCorpusEntry MakeEntry(const TArray<uint64>& Keys) const;
+	bool WriteSpec(const FBltCorpusEntry& Entry) const;
+
+	FBltFuzzCampaignSettings Settings;
+	int32 WorldCount = 1;
+	int32 ProcessCount = 0;
+
+	TArray<TUniquePtr<FBltFuzzWorld>> Worlds;
+	FBltFuzzPlanHandle Plan;
+	FBltCorpusEntry Original;
+	int32 Evaluations = 0;
+};
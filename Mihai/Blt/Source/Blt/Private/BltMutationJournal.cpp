@@ -0,0 +1,253 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "BltMutationJournal.h"
+
+#include "HAL/Thread.h"
+#include "Hash/CityHash.h"
+#include "BltBPLibrary.h"
+
+
+static TAutoConsoleVariable<bool> CVarBltShowMutations(
+	TEXT("Blt.ShowMutations"),
+	true,
+	TEXT("Shows a one line on-screen summary of the mutations of every fuzz pass")
+);
+
+namespace
+{
+	constexpr uint32 JournalMagic = 0x4A544C42u; // "BLTJ"
+	constexpr uint32 JournalVersion = 1u;
+	constexpr uint64 SummaryMessageKey = 0x426C7453756D6D61ull;
+
+	uint64 HashString(const FString& String)
+	{
+		return CityHash64(reinterpret_cast<const char*>(*String), String.Len() * sizeof(TCHAR));
+	}
+}
+
+
+FBltMutationJournal* FBltMutationJournal::Active = nullptr;
+
+
+FBltMutationJournal& FBltMutationJournal::Get()
+{
+	static FBltMutationJournal Journal;
+	return Active ? *Active : Journal;
+}
+
+FBltMutationJournal::~FBltMutationJournal()
+{
+	Stop();
+}
+
+void FBltMutationJournal::Start(const FString& InDirectory)
+{
+	if (bRunning.load())
+		return;
+
+	Directory = InDirectory;
+	Slots = MakeUnique<FSlot[]>(Capacity);
+	for (uint32 SlotIndex = 0u; SlotIndex < Capacity; ++SlotIndex)
+	{
+		Slots[SlotIndex].Sequence.store(SlotIndex, std::memory_order_relaxed);
+	}
+
+	EnqueuePosition.store(0u);
+	DequeuePosition = 0u;
+	OpenNextFile();
+
+	bRunning.store(true);
+	Writer = MakeUnique<FThread>(TEXT("BltMutationJournal"), [this]()
+	{
+		WriterLoop();
+	});
+}
+
+void FBltMutationJournal::Stop()
+{
+	if (!bRunning.exchange(false))
+		return;
+
+	// The writer drains what is left before it exits
+	Writer->Join();
+	Writer.Reset();
+	File.Reset();
+}
+
+void FBltMutationJournal::Record(
+	const uint32 ActorId,
+	const uint32 PropertyId,
+	const EBltFuzzValueType Type,
+	const uint64 OldValue,
+	const uint64 NewValue
+)
+{
+	FBltMutationRecord Record;
+	Record.Frame = GFrameCounter;
+	Record.ActorId = ActorId;
+	Record.PropertyId = PropertyId;
+	Record.OldValue = OldValue;
+	Record.NewValue = NewValue;
+	Record.Type = Type;
+	Enqueue(Record);
+
+	if (Listener)
+	{
+		Listener->OnMutation(Record, nullptr);
+	}
+}
+
+void FBltMutationJournal::RecordString(
+	const uint32 ActorId,
+	const uint32 PropertyId,
+	const EBltFuzzValueType Type,
+	const FString& OldValue,
+	const FString& NewValue
+)
+{
+	FBltMutationRecord Record;
+	Record.Frame = GFrameCounter;
+	Record.ActorId = ActorId;
+	Record.PropertyId = PropertyId;
+	Record.OldValue = HashString(OldValue);
+	Record.NewValue = HashString(NewValue);
+	Record.Type = Type;
+	Record.ValueKind = EBltMutationValue::StringHash;
+	Enqueue(Record);
+
+	if (Listener)
+	{
+		Listener->OnMutation(Record, &NewValue);
+	}
+}
+
+void FBltMutationJournal::ShowSummary()
+{
+	check(IsInGameThread());
+
+	const uint64 Recorded = GetRecordedCount();
+	const uint64 Mutations = Recorded - SummarizedCount;
+	SummarizedCount = Recorded;
+
+	if (!GEngine || !CVarBltShowMutations.GetValueOnGameThread())
+		return;
+
+	GEngine->AddOnScreenDebugMessage(
+		SummaryMessageKey,
+		10.f,
+		FColor::Green,
+		FString::Printf(TEXT("Blt: %llu mutations (%llu total, %llu dropped)"), Mutations, Recorded, GetDroppedCount())
+	);
+}
+
+// Bounded MPMC ring after Dmitry Vyukov, used with a single consumer
+bool FBltMutationJournal::Enqueue(const FBltMutationRecord& Record)
+{
+	if (!bRunning.load(std::memory_order_relaxed))
+		return false;
+
+	uint64 Position = EnqueuePosition.load(std::memory_order_relaxed);
+	for (;;)
+	{
+		FSlot& Slot = Slots[Position & (Capacity - 1u)];
+		const uint64 Sequence = Slot.Sequence.load(std::memory_order_acquire);
+		const int64 Difference = static_cast<int64>(Sequence) - static_cast<int64>(Position);
+		if (Difference == 0)
+		{
+			if (EnqueuePosition.compare_exchange_weak(Position, Position + 1u, std::memory_order_relaxed))
+			{
+				Slot.Record = Record;
+				Slot.Sequence.store(Position + 1u, std::memory_order_release);
+				RecordedCount.fetch_add(1u, std::memory_order_relaxed);
+				return true;
+			}
+		}
+		else if (Difference < 0)
+		{
+			DroppedCount.fetch_add(1u, std::memory_order_relaxed);
+			return false;
+		}
+		else
+		{
+			Position = EnqueuePosition.load(std::memory_order_relaxed);
+		}
+	}
+}
+
+bool FBltMutationJournal::Dequeue(FBltMutationRecord& OutRecord)
+{
+	FSlot& Slot = Slots[DequeuePosition & (Capacity - 1u)];
+	if (Slot.Sequence.load(std::memory_order_acquire) != DequeuePosition + 1u)
+		return false;
+
+	OutRecord = Slot.Record;
+	Slot.Sequence.store(DequeuePosition + Capacity, std::memory_order_release);
+	++DequeuePosition;
+	return true;
+}
+
+void FBltMutationJournal::WriterLoop()
+{
+	TArray<FBltMutationRecord> Records;
+	Records.Reserve(4096);
+
+	for (;;)
+	{
+		const bool bStopping = !bRunning.load();
+
+		FBltMutationRecord Record;
+		while (Records.Num() < 4096 && Dequeue(Record))
+		{
+			Records.Add(Record);
+		}
+
+		if (Records.Num() > 0)
+		{
+			WriteRecords(Records);
+			Records.Reset();
+			continue;
+		}
+
+		if (bStopping)
+			break;
+
+		FPlatformProcess::Sleep(0.005f);
+	}
+
+	if (File)
+	{
+		File->Flush();
+	}
+}
+
+void FBltMutationJournal::WriteRecords(const TArray<FBltMutationRecord>& Records)
+{
+	if (!File)
+		return;
+
+	if (File->Tell() + Records.Num() * static_cast<int64>(sizeof(FBltMutationRecord)) > MaxFileSize)
+	{
+		OpenNextFile();
+		if (!File)
+			return;
+	}
+
+	File->Serialize(const_cast<FBltMutationRecord*>(Records.GetData()), Records.Num() * sizeof(FBltMutationRecord));
+}
+
+void FBltMutationJournal::OpenNextFile()
+{
+	File.Reset();
+	FileIndex = (FileIndex + 1) % MaxFiles;
+
+	const FString FilePath = Directory / FString::Printf(TEXT("Mutations_%d.bin"), FileIndex);
+	File.Reset(IFileManager::Get().CreateFileWriter(*FilePath));
+	if (!File)
+	{
+		UE_LOG(LogBlt, Error, TEXT("Could not open mutation journal %s"), *FilePath);
+		return;
+	}
+
+	uint32 Header[4] = { JournalMagic, JournalVersion, sizeof(FBltMutationRecord), 0u };
+	File->Serialize(Header, sizeof(Header));
+}
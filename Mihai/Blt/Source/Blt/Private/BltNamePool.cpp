@@ -0,0 +1,75 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "BltNamePool.h"
+
+#include "BltRegexGenerator.h"
+#include "BltStats.h"
+
+
+FBltNamePool::FBltNamePool(const FBltFuzzPropertyPlan& PropertyPlan, const int32 InSize)
+	: Size(FMath::Max(InSize, 1))
+{
+	Names.Reserve(Size);
+	if (!PropertyPlan.Generator)
+		return;
+
+	// Pinned to the regex and the property alone, so reloading the spec renders the same names again
+	FBltRandomStream Stream(0, 0, 0u, PropertyPlan.PropertyId);
+	FString Name;
+	for (int32 Index = 0; Index < Size; ++Index)
+	{
+		PropertyPlan.Generator->Generate(Stream, Name);
+		Name.LeftInline(MaxNameLength, false);
+		Names.Add(FName(*Name));
+	}
+
+	bPregenerated = true;
+	INC_DWORD_STAT_BY(STAT_BltNamePoolSize, Names.Num());
+}
+
+FBltNamePool::~FBltNamePool()
+{
+	DEC_DWORD_STAT_BY(STAT_BltNamePoolSize, Names.Num());
+}
+
+FName FBltNamePool::Intern(const FString& String)
+{
+	if (String.Len() > MaxNameLength)
+		return Intern(String.Left(MaxNameLength));
+
+	const FName Existing(*String, FNAME_Find);
+	if (!Existing.IsNone() || String.IsEmpty())
+	{
+		BLT_COUNT_NAME_LOOKUP(true);
+		return Existing;
+	}
+
+	BLT_COUNT_NAME_LOOKUP(false);
+
+	FScopeLock ScopeLock(&Lock);
+	if (Names.Num() < Size)
+	{
+		INC_DWORD_STAT(STAT_BltNamePoolSize);
+		return Names.Add_GetRef(FName(*String));
+	}
+
+	return Names[GetTypeHash(String) % static_cast<uint32>(Names.Num())];
+}
+
+
+FBltNamePoolCache& FBltNamePoolCache::Get()
+{
+	static FBltNamePoolCache Cache;
+	return Cache;
+}
+
+TSharedRef<FBltNamePool, ESPMode::ThreadSafe> FBltNamePoolCache::FindOrAdd(const FString& SourcePath, const FBltFuzzPropertyPlan& PropertyPlan, const int32 Size)
+{
+	const FKey Key(SourcePath, PropertyPlan.PathName, PropertyPlan.Regex, Size);
+
+	FScopeLock ScopeLock(&Lock);
+	if (const TSharedRef<FBltNamePool, ESPMode::ThreadSafe>* const Pool = Pools.Find(Key))
+		return *Pool;
+
+	return Pools.Add(Key, MakeShared<FBltNamePool, ESPMode::ThreadSafe>(PropertyPlan, Size));
+}
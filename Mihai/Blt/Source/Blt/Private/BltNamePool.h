@@ -0,0 +1,58 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "BltFuzzPlan.h"
+#include "BltRandom.h"
+
+
+// FNames are never freed, so every name written to a fuzzed FName property comes out of a bounded
+// pool. Entries with a native regex render the whole pool up front and sample by index; others admit
+// the first strings they are asked for. Once full, a string that is not a name yet maps to one of
+// the pooled names by hash, so a campaign of any length adds at most Size entries to the name table.
+class FBltNamePool
+{
+public:
+	FBltNamePool(const FBltFuzzPropertyPlan& PropertyPlan, const int32 InSize);
+	~FBltNamePool();
+
+	FBltNamePool(const FBltNamePool&) = delete;
+	FBltNamePool& operator=(const FBltNamePool&) = delete;
+
+	static constexpr int32 DefaultSize = 256;
+
+	// Longest string an FName accepts; longer ones are cut down before they reach the name table
+	static constexpr int32 MaxNameLength = NAME_SIZE - 1;
+
+	bool IsPregenerated() const { return bPregenerated; }
+
+	// Pregenerated pools only, one draw of the stream per pick
+	int32 Pick(FBltRandomStream& Stream) const { return Stream.RandHelper(Names.Num()); }
+	FName GetName(const int32 Index) const { return Names[Index]; }
+
+	// Names already in the name table are hits and kept as they are
+	FName Intern(const FString& String);
+
+private:
+	FCriticalSection Lock;
+	TArray<FName> Names;
+	int32 Size = 0;
+	bool bPregenerated = false;
+};
+
+
+// Pools outlive the plans that use them: an entry re-resolved after a reload or a schema change gets
+// the pool it had before, so re-planning never starts another Size names into the name table
+class FBltNamePoolCache
+{
+public:
+	static FBltNamePoolCache& Get();
+
+	TSharedRef<FBltNamePool, ESPMode::ThreadSafe> FindOrAdd(const FString& SourcePath, const FBltFuzzPropertyPlan& PropertyPlan, const int32 Size);
+
+private:
+	using FKey = TTuple<FString, FName, FString, int32>;
+
+	FCriticalSection Lock;
+	TMap<FKey, TSharedRef<FBltNamePool, ESPMode::ThreadSafe>> Pools;
+};
@@ -0,0 +1,378 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "BltFuzzPlan.h"
+#include "BltRandom.h"
+#include "BltValueDistribution.h"
+
+
+// Kernels sample in the native type of the property and write straight into the value,
+// so no numeric mutation formats, parses or allocates anything. Sampling and writing are
+// split so values can be computed on worker threads and committed later as raw bits.
+// Every interval sample takes exactly one draw of its stream, which FromRandom maps to a value;
+// the column kernels feed it draws computed for many actors at once. Distribution entries are
+// sampled by FBltValueDistribution instead.
+template <typename T>
+struct TBltNumericSampler
+{
+	static_assert(TIsIntegral<T>::Value, "Integer kernel instantiated for a non integer type");
+
+	static constexpr int32 MaxDelta = 16;
+
+	// Same mapping as FBltRandomStream::RangeUInt64
+	static T FromRandom(const FBltFuzzPropertyPlan& PropertyPlan, const uint64 Random)
+	{
+		const uint64 Span = PropertyPlan.IntegerMax - PropertyPlan.IntegerMin;
+		return static_cast<T>(Span == MAX_uint64 ? Random : PropertyPlan.IntegerMin + Random % (Span + 1u));
+	}
+
+	// A small step, a sign flip or a scaling, wrapping around like the integer type does
+	static T Perturb(const T Value, FBltRandomStream& Stream)
+	{
+		const uint64 Bits = static_cast<uint64>(Value);
+		switch (Stream.RandHelper(3))
+		{
+		case 0:
+		{
+			const uint64 Delta = 1u + Stream.RandHelper(MaxDelta);
+			return static_cast<T>(Stream.RandHelper(2) ? Bits + Delta : Bits - Delta);
+		}
+
+		case 1:
+			return static_cast<T>(0u - Bits);
+
+		default:
+			switch (Stream.RandHelper(4))
+			{
+			case 0:  return static_cast<T>(Bits * 2u);
+			case 1:  return static_cast<T>(Bits * 10u);
+			case 2:  return static_cast<T>(Value / 2);
+			default: return static_cast<T>(Value / 10);
+			}
+		}
+	}
+
+	static T Clamp(const FBltFuzzPropertyPlan& PropertyPlan, const T Value)
+	{
+		return FMath::Clamp(Value, static_cast<T>(PropertyPlan.IntegerMin), static_cast<T>(PropertyPlan.IntegerMax));
+	}
+};
+
+template <typename T>
+struct TBltFloatPerturbation
+{
+	// A step of up to one percent, a sign flip or a scaling; steps away from zero are absolute
+	static T Perturb(const T Value, FBltRandomStream& Stream)
+	{
+		switch (Stream.RandHelper(3))
+		{
+		case 0:
+		{
+			const double Step = Value == 0 ? 1.0 : FMath::Abs(Value) * 0.01;
+			return static_cast<T>(Value + Step * (Stream.GetFraction() * 2.0 - 1.0));
+		}
+
+		case 1:
+			return -Value;
+
+		default:
+		{
+			static constexpr double Factors[] = { 2.0, 0.5, 10.0, 0.1 };
+			return static_cast<T>(Value * Factors[Stream.RandHelper(UE_ARRAY_COUNT(Factors))]);
+		}
+		}
+	}
+
+	// NaN compares false with everything, so it is sent to Min explicitly
+	static T Clamp(const FBltFuzzPropertyPlan& PropertyPlan, const T Value)
+	{
+		return static_cast<T>(FMath::IsNaN(Value) ? PropertyPlan.Min : FMath::Clamp<double>(Value, PropertyPlan.Min, PropertyPlan.Max));
+	}
+};
+
+template <>
+struct TBltNumericSampler<float> : TBltFloatPerturbation<float>
+{
+	// Same mapping as FBltRandomStream::GetFraction
+	static float FromRandom(const FBltFuzzPropertyPlan& PropertyPlan, const uint64 Random)
+	{
+		return static_cast<float>(FMath::Lerp(PropertyPlan.Min, PropertyPlan.Max, static_cast<double>(Random >> 11u) * (1.0 / 9007199254740992.0)));
+	}
+};
+
+template <>
+struct TBltNumericSampler<double> : TBltFloatPerturbation<double>
+{
+	static double FromRandom(const FBltFuzzPropertyPlan& PropertyPlan, const uint64 Random)
+	{
+		return FMath::Lerp(PropertyPlan.Min, PropertyPlan.Max, static_cast<double>(Random >> 11u) * (1.0 / 9007199254740992.0));
+	}
+};
+
+
+template <typename T>
+struct TBltNumericMutator
+{
+	static uint64 ToBits(const T Value)
+	{
+		uint64 Bits = 0u;
+		FMemory::Memcpy(&Bits, &Value, sizeof(T));
+		return Bits;
+	}
+
+	static T FromBits(const uint64 Bits)
+	{
+		T Value;
+		FMemory::Memcpy(&Value, &Bits, sizeof(T));
+		return Value;
+	}
+
+	static uint64 FromRandom(const FBltFuzzPropertyPlan& PropertyPlan, const uint64 Random)
+	{
+		return ToBits(TBltNumericSampler<T>::FromRandom(PropertyPlan, Random));
+	}
+
+	static uint64 Sample(const FBltFuzzPropertyPlan& PropertyPlan, FBltRandomStream& Stream)
+	{
+		if (PropertyPlan.Distribution)
+			return PropertyPlan.Distribution->Sample(Stream);
+
+		return FromRandom(PropertyPlan, Stream.NextUInt64());
+	}
+
+	// One, two or four stacked edits of the current value, clamped to Min and Max so repeated scalings cannot
+	// walk off to the type limits, infinities or NaN; only distributions with edges or boundaries go there
+	static uint64 Perturb(const FBltFuzzPropertyPlan& PropertyPlan, uint64 Bits, FBltRandomStream& Stream)
+	{
+		const int32 EditCount = 1 << Stream.RandHelper(3);
+		for (int32 Edit = 0; Edit < EditCount; ++Edit)
+		{
+			switch (Stream.RandHelper(4))
+			{
+			case 0:
+				Bits ^= 1ull << Stream.RandHelper(static_cast<int32>(sizeof(T) * 8u));
+				break;
+
+			// Keeps the whole entry within reach of a long walk
+			case 1:
+				Bits = Sample(PropertyPlan, Stream);
+				break;
+
+			default:
+				Bits = ToBits(TBltNumericSampler<T>::Perturb(FromBits(Bits), Stream));
+				break;
+			}
+		}
+
+		if (PropertyPlan.bUnbounded)
+			return ToBits(FromBits(Bits));
+
+		return ToBits(TBltNumericSampler<T>::Clamp(PropertyPlan, FromBits(Bits)));
+	}
+
+	static uint64 Read(const FBltFuzzPropertyPlan& PropertyPlan, const void* const ValuePtr)
+	{
+		uint64 Bits = 0u;
+		FMemory::Memcpy(&Bits, ValuePtr, sizeof(T));
+		return Bits;
+	}
+
+	static void Write(const FBltFuzzPropertyPlan& PropertyPlan, void* const ValuePtr, const uint64 Bits)
+	{
+		FMemory::Memcpy(ValuePtr, &Bits, sizeof(T));
+	}
+
+	static void Mutate(const FBltFuzzPropertyPlan& PropertyPlan, void* const ValuePtr, FBltRandomStream& Stream)
+	{
+		Write(PropertyPlan, ValuePtr, Sample(PropertyPlan, Stream));
+	}
+};
+
+// Same masking as FBoolProperty::SetPropertyValue, so bitfields keep their neighbours
+template <>
+struct TBltNumericMutator<bool>
+{
+	// Same bit as FBltRandomStream::GetUnsignedInt() & 1
+	static uint64 FromRandom(const FBltFuzzPropertyPlan& PropertyPlan, const uint64 Random)
+	{
+		return (Random >> 32u) & 1u;
+	}
+
+	static uint64 Sample(const FBltFuzzPropertyPlan& PropertyPlan, FBltRandomStream& Stream)
+	{
+		return FromRandom(PropertyPlan, Stream.NextUInt64());
+	}
+
+	// The only edit of a bool that is not a resample
+	static uint64 Perturb(const FBltFuzzPropertyPlan& PropertyPlan, const uint64 Bits, FBltRandomStream& Stream)
+	{
+		return Bits ? 0u : 1u;
+	}
+
+	static uint64 Read(const FBltFuzzPropertyPlan& PropertyPlan, const void* const ValuePtr)
+	{
+		return (static_cast<const uint8*>(ValuePtr)[PropertyPlan.ByteOffset] & PropertyPlan.FieldMask) != 0u;
+	}
+
+	static void Write(const FBltFuzzPropertyPlan& PropertyPlan, void* const ValuePtr, const uint64 Bits)
+	{
+		uint8* const BytePtr = static_cast<uint8*>(ValuePtr) + PropertyPlan.ByteOffset;
+		*BytePtr = static_cast<uint8>((*BytePtr & ~PropertyPlan.FieldMask) | (Bits ? PropertyPlan.ByteMask : 0u));
+	}
+
+	static void Mutate(const FBltFuzzPropertyPlan& PropertyPlan, void* const ValuePtr, FBltRandomStream& Stream)
+	{
+		Write(PropertyPlan, ValuePtr, Sample(PropertyPlan, Stream));
+	}
+};
+
+struct FBltEnumMutator
+{
+	// Same index as FBltRandomStream::RandHelper
+	static uint64 FromRandom(const FBltFuzzPropertyPlan& PropertyPlan, const uint64 Random)
+	{
+		return static_cast<uint64>(PropertyPlan.EnumValues[static_cast<int32>(Random % static_cast<uint64>(PropertyPlan.EnumValues.Num()))]);
+	}
+
+	static uint64 Sample(const FBltFuzzPropertyPlan& PropertyPlan, FBltRandomStream& Stream)
+	{
+		return FromRandom(PropertyPlan, Stream.NextUInt64());
+	}
+
+	// Steps to a neighbouring entry, or resamples a value that is not an entry of the enum
+	static uint64 Perturb(const FBltFuzzPropertyPlan& PropertyPlan, const uint64 Bits, FBltRandomStream& Stream)
+	{
+		const uint64 Mask = PropertyPlan.EnumSize >= sizeof(uint64) ? MAX_uint64 : (1ull << (PropertyPlan.EnumSize * 8u)) - 1u;
+		const int32 Num = PropertyPlan.EnumValues.Num();
+		for (int32 Index = 0; Index < Num; ++Index)
+		{
+			if ((static_cast<uint64>(PropertyPlan.EnumValues[Index]) & Mask) == Bits)
+				return static_cast<uint64>(PropertyPlan.EnumValues[(Index + (Stream.RandHelper(2) ? 1 : Num - 1)) % Num]);
+		}
+
+		return Sample(PropertyPlan, Stream);
+	}
+
+	static uint64 Read(const FBltFuzzPropertyPlan& PropertyPlan, const void* const ValuePtr)
+	{
+		uint64 Bits = 0u;
+		FMemory::Memcpy(&Bits, ValuePtr, PropertyPlan.EnumSize);
+		return Bits;
+	}
+
+	// Little endian truncation of the underlying integer, whatever its width
+	static void Write(const FBltFuzzPropertyPlan& PropertyPlan, void* const ValuePtr, const uint64 Bits)
+	{
+		FMemory::Memcpy(ValuePtr, &Bits, PropertyPlan.EnumSize);
+	}
+
+	static void Mutate(const FBltFuzzPropertyPlan& PropertyPlan, void* const ValuePtr, FBltRandomStream& Stream)
+	{
+		Write(PropertyPlan, ValuePtr, Sample(PropertyPlan, Stream));
+	}
+};
+
+
+struct FBltNumericMutators
+{
+	// All entry points return false for plans that are not numeric, bool or enum
+	static bool Mutate(const FBltFuzzPropertyPlan& PropertyPlan, void* const ValuePtr, FBltRandomStream& Stream)
+	{
+		return Dispatch(PropertyPlan.Type, [&](auto Mutator)
+		{
+			decltype(Mutator)::Mutate(PropertyPlan, ValuePtr, Stream);
+		});
+	}
+
+	static bool Sample(const FBltFuzzPropertyPlan& PropertyPlan, FBltRandomStream& Stream, uint64& OutBits)
+	{
+		return Dispatch(PropertyPlan.Type, [&](auto Mutator)
+		{
+			OutBits = decltype(Mutator)::Sample(PropertyPlan, Stream);
+		});
+	}
+
+	// Mutational strategy: edits OldBits, the value currently in the property, instead of sampling from scratch
+	static bool Perturb(const FBltFuzzPropertyPlan& PropertyPlan, FBltRandomStream& Stream, const uint64 OldBits, uint64& OutBits)
+	{
+		return Dispatch(PropertyPlan.Type, [&](auto Mutator)
+		{
+			OutBits = decltype(Mutator)::Perturb(PropertyPlan, OldBits, Stream);
+		});
+	}
+
+	static bool Read(const FBltFuzzPropertyPlan& PropertyPlan, const void* const ValuePtr, uint64& OutBits)
+	{
+		return Dispatch(PropertyPlan.Type, [&](auto Mutator)
+		{
+			OutBits = decltype(Mutator)::Read(PropertyPlan, ValuePtr);
+		});
+	}
+
+	static bool Write(const FBltFuzzPropertyPlan& PropertyPlan, void* const ValuePtr, const uint64 Bits)
+	{
+		return Dispatch(PropertyPlan.Type, [&](auto Mutator)
+		{
+			decltype(Mutator)::Write(PropertyPlan, ValuePtr, Bits);
+		});
+	}
+
+	// Column kernels: one property over many actors, with the type dispatch hoisted out of the loop.
+	// Random holds the first draw of each actor's stream, see FBltRandomStream::DrawFirst
+	static bool SampleColumn(const FBltFuzzPropertyPlan& PropertyPlan, const uint64* const Random, uint64* const OutBits, const int32 Count)
+	{
+		return Dispatch(PropertyPlan.Type, [&](auto Mutator)
+		{
+			for (int32 Index = 0; Index < Count; ++Index)
+			{
+				OutBits[Index] = decltype(Mutator)::FromRandom(PropertyPlan, Random[Index]);
+			}
+		});
+	}
+
+	// Writes Bits[i] at Offset into Objects[i] and keeps what was there in OutOldBits[i]
+	static bool ScatterColumn(
+		const FBltFuzzPropertyPlan& PropertyPlan,
+		UObject* const* const Objects,
+		const uint64* const Bits,
+		uint64* const OutOldBits,
+		const int32 Count
+	)
+	{
+		const int32 Offset = PropertyPlan.Offset;
+		return Dispatch(PropertyPlan.Type, [&](auto Mutator)
+		{
+			for (int32 Index = 0; Index < Count; ++Index)
+			{
+				void* const ValuePtr = reinterpret_cast<uint8*>(Objects[Index]) + Offset;
+				OutOldBits[Index] = decltype(Mutator)::Read(PropertyPlan, ValuePtr);
+				decltype(Mutator)::Write(PropertyPlan, ValuePtr, Bits[Index]);
+			}
+		});
+	}
+
+private:
+	template <typename FunctorType>
+	static bool Dispatch(const EBltFuzzValueType Type, FunctorType&& Functor)
+	{
+		switch (Type)
+		{
+		case EBltFuzzValueType::Int8:   Functor(TBltNumericMutator<int8>());   return true;
+		case EBltFuzzValueType::Int16:  Functor(TBltNumericMutator<int16>());  return true;
+		case EBltFuzzValueType::Int32:  Functor(TBltNumericMutator<int32>());  return true;
+		case EBltFuzzValueType::Int64:  Functor(TBltNumericMutator<int64>());  return true;
+		case EBltFuzzValueType::UInt8:  Functor(TBltNumericMutator<uint8>());  return true;
+		case EBltFuzzValueType::UInt16: Functor(TBltNumericMutator<uint16>()); return true;
+		case EBltFuzzValueType::UInt32: Functor(TBltNumericMutator<uint32>()); return true;
+		case EBltFuzzValueType::UInt64: Functor(TBltNumericMutator<uint64>()); return true;
+		case EBltFuzzValueType::Float:  Functor(TBltNumericMutator<float>());  return true;
+		case EBltFuzzValueType::Double: Functor(TBltNumericMutator<double>()); return true;
+		case EBltFuzzValueType::Bool:   Functor(TBltNumericMutator<bool>());   return true;
+		case EBltFuzzValueType::Enum:   Functor(FBltEnumMutator());            return true;
+
+		default:
+			return false;
+		}
+	}
+};
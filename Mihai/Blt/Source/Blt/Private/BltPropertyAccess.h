@@ -0,0 +1,84 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "BltFuzzPlan.h"
+
+
+// Walks the access path of a property plan and calls Functor(UObject* Owner, void* ValuePtr, uint32 ValueId) for
+// every value it reaches. Owner is the actor or subobject holding the plan's RootProperty. ValueId is the property
+// id for single values and mixes in the element indices for values inside containers, so every element gets its
+// own random stream and journal entry.
+struct FBltPropertyAccess
+{
+	template <typename FunctorType>
+	static void ForEachValue(AActor* const Actor, const FBltFuzzPropertyPlan& PropertyPlan, FunctorType&& Functor)
+	{
+		if (PropertyPlan.Path.Num() == 0)
+		{
+			Functor(static_cast<UObject*>(Actor), reinterpret_cast<uint8*>(Actor) + PropertyPlan.Offset, PropertyPlan.PropertyId);
+			return;
+		}
+
+		Visit(Actor, PropertyPlan, 0, Actor, reinterpret_cast<uint8*>(Actor), PropertyPlan.PropertyId, Functor);
+	}
+
+private:
+	template <typename FunctorType>
+	static void Visit(
+		const AActor* const Actor,
+		const FBltFuzzPropertyPlan& PropertyPlan,
+		const int32 StepIndex,
+		UObject* const Owner,
+		uint8* const Base,
+		const uint32 ValueId,
+		FunctorType& Functor
+	)
+	{
+		if (StepIndex == PropertyPlan.Path.Num())
+		{
+			Functor(Owner, Base + PropertyPlan.Offset, ValueId);
+			return;
+		}
+
+		const FBltFuzzAccessStep& Step = PropertyPlan.Path[StepIndex];
+		uint8* const StepPtr = Base + Step.Offset;
+		switch (Step.Kind)
+		{
+		case EBltFuzzAccessKind::Object:
+		{
+			// Assets and objects of other actors are shared, only the actor's own subobjects get fuzzed
+			UObject* const Object = *reinterpret_cast<UObject**>(StepPtr);
+			if (Object && Object->IsIn(Actor))
+			{
+				Visit(Actor, PropertyPlan, StepIndex + 1, Object, reinterpret_cast<uint8*>(Object), ValueId, Functor);
+			}
+			break;
+		}
+
+		case EBltFuzzAccessKind::Array:
+		{
+			FScriptArrayHelper Helper(static_cast<const FArrayProperty*>(Step.Property), StepPtr);
+			for (int32 Index = 0; Index < Helper.Num(); ++Index)
+			{
+				Visit(Actor, PropertyPlan, StepIndex + 1, Owner, Helper.GetRawPtr(Index), HashCombine(ValueId, Index), Functor);
+			}
+			break;
+		}
+
+		case EBltFuzzAccessKind::Map:
+		{
+			// Only values are fuzzed, mutated keys would leave duplicates behind
+			FScriptMapHelper Helper(static_cast<const FMapProperty*>(Step.Property), StepPtr);
+			for (int32 Index = 0; Index < Helper.GetMaxIndex(); ++Index)
+			{
+				if (Helper.IsValidIndex(Index))
+				{
+					Visit(Actor, PropertyPlan, StepIndex + 1, Owner, Helper.GetValuePtr(Index), HashCombine(ValueId, Index), Functor);
+				}
+			}
+			break;
+		}
+		}
+	}
+};
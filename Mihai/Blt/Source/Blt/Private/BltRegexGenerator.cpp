@@ -0,0 +1,486 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "BltRegexGenerator.h"
+
+#include "BltBPLibrary.h"
+#include "BltStats.h"
+
+
+namespace
+{
+	// Characters outside this range only appear when written literally in the pattern
+	constexpr int32 CharsetSize = 128;
+	constexpr TCHAR FirstPrintable = TEXT(' ');
+	constexpr TCHAR LastPrintable = TEXT('~');
+
+	// Upper bound used for *, + and {n,} since strgen does not generate unbounded strings either
+	constexpr int32 UnboundedRepeat = 8;
+
+	constexpr int32 MaxReservedLength = 256;
+
+	bool IsWhitespace(const TCHAR Char)
+	{
+		return Char == TEXT(' ') || Char == TEXT('\t') || Char == TEXT('\n')
+			|| Char == TEXT('\r') || Char == TEXT('\f') || Char == TEXT('\v');
+	}
+
+	bool IsWord(const TCHAR Char)
+	{
+		return FChar::IsAlnum(Char) || Char == TEXT('_');
+	}
+
+	bool ParseInteger(const TCHAR*& Cursor, int32& OutValue)
+	{
+		if (!FChar::IsDigit(*Cursor))
+			return false;
+
+		OutValue = 0;
+		while (FChar::IsDigit(*Cursor))
+		{
+			OutValue = OutValue * 10 + (*Cursor++ - TEXT('0'));
+		}
+
+		return true;
+	}
+}
+
+
+FBltRegexGeneratorPtr FBltRegexGenerator::Compile(const FString& Pattern)
+{
+	TSharedRef<FBltRegexGenerator, ESPMode::ThreadSafe> Generator = MakeShared<FBltRegexGenerator, ESPMode::ThreadSafe>();
+	Generator->Pattern = Pattern;
+
+	const TCHAR* Cursor = *Pattern;
+	if (!Generator->ParseGroup(Cursor, Generator->RootGroup) || *Cursor != TEXT('\0'))
+	{
+		UE_LOG(LogBlt, Warning, TEXT("Regex %s is not supported natively, falling back to Python"), *Pattern);
+		return nullptr;
+	}
+
+	return Generator;
+}
+
+void FBltRegexGenerator::Generate(FBltRandomStream& Stream, FString& OutString) const
+{
+	OutString.Reset(FMath::Min(ExpectedLength, MaxReservedLength));
+	GenerateGroup(Groups[RootGroup], Stream, OutString);
+}
+
+void FBltRegexGenerator::GenerateGroup(const FGroup& Group, FBltRandomStream& Stream, FString& OutString) const
+{
+	const TArray<FNode>& Sequence = Group.Alternatives[Stream.RandHelper(Group.Alternatives.Num())];
+	for (const FNode& Node : Sequence)
+	{
+		const int32 Count = Node.Min == Node.Max ? Node.Min : Stream.RandRange(Node.Min, Node.Max);
+		for (int32 Repeat = 0; Repeat < Count; ++Repeat)
+		{
+			switch (Node.Kind)
+			{
+			case ENodeKind::Literal:
+				OutString.AppendChar(Node.Char);
+				break;
+
+			case ENodeKind::Set:
+			{
+				const TArray<TCHAR>& Set = Sets[Node.Index];
+				OutString.AppendChar(Set[Stream.RandHelper(Set.Num())]);
+				break;
+			}
+
+			case ENodeKind::Group:
+				GenerateGroup(Groups[Node.Index], Stream, OutString);
+				break;
+			}
+		}
+	}
+}
+
+bool FBltRegexGenerator::ParseGroup(const TCHAR*& Cursor, int32& OutGroupIndex)
+{
+	OutGroupIndex = Groups.AddDefaulted();
+
+	TArray<TArray<FNode>> Alternatives;
+	for (;;)
+	{
+		TArray<FNode>& Sequence = Alternatives.AddDefaulted_GetRef();
+		if (!ParseSequence(Cursor, Sequence))
+			return false;
+
+		if (*Cursor != TEXT('|'))
+			break;
+
+		++Cursor;
+	}
+
+	Groups[OutGroupIndex].Alternatives = MoveTemp(Alternatives);
+	return true;
+}
+
+bool FBltRegexGenerator::ParseSequence(const TCHAR*& Cursor, TArray<FNode>& OutSequence)
+{
+	while (*Cursor != TEXT('\0') && *Cursor != TEXT('|') && *Cursor != TEXT(')'))
+	{
+		FNode Node;
+		bool bEmitsNothing = false;
+		if (!ParseAtom(Cursor, Node, bEmitsNothing) || !ParseQuantifier(Cursor, Node))
+			return false;
+
+		if (bEmitsNothing)
+			continue;
+
+		ExpectedLength += Node.Max;
+		OutSequence.Add(Node);
+	}
+
+	return true;
+}
+
+bool FBltRegexGenerator::ParseAtom(const TCHAR*& Cursor, FNode& OutNode, bool& bOutEmitsNothing)
+{
+	const TCHAR Char = *Cursor++;
+	switch (Char)
+	{
+	case TEXT('('):
+		// Non-capturing and named groups render the same way; lookarounds, flags and named
+		// backreferences constrain what is around them, so those are left to the Python bridge
+		if (*Cursor == TEXT('?'))
+		{
+			++Cursor;
+			if (*Cursor == TEXT('P'))
+			{
+				++Cursor;
+			}
+
+			if (*Cursor == TEXT('<') && Cursor[1] != TEXT('=') && Cursor[1] != TEXT('!'))
+			{
+				while (*Cursor != TEXT('\0') && *Cursor != TEXT('>'))
+				{
+					++Cursor;
+				}
+			}
+
+			if (*Cursor != TEXT(':') && *Cursor != TEXT('>'))
+				return false;
+
+			++Cursor;
+		}
+
+		OutNode.Kind = ENodeKind::Group;
+		if (!ParseGroup(Cursor, OutNode.Index) || *Cursor != TEXT(')'))
+			return false;
+
+		++Cursor;
+		return true;
+
+	case TEXT('['):
+		return ParseSet(Cursor, OutNode);
+
+	case TEXT('.'):
+	{
+		TArray<bool> Mask;
+		Mask.Init(false, CharsetSize);
+		for (TCHAR Printable = FirstPrintable; Printable <= LastPrintable; ++Printable)
+		{
+			Mask[Printable] = true;
+		}
+
+		OutNode.Kind = ENodeKind::Set;
+		OutNode.Index = AddSet(Mask);
+		return true;
+	}
+
+	case TEXT('^'):
+	case TEXT('$'):
+		bOutEmitsNothing = true;
+		return true;
+
+	case TEXT('\\'):
+	{
+		const TCHAR Escape = *Cursor++;
+		if (Escape == TEXT('\0'))
+			return false;
+
+		TArray<bool> Mask;
+		Mask.Init(false, CharsetSize);
+		if (AddClassEscape(Escape, Mask))
+		{
+			OutNode.Kind = ENodeKind::Set;
+			OutNode.Index = AddSet(Mask);
+			return true;
+		}
+
+		// Anchors, code point escapes and backreferences are left to the Python bridge
+		OutNode.Kind = ENodeKind::Literal;
+		return UnescapeLiteral(Escape, OutNode.Char);
+	}
+
+	case TEXT('*'):
+	case TEXT('+'):
+	case TEXT('?'):
+	case TEXT('{'):
+		return false;
+
+	default:
+		OutNode.Kind = ENodeKind::Literal;
+		OutNode.Char = Char;
+		return true;
+	}
+}
+
+bool FBltRegexGenerator::ParseSet(const TCHAR*& Cursor, FNode& OutNode)
+{
+	TArray<bool> Mask;
+	Mask.Init(false, CharsetSize);
+	TArray<TCHAR> Extra;
+
+	const bool bNegated = *Cursor == TEXT('^');
+	if (bNegated)
+	{
+		++Cursor;
+	}
+
+	bool bFirst = true;
+	while (*Cursor != TEXT(']') || bFirst)
+	{
+		bFirst = false;
+
+		TCHAR Low = *Cursor++;
+		if (Low == TEXT('\0'))
+			return false;
+
+		if (Low == TEXT('\\'))
+		{
+			const TCHAR Escape = *Cursor++;
+			if (Escape == TEXT('\0'))
+				return false;
+
+			if (AddClassEscape(Escape, Mask))
+				continue;
+
+			if (!UnescapeLiteral(Escape, Low))
+				return false;
+		}
+
+		TCHAR High = Low;
+		if (Cursor[0] == TEXT('-') && Cursor[1] != TEXT(']') && Cursor[1] != TEXT('\0'))
+		{
+			if (Cursor[1] == TEXT('\\'))
+			{
+				if (Cursor[2] == TEXT('\0') || !UnescapeLiteral(Cursor[2], High))
+					return false;
+
+				Cursor += 3;
+			}
+			else
+			{
+				High = Cursor[1];
+				Cursor += 2;
+			}
+
+			if (High < Low)
+				return false;
+		}
+
+		for (int32 Member = Low; Member <= High; ++Member)
+		{
+			if (Member < CharsetSize)
+			{
+				Mask[Member] = true;
+			}
+			else
+			{
+				Extra.AddUnique(static_cast<TCHAR>(Member));
+			}
+		}
+	}
+	++Cursor;
+
+	if (bNegated)
+	{
+		for (int32 Member = 0; Member < CharsetSize; ++Member)
+		{
+			Mask[Member] = !Mask[Member] && Member >= FirstPrintable && Member <= LastPrintable;
+		}
+		Extra.Reset();
+	}
+
+	OutNode.Kind = ENodeKind::Set;
+	OutNode.Index = AddSet(Mask);
+	Sets[OutNode.Index].Append(Extra);
+	return Sets[OutNode.Index].Num() > 0;
+}
+
+bool FBltRegexGenerator::ParseQuantifier(const TCHAR*& Cursor, FNode& OutNode)
+{
+	switch (*Cursor)
+	{
+	case TEXT('*'):
+		OutNode.Min = 0;
+		OutNode.Max = UnboundedRepeat;
+		++Cursor;
+		break;
+
+	case TEXT('+'):
+		OutNode.Min = 1;
+		OutNode.Max = 1 + UnboundedRepeat;
+		++Cursor;
+		break;
+
+	case TEXT('?'):
+		OutNode.Min = 0;
+		OutNode.Max = 1;
+		++Cursor;
+		break;
+
+	case TEXT('{'):
+	{
+		// Accepts {n}, {n,m}, {n,}, {,m} and the strgen flavours {n:m}, {:m} and {n-m}
+		++Cursor;
+		const bool bHasMin = ParseInteger(Cursor, OutNode.Min);
+		if (!bHasMin)
+		{
+			OutNode.Min = 0;
+		}
+
+		OutNode.Max = OutNode.Min;
+		if (*Cursor == TEXT(',') || *Cursor == TEXT(':') || *Cursor == TEXT('-'))
+		{
+			++Cursor;
+			if (!ParseInteger(Cursor, OutNode.Max))
+			{
+				OutNode.Max = OutNode.Min + UnboundedRepeat;
+			}
+		}
+		else if (!bHasMin)
+		{
+			return false;
+		}
+
+		if (*Cursor != TEXT('}') || OutNode.Max < OutNode.Min)
+			return false;
+
+		++Cursor;
+		break;
+	}
+
+	default:
+		return true;
+	}
+
+	// Lazy and possessive modifiers do not change what can be generated
+	if (*Cursor == TEXT('?') || *Cursor == TEXT('+'))
+	{
+		++Cursor;
+	}
+
+	return true;
+}
+
+int32 FBltRegexGenerator::AddSet(const TArray<bool>& Mask)
+{
+	TArray<TCHAR>& Set = Sets.AddDefaulted_GetRef();
+	for (int32 Member = 0; Member < CharsetSize; ++Member)
+	{
+		if (Mask[Member])
+		{
+			Set.Add(static_cast<TCHAR>(Member));
+		}
+	}
+
+	return Sets.Num() - 1;
+}
+
+bool FBltRegexGenerator::AddClassEscape(const TCHAR Escape, TArray<bool>& Mask)
+{
+	bool (*Predicate)(TCHAR) = nullptr;
+	switch (FChar::ToLower(Escape))
+	{
+	case TEXT('d'):
+		Predicate = [](const TCHAR Char) { return FChar::IsDigit(Char); };
+		break;
+
+	case TEXT('w'):
+		Predicate = [](const TCHAR Char) { return IsWord(Char); };
+		break;
+
+	case TEXT('s'):
+		Predicate = [](const TCHAR Char) { return IsWhitespace(Char); };
+		break;
+
+	default:
+		return false;
+	}
+
+	const bool bNegated = FChar::IsUpper(Escape);
+	for (int32 Member = 0; Member < CharsetSize; ++Member)
+	{
+		const TCHAR Char = static_cast<TCHAR>(Member);
+		const bool bIsPrintable = Char >= FirstPrintable && Char <= LastPrintable;
+		if (bNegated ? bIsPrintable && !Predicate(Char) : Predicate(Char))
+		{
+			Mask[Member] = true;
+		}
+	}
+
+	return true;
+}
+
+bool FBltRegexGenerator::UnescapeLiteral(const TCHAR Escape, TCHAR& OutChar)
+{
+	switch (Escape)
+	{
+	case TEXT('n'):
+		OutChar = TEXT('\n');
+		return true;
+
+	case TEXT('t'):
+		OutChar = TEXT('\t');
+		return true;
+
+	case TEXT('r'):
+		OutChar = TEXT('\r');
+		return true;
+
+	case TEXT('f'):
+		OutChar = TEXT('\f');
+		return true;
+
+	case TEXT('v'):
+		OutChar = TEXT('\v');
+		return true;
+
+	default:
+		// Escaped punctuation stands for itself
+		OutChar = Escape;
+		return !FChar::IsAlnum(Escape);
+	}
+}
+
+
+FBltRegexCache& FBltRegexCache::Get()
+{
+	static FBltRegexCache Cache;
+	return Cache;
+}
+
+FBltRegexGeneratorPtr FBltRegexCache::FindOrCompile(const FString& Pattern)
+{
+	{
+		FReadScopeLock ReadLock(Lock);
+		if (const FBltRegexGeneratorPtr* const Generator = Generators.Find(Pattern))
+		{
+			INC_DWORD_STAT(STAT_BltRegexCacheHits);
+			return *Generator;
+		}
+	}
+
+	INC_DWORD_STAT(STAT_BltRegexCacheMisses);
+
+	const FBltRegexGeneratorPtr Generator = FBltRegexGenerator::Compile(Pattern);
+
+	FWriteScopeLock WriteLock(Lock);
+	if (const FBltRegexGeneratorPtr* const Existing = Generators.Find(Pattern))
+		return *Existing;
+
+	return Generators.Add(Pattern, Generator);
+}
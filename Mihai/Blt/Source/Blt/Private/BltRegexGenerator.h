@@ -0,0 +1,76 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "BltRandom.h"
+
+
+// Native replacement of strgen: a regex is compiled once into a tree of character sets,
+// literals and alternation groups which is then walked to render random matching strings
+class FBltRegexGenerator
+{
+public:
+	static TSharedPtr<const FBltRegexGenerator, ESPMode::ThreadSafe> Compile(const FString& Pattern);
+
+	void Generate(FBltRandomStream& Stream, FString& OutString) const;
+
+	const FString& GetPattern() const { return Pattern; }
+
+private:
+	enum class ENodeKind : uint8
+	{
+		Literal,
+		Set,
+		Group
+	};
+
+	struct FNode
+	{
+		ENodeKind Kind = ENodeKind::Literal;
+		TCHAR Char = 0;
+		int32 Index = INDEX_NONE;
+		int32 Min = 1;
+		int32 Max = 1;
+	};
+
+	struct FGroup
+	{
+		TArray<TArray<FNode>> Alternatives;
+	};
+
+	bool ParseGroup(const TCHAR*& Cursor, int32& OutGroupIndex);
+	bool ParseSequence(const TCHAR*& Cursor, TArray<FNode>& OutSequence);
+	bool ParseAtom(const TCHAR*& Cursor, FNode& OutNode, bool& bOutEmitsNothing);
+	bool ParseSet(const TCHAR*& Cursor, FNode& OutNode);
+	bool ParseQuantifier(const TCHAR*& Cursor, FNode& OutNode);
+
+	int32 AddSet(const TArray<bool>& Mask);
+	static bool AddClassEscape(const TCHAR Escape, TArray<bool>& Mask);
+
+	// False for letter and digit escapes without a literal meaning, such as \b, \A, \x41, \p{L} or backreferences
+	static bool UnescapeLiteral(const TCHAR Escape, TCHAR& OutChar);
+
+	void GenerateGroup(const FGroup& Group, FBltRandomStream& Stream, FString& OutString) const;
+
+	FString Pattern;
+	TArray<TArray<TCHAR>> Sets;
+	TArray<FGroup> Groups;
+	int32 RootGroup = INDEX_NONE;
+	int32 ExpectedLength = 0;
+};
+
+using FBltRegexGeneratorPtr = TSharedPtr<const FBltRegexGenerator, ESPMode::ThreadSafe>;
+
+
+// Patterns are compiled at most once per process, failed ones included
+class FBltRegexCache
+{
+public:
+	static FBltRegexCache& Get();
+
+	FBltRegexGeneratorPtr FindOrCompile(const FString& Pattern);
+
+private:
+	FRWLock Lock;
+	TMap<FString, FBltRegexGeneratorPtr> Generators;
+};
@@ -0,0 +1,190 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "BltRestoreJournal.h"
+
+#include "BltBPLibrary.h"
+#include "BltClassSchema.h"
+
+
+FBltRestoreJournal& FBltRestoreJournal::Get()
+{
+	static FBltRestoreJournal Journal;
+	return Journal;
+}
+
+FBltRestoreJournal::~FBltRestoreJournal()
+{
+	// Property objects may already be gone during static destruction
+	Entries.Empty();
+}
+
+void FBltRestoreJournal::Capture(UObject* const Object, const FProperty* const Property)
+{
+	check(IsInGameThread());
+
+	const uint32 CurrentGeneration = FBltClassSchemaCache::Get().GetGeneration();
+	if (SchemaGeneration != CurrentGeneration)
+	{
+		if (Entries.Num() > 0)
+		{
+			UE_LOG(LogBlt, Warning, TEXT("Classes were reloaded, %d fuzzed values can no longer be restored"), Entries.Num());
+		}
+
+		DestroyEntries(false);
+		SchemaGeneration = CurrentGeneration;
+	}
+
+	bool bAlreadyCaptured = false;
+	Captured.Add(TPair<FObjectKey, const FProperty*>(Object, Property), &bAlreadyCaptured);
+	if (bAlreadyCaptured)
+		return;
+
+	const int32 Offset = Property->GetOffset_ForInternal();
+	const uint8* const ValuePtr = reinterpret_cast<const uint8*>(Object) + Offset;
+
+	FEntry& Entry = Entries.AddDefaulted_GetRef();
+	Entry.Object = Object;
+	Entry.Property = Property;
+	Entry.Offset = Offset;
+
+	if (const FBoolProperty* const BoolProperty = CastField<const FBoolProperty>(Property))
+	{
+		Entry.Offset += BoolProperty->GetByteOffset();
+		Entry.Size = 1;
+		Entry.FieldMask = BoolProperty->GetFieldMask();
+		Entry.bPlainOldData = true;
+		Entry.Storage = Allocate(1, 1);
+		*Entry.Storage = ValuePtr[BoolProperty->GetByteOffset()];
+		return;
+	}
+
+	Entry.Size = Property->GetSize();
+	Entry.bPlainOldData = Property->HasAnyPropertyFlags(CPF_IsPlainOldData);
+	if (Entry.Size > BlockSize)
+	{
+		Entry.LargeStorage = MakeUnique<uint8[]>(Entry.Size);
+		Entry.Storage = Entry.LargeStorage.Get();
+	}
+	else
+	{
+		Entry.Storage = Allocate(Entry.Size, Property->GetMinAlignment());
+	}
+	if (Entry.bPlainOldData)
+	{
+		FMemory::Memcpy(Entry.Storage, ValuePtr, Entry.Size);
+	}
+	else
+	{
+		Property->InitializeValue(Entry.Storage);
+		Property->CopyCompleteValue(Entry.Storage, ValuePtr);
+	}
+}
+
+int32 FBltRestoreJournal::Restore()
+{
+	check(IsInGameThread());
+
+	const bool bPropertiesValid = SchemaGeneration == FBltClassSchemaCache::Get().GetGeneration();
+	int32 RestoredCount = 0;
+	for (int32 EntryIndex = Entries.Num() - 1; bPropertiesValid && EntryIndex >= 0; --EntryIndex)
+	{
+		const FEntry& Entry = Entries[EntryIndex];
+		UObject* const Object = Entry.Object.Get();
+		if (!Object || Object->IsPendingKill())
+			continue;
+
+		uint8* const ValuePtr = reinterpret_cast<uint8*>(Object) + Entry.Offset;
+		if (Entry.FieldMask != 0u)
+		{
+			*ValuePtr = static_cast<uint8>((*ValuePtr & ~Entry.FieldMask) | (*Entry.Storage & Entry.FieldMask));
+		}
+		else if (Entry.bPlainOldData)
+		{
+			FMemory::Memcpy(ValuePtr, Entry.Storage, Entry.Size);
+		}
+		else
+		{
+			Entry.Property->CopyCompleteValue(ValuePtr, Entry.Storage);
+		}
+
+		++RestoredCount;
+	}
+
+	DestroyEntries(bPropertiesValid);
+	return RestoredCount;
+}
+
+void FBltRestoreJournal::Reset(const UWorld* const World)
+{
+	const bool bPropertiesValid = SchemaGeneration == FBltClassSchemaCache::Get().GetGeneration();
+	if (!World || !bPropertiesValid)
+	{
+		DestroyEntries(bPropertiesValid);
+		return;
+	}
+
+	Captured.Reset();
+	Entries.RemoveAll([this, World](const FEntry& Entry)
+	{
+		const UObject* const Object = Entry.Object.Get();
+		if (Object && Object->GetWorld() != World)
+		{
+			Captured.Add(TPair<FObjectKey, const FProperty*>(Object, Entry.Property));
+			return false;
+		}
+
+		if (!Entry.bPlainOldData)
+		{
+			Entry.Property->DestroyValue(Entry.Storage);
+		}
+		return true;
+	});
+
+	// Storage of the remaining entries stays where it is, the arena only rewinds once nothing is left
+	if (Entries.Num() == 0)
+	{
+		CurrentBlock = 0;
+		BlockOffset = 0;
+	}
+}
+
+uint8* FBltRestoreJournal::Allocate(const int32 Size, const int32 Alignment)
+{
+	check(Size <= BlockSize);
+
+	int32 Offset = Align(BlockOffset, Alignment);
+	if (Blocks.Num() == 0 || Offset + Size > BlockSize)
+	{
+		// Blocks are kept between restores, so steady fuzz/restore loops stop allocating
+		const int32 NextBlock = Blocks.Num() == 0 ? 0 : CurrentBlock + 1;
+		if (NextBlock == Blocks.Num())
+		{
+			Blocks.Add(MakeUnique<uint8[]>(BlockSize));
+		}
+
+		CurrentBlock = NextBlock;
+		Offset = 0;
+	}
+
+	BlockOffset = Offset + Size;
+	return Blocks[CurrentBlock].Get() + Offset;
+}
+
+void FBltRestoreJournal::DestroyEntries(const bool bPropertiesValid)
+{
+	if (bPropertiesValid)
+	{
+		for (const FEntry& Entry : Entries)
+		{
+			if (!Entry.bPlainOldData)
+			{
+				Entry.Property->DestroyValue(Entry.Storage);
+			}
+		}
+	}
+
+	Entries.Reset();
+	Captured.Reset();
+	CurrentBlock = 0;
+	BlockOffset = 0;
+}
@@ -0,0 +1,281 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "BltSchemaSnapshot.h"
+
+#include "Async/MappedFileHandle.h"
+#include "BltBPLibrary.h"
+
+
+namespace
+{
+	constexpr uint32 SnapshotMagic = 0x53544C42u; // "BLTS"
+	constexpr uint32 SnapshotVersion = 1u;
+
+	uint32 GetBucket(const uint64 ClassHash, const uint32 BucketCount)
+	{
+		return static_cast<uint32>(ClassHash ^ ClassHash >> 32u) & (BucketCount - 1u);
+	}
+}
+
+
+FBltSchemaSnapshot& FBltSchemaSnapshot::Get()
+{
+	static FBltSchemaSnapshot Snapshot;
+	return Snapshot;
+}
+
+FString FBltSchemaSnapshot::GetDefaultPath()
+{
+	return FPaths::ProjectContentDir() + "Data\\propertySnapshot.bin";
+}
+
+FBltSchemaSnapshot::~FBltSchemaSnapshot()
+{
+	Close();
+}
+
+bool FBltSchemaSnapshot::Open(const FString& InFilePath)
+{
+	Close();
+	FilePath = InFilePath;
+
+	IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+	if (!PlatformFile.FileExists(*FilePath))
+		return false;
+
+	MappedFile.Reset(PlatformFile.OpenMapped(*FilePath));
+	if (MappedFile)
+	{
+		MappedRegion.Reset(MappedFile->MapRegion());
+	}
+
+	const bool bBound = MappedRegion
+		? BindData(MappedRegion->GetMappedPtr(), MappedRegion->GetMappedSize())
+		: FFileHelper::LoadFileToArray(LoadedBytes, *FilePath) && BindData(LoadedBytes.GetData(), LoadedBytes.Num());
+
+	if (!bBound)
+	{
+		UE_LOG(LogBlt, Warning, TEXT("%s is not a valid property snapshot, starting a new one"), *FilePath);
+		Close();
+		FilePath = InFilePath;
+		return false;
+	}
+
+	return true;
+}
+
+void FBltSchemaSnapshot::Close()
+{
+	Header = nullptr;
+	Buckets = nullptr;
+	Classes = nullptr;
+	Layouts = nullptr;
+
+	MappedRegion.Reset();
+	MappedFile.Reset();
+	LoadedBytes.Empty();
+}
+
+bool FBltSchemaSnapshot::BindData(const uint8* const InData, const int64 InSize)
+{
+	if (InSize < static_cast<int64>(sizeof(FHeader)))
+		return false;
+
+	const FHeader* const InHeader = reinterpret_cast<const FHeader*>(InData);
+	if (InHeader->Magic != SnapshotMagic || InHeader->Version != SnapshotVersion
+		|| !FMath::IsPowerOfTwo(InHeader->BucketCount))
+	{
+		return false;
+	}
+
+	const int64 ExpectedSize = sizeof(FHeader)
+		+ static_cast<int64>(InHeader->BucketCount) * sizeof(int32)
+		+ static_cast<int64>(InHeader->ClassCount) * sizeof(FClassEntry)
+		+ static_cast<int64>(InHeader->LayoutCount) * sizeof(FBltSchemaLayoutEntry);
+	if (InSize != ExpectedSize)
+		return false;
+
+	Header = InHeader;
+	Buckets = reinterpret_cast<const int32*>(Header + 1);
+	Classes = reinterpret_cast<const FClassEntry*>(Buckets + Header->BucketCount);
+	Layouts = reinterpret_cast<const FBltSchemaLayoutEntry*>(Classes + Header->ClassCount);
+	return true;
+}
+
+bool FBltSchemaSnapshot::FindStored(const uint64 ClassHash, FStoredClass& OutStored) const
+{
+	if (const FPendingClass* const Pending = PendingClasses.Find(ClassHash))
+	{
+		OutStored.Fingerprint = Pending->Fingerprint;
+		OutStored.Layout = Pending->Layout;
+		return true;
+	}
+
+	if (!Header || Header->ClassCount == 0u)
+		return false;
+
+	uint32 Bucket = GetBucket(ClassHash, Header->BucketCount);
+	for (uint32 Probe = 0u; Probe < Header->BucketCount; ++Probe, Bucket = (Bucket + 1u) & (Header->BucketCount - 1u))
+	{
+		const int32 ClassIndex = Buckets[Bucket];
+		if (ClassIndex < 0 || static_cast<uint32>(ClassIndex) >= Header->ClassCount)
+			return false;
+
+		const FClassEntry& ClassEntry = Classes[ClassIndex];
+		if (ClassEntry.ClassHash != ClassHash)
+			continue;
+
+		if (static_cast<uint64>(ClassEntry.FirstLayout) + ClassEntry.LayoutCount > Header->LayoutCount)
+			return false;
+
+		OutStored.Fingerprint = ClassEntry.Fingerprint;
+		OutStored.Layout = MakeArrayView(Layouts + ClassEntry.FirstLayout, ClassEntry.LayoutCount);
+		return true;
+	}
+
+	return false;
+}
+
+bool FBltSchemaSnapshot::HasChanged(const FBltClassSchema& Schema) const
+{
+	FStoredClass Stored;
+	return !FindStored(Schema.ClassHash, Stored) || Stored.Fingerprint != Schema.Fingerprint;
+}
+
+void FBltSchemaSnapshot::Diff(
+	const FBltClassSchema& Schema,
+	TArray<const FProperty*>& OutAddedProperties,
+	int32& OutRemovedCount
+) const
+{
+	OutRemovedCount = 0;
+
+	FStoredClass Stored;
+	FindStored(Schema.ClassHash, Stored);
+
+	// Layout is sorted by name hash but Properties keeps the reflection order, so map back by hash
+	TMap<uint64, const FProperty*> PropertiesByHash;
+	PropertiesByHash.Reserve(Schema.Properties.Num());
+	for (const FBltSchemaProperty& SchemaProperty : Schema.Properties)
+	{
+		PropertiesByHash.Add(FBltClassSchemaCache::HashString(SchemaProperty.Property->GetName()), SchemaProperty.Property);
+	}
+
+	int32 CurrentIndex = 0;
+	int32 StoredIndex = 0;
+	while (CurrentIndex < Schema.Layout.Num() || StoredIndex < Stored.Layout.Num())
+	{
+		const bool bHasCurrent = CurrentIndex < Schema.Layout.Num();
+		const bool bHasStored = StoredIndex < Stored.Layout.Num();
+
+		if (bHasCurrent && bHasStored && Schema.Layout[CurrentIndex].NameHash == Stored.Layout[StoredIndex].NameHash)
+		{
+			++CurrentIndex;
+			++StoredIndex;
+		}
+		else if (bHasCurrent && (!bHasStored || Schema.Layout[CurrentIndex].NameHash < Stored.Layout[StoredIndex].NameHash))
+		{
+			if (const FProperty* const* const Property = PropertiesByHash.Find(Schema.Layout[CurrentIndex].NameHash))
+			{
+				OutAddedProperties.Add(*Property);
+			}
+			++CurrentIndex;
+		}
+		else
+		{
+			++OutRemovedCount;
+			++StoredIndex;
+		}
+	}
+}
+
+void FBltSchemaSnapshot::Update(const FBltClassSchema& Schema)
+{
+	FPendingClass& Pending = PendingClasses.FindOrAdd(Schema.ClassHash);
+	Pending.Fingerprint = Schema.Fingerprint;
+	Pending.Layout = Schema.Layout;
+}
+
+bool FBltSchemaSnapshot::Flush()
+{
+	if (PendingClasses.Num() == 0 || FilePath.IsEmpty())
+		return true;
+
+	TArray<FClassEntry> MergedClasses;
+	TArray<FBltSchemaLayoutEntry> MergedLayouts;
+
+	const auto AddClass = [&MergedClasses, &MergedLayouts](
+		const uint64 ClassHash,
+		const uint64 Fingerprint,
+		const TArrayView<const FBltSchemaLayoutEntry> Layout)
+	{
+		FClassEntry& ClassEntry = MergedClasses.AddDefaulted_GetRef();
+		ClassEntry.ClassHash = ClassHash;
+		ClassEntry.Fingerprint = Fingerprint;
+		ClassEntry.FirstLayout = MergedLayouts.Num();
+		ClassEntry.LayoutCount = Layout.Num();
+		MergedLayouts.Append(Layout.GetData(), Layout.Num());
+	};
+
+	for (uint32 ClassIndex = 0u; Header && ClassIndex < Header->ClassCount; ++ClassIndex)
+	{
+		const FClassEntry& ClassEntry = Classes[ClassIndex];
+		if (!PendingClasses.Contains(ClassEntry.ClassHash))
+		{
+			AddClass(ClassEntry.ClassHash, ClassEntry.Fingerprint, MakeArrayView(Layouts + ClassEntry.FirstLayout, ClassEntry.LayoutCount));
+		}
+	}
+
+	for (const TTuple<uint64, FPendingClass>& Pending : PendingClasses)
+	{
+		AddClass(Pending.Key, Pending.Value.Fingerprint, Pending.Value.Layout);
+	}
+
+	FHeader NewHeader;
+	NewHeader.Magic = SnapshotMagic;
+	NewHeader.Version = SnapshotVersion;
+	NewHeader.BucketCount = FMath::RoundUpToPowerOfTwo(FMath::Max(2u, static_cast<uint32>(MergedClasses.Num()) * 2u));
+	NewHeader.ClassCount = MergedClasses.Num();
+	NewHeader.LayoutCount = MergedLayouts.Num();
+
+	TArray<int32> NewBuckets;
+	NewBuckets.Init(INDEX_NONE, NewHeader.BucketCount);
+	for (int32 ClassIndex = 0; ClassIndex < MergedClasses.Num(); ++ClassIndex)
+	{
+		uint32 Bucket = GetBucket(MergedClasses[ClassIndex].ClassHash, NewHeader.BucketCount);
+		while (NewBuckets[Bucket] != INDEX_NONE)
+		{
+			Bucket = (Bucket + 1u) & (NewHeader.BucketCount - 1u);
+		}
+		NewBuckets[Bucket] = ClassIndex;
+	}
+
+	TArray<uint8> Bytes;
+	Bytes.Append(reinterpret_cast<const uint8*>(&NewHeader), sizeof(FHeader));
+	Bytes.Append(reinterpret_cast<const uint8*>(NewBuckets.GetData()), NewBuckets.Num() * sizeof(int32));
+	Bytes.Append(reinterpret_cast<const uint8*>(MergedClasses.GetData()), MergedClasses.Num() * sizeof(FClassEntry));
+	Bytes.Append(reinterpret_cast<const uint8*>(MergedLayouts.GetData()), MergedLayouts.Num() * sizeof(FBltSchemaLayoutEntry));
+
+	// The mapping has to go before the file can be replaced
+	const FString TargetPath = FilePath;
+	const FString TempPath = TargetPath + TEXT(".tmp");
+	if (!FFileHelper::SaveArrayToFile(Bytes, *TempPath))
+	{
+		UE_LOG(LogBlt, Error, TEXT("Could not write property snapshot %s"), *TempPath);
+		return false;
+	}
+
+	Close();
+	if (!IFileManager::Get().Move(*TargetPath, *TempPath, true, true))
+	{
+		// The old file is still in place, so are the updates it misses; the next Flush tries again
+		UE_LOG(LogBlt, Error, TEXT("Could not replace property snapshot %s"), *TargetPath);
+		IFileManager::Get().Delete(*TempPath);
+		Open(TargetPath);
+		return false;
+	}
+
+	PendingClasses.Empty();
+	Open(TargetPath);
+	return true;
+}
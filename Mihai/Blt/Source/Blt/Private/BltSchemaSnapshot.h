@@ -0,0 +1,89 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "BltClassSchema.h"
+
+class IMappedFileHandle;
+class IMappedFileRegion;
+
+
+// Binary record of every class layout seen so far, used to detect new properties across sessions.
+// The file is memory mapped and only the pages that get looked at are ever read, so opening it costs
+// the same with ten classes or a thousand. Layout of Data/propertySnapshot.bin:
+//   FHeader
+//   int32 Buckets[BucketCount]            open addressing table of class indices, -1 when empty
+//   FClassEntry Classes[ClassCount]
+//   FBltSchemaLayoutEntry Layout[...]     per class, sorted by name hash
+class FBltSchemaSnapshot
+{
+public:
+	static FBltSchemaSnapshot& Get();
+	static FString GetDefaultPath();
+
+	~FBltSchemaSnapshot();
+
+	bool Open(const FString& InFilePath);
+	void Close();
+
+	// Writes the mapped classes merged with every Update since Open
+	bool Flush();
+
+	// O(1) fingerprint comparison; classes missing from the snapshot count as changed
+	bool HasChanged(const FBltClassSchema& Schema) const;
+
+	// Sorted merge of the current layout against the stored one
+	void Diff(
+		const FBltClassSchema& Schema,
+		TArray<const FProperty*>& OutAddedProperties,
+		int32& OutRemovedCount
+	) const;
+
+	void Update(const FBltClassSchema& Schema);
+
+private:
+	struct FHeader
+	{
+		uint32 Magic = 0u;
+		uint32 Version = 0u;
+		uint32 BucketCount = 0u;
+		uint32 ClassCount = 0u;
+		uint32 LayoutCount = 0u;
+		uint32 Padding = 0u;
+	};
+
+	struct FClassEntry
+	{
+		uint64 ClassHash = 0u;
+		uint64 Fingerprint = 0u;
+		uint32 FirstLayout = 0u;
+		uint32 LayoutCount = 0u;
+	};
+
+	struct FStoredClass
+	{
+		uint64 Fingerprint = 0u;
+		TArrayView<const FBltSchemaLayoutEntry> Layout;
+	};
+
+	struct FPendingClass
+	{
+		uint64 Fingerprint = 0u;
+		TArray<FBltSchemaLayoutEntry> Layout;
+	};
+
+	bool FindStored(const uint64 ClassHash, FStoredClass& OutStored) const;
+	bool BindData(const uint8* const InData, const int64 InSize);
+
+	FString FilePath;
+	TUniquePtr<IMappedFileHandle> MappedFile;
+	TUniquePtr<IMappedFileRegion> MappedRegion;
+	TArray<uint8> LoadedBytes;
+
+	const FHeader* Header = nullptr;
+	const int32* Buckets = nullptr;
+	const FClassEntry* Classes = nullptr;
+	const FBltSchemaLayoutEntry* Layouts = nullptr;
+
+	TMap<uint64, FPendingClass> PendingClasses;
+};
@@ -0,0 +1,86 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "BltStateFeedback.h"
+
+#include "BltRandom.h"
+#include "BltStateProbe.h"
+#include "EngineUtils.h"
+#include "UObject/Script.h"
+
+
+namespace
+{
+	// AFL hit count buckets: 1, 2, 3, 4-7, 8-15, 16-31, 32-127, 128+
+	uint32 GetHitBucket(const uint32 Hits)
+	{
+		return Hits <= 3u ? Hits - 1u : Hits <= 7u ? 3u : Hits <= 15u ? 4u : Hits <= 31u ? 5u : Hits <= 127u ? 6u : 7u;
+	}
+
+	// Probe features live in their own half of the feature space
+	constexpr uint32 ProbeFeatureBit = 1u << 31u;
+}
+
+
+FBltStateFeedback::~FBltStateFeedback()
+{
+	End();
+}
+
+void FBltStateFeedback::Begin(UWorld* const InWorld)
+{
+	World = InWorld;
+	EdgeHits.Reset();
+	PreviousLocation = 0u;
+
+	ScriptEventHandle = FBlueprintCoreDelegates::OnScriptProfilingEvent.AddRaw(this, &FBltStateFeedback::OnScriptEvent);
+}
+
+void FBltStateFeedback::End()
+{
+	FBlueprintCoreDelegates::OnScriptProfilingEvent.Remove(ScriptEventHandle);
+	ScriptEventHandle.Reset();
+}
+
+void FBltStateFeedback::Collect(TArray<uint32>& OutFeatures)
+{
+	OutFeatures.Reset(EdgeHits.Num());
+	for (const TPair<uint32, uint32>& Pair : EdgeHits)
+	{
+		OutFeatures.Add(((Pair.Key << 3u) | GetHitBucket(Pair.Value)) & ~ProbeFeatureBit);
+	}
+
+	EdgeHits.Reset();
+	PreviousLocation = 0u;
+
+	UWorld* const CurrentWorld = World.Get();
+	if (!CurrentWorld)
+		return;
+
+	for (TActorIterator<AActor> Iterator(CurrentWorld); Iterator; ++Iterator)
+	{
+		AActor* const Actor = *Iterator;
+		if (!Actor->Implements<UBltStateProbe>())
+			continue;
+
+		const int64 State = IBltStateProbe::Execute_GetProbeState(Actor);
+		const uint32 ClassHash = FBltRandomStream::HashObject(Actor->GetClass());
+		OutFeatures.Add(HashCombine(ClassHash, GetTypeHash(State)) | ProbeFeatureBit);
+	}
+}
+
+void FBltStateFeedback::OnScriptEvent(const FScriptInstrumentationSignal& Signal)
+{
+	// Other worlds of the process fire the same delegate
+	const UObject* const ContextObject = Signal.GetContextObject();
+	if (!ContextObject || ContextObject->GetWorld() != World.Get())
+		return;
+
+	const UClass* const FunctionClass = Signal.GetFunctionClassScope();
+	const uint32 Location = HashCombine(
+		HashCombine(FunctionClass ? FBltRandomStream::HashObject(FunctionClass) : 0u, FBltRandomStream::HashName(Signal.GetFunctionName())),
+		static_cast<uint32>(Signal.GetScriptCodeOffset())
+	);
+
+	++EdgeHits.FindOrAdd(Location ^ PreviousLocation);
+	PreviousLocation = Location >> 1u;
+}
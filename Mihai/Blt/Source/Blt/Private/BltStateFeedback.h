@@ -0,0 +1,30 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+struct FScriptInstrumentationSignal;
+
+
+// State features reached by the iterations of one world, for the guided mode. Blueprint coverage
+// comes from the VM instrumentation events, hashed into edges between consecutive nodes and
+// bucketed by hit count the way AFL does; the VM only raises them for Blueprints compiled with
+// instrumentation. Actors implementing IBltStateProbe add one feature per distinct reported value.
+class FBltStateFeedback
+{
+public:
+	~FBltStateFeedback();
+
+	void Begin(UWorld* const InWorld);
+	void End();
+
+	// Features since the previous call; the next iteration starts counting from zero
+	void Collect(TArray<uint32>& OutFeatures);
+
+private:
+	void OnScriptEvent(const FScriptInstrumentationSignal& Signal);
+
+	TWeakObjectPtr<UWorld> World;
+	TMap<uint32, uint32> EdgeHits;
+	uint32 PreviousLocation = 0u;
+	FDelegateHandle ScriptEventHandle;
+};
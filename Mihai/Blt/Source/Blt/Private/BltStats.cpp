@@ -0,0 +1,67 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "BltStats.h"
+
+#include "Containers/Ticker.h"
+
+
+DEFINE_STAT(STAT_BltSpecLoad);
+DEFINE_STAT(STAT_BltActorIndexBuild);
+DEFINE_STAT(STAT_BltActorLookup);
+DEFINE_STAT(STAT_BltPlanResolve);
+DEFINE_STAT(STAT_BltRandomiseProperties);
+DEFINE_STAT(STAT_BltNumericMutator);
+DEFINE_STAT(STAT_BltStringMutator);
+DEFINE_STAT(STAT_BltPythonBridge);
+DEFINE_STAT(STAT_BltBatchCompute);
+DEFINE_STAT(STAT_BltBatchCommit);
+DEFINE_STAT(STAT_BltCheckpointCapture);
+DEFINE_STAT(STAT_BltCheckpointReset);
+
+DEFINE_STAT(STAT_BltMutations);
+DEFINE_STAT(STAT_BltMutationsPerSecond);
+DEFINE_STAT(STAT_BltStringsGenerated);
+DEFINE_STAT(STAT_BltBytesWritten);
+DEFINE_STAT(STAT_BltPlanCacheHits);
+DEFINE_STAT(STAT_BltPlanCacheMisses);
+DEFINE_STAT(STAT_BltSchemaCacheHits);
+DEFINE_STAT(STAT_BltSchemaCacheMisses);
+DEFINE_STAT(STAT_BltRegexCacheHits);
+DEFINE_STAT(STAT_BltRegexCacheMisses);
+DEFINE_STAT(STAT_BltNamePoolSize);
+DEFINE_STAT(STAT_BltNamePoolHits);
+DEFINE_STAT(STAT_BltNamePoolMisses);
+DEFINE_STAT(STAT_BltNamePoolHitRate);
+
+#if STATS
+
+std::atomic<uint64> FBltStats::PendingMutations{0u};
+std::atomic<uint64> FBltStats::PendingNameHits{0u};
+std::atomic<uint64> FBltStats::PendingNameLookups{0u};
+FDelegateHandle FBltStats::TickerHandle;
+thread_local FBltStats::FScopedMutationBatch* FBltStats::ActiveBatch = nullptr;
+
+void FBltStats::RegisterTicker()
+{
+	TickerHandle = FTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateLambda([](const float DeltaTime)
+	{
+		const uint64 Mutations = PendingMutations.exchange(0u, std::memory_order_relaxed);
+		SET_FLOAT_STAT(STAT_BltMutationsPerSecond, DeltaTime > 0.f ? Mutations / DeltaTime : 0.f);
+
+		// Frames without name lookups keep the last rate
+		const uint64 NameLookups = PendingNameLookups.exchange(0u, std::memory_order_relaxed);
+		const uint64 NameHits = PendingNameHits.exchange(0u, std::memory_order_relaxed);
+		if (NameLookups > 0u)
+		{
+			SET_FLOAT_STAT(STAT_BltNamePoolHitRate, static_cast<float>(NameHits) / NameLookups);
+		}
+		return true;
+	}));
+}
+
+void FBltStats::UnregisterTicker()
+{
+	FTicker::GetCoreTicker().RemoveTicker(TickerHandle);
+}
+
+#endif
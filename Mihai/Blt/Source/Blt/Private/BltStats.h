@@ -0,0 +1,148 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+#include "Stats/Stats.h"
+
+#if STATS
+#include <atomic>
+#endif
+
+
+// Everything here shows up under `stat Blt` and in Insights captures, and compiles out in shipping
+DECLARE_STATS_GROUP(TEXT("Blt"), STATGROUP_Blt, STATCAT_Advanced);
+
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Spec load"), STAT_BltSpecLoad, STATGROUP_Blt, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Actor index build"), STAT_BltActorIndexBuild, STATGROUP_Blt, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Actor lookup"), STAT_BltActorLookup, STATGROUP_Blt, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Plan resolution"), STAT_BltPlanResolve, STATGROUP_Blt, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("RandomiseProperties"), STAT_BltRandomiseProperties, STATGROUP_Blt, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Numeric mutator"), STAT_BltNumericMutator, STATGROUP_Blt, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("String mutator"), STAT_BltStringMutator, STATGROUP_Blt, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Python bridge"), STAT_BltPythonBridge, STATGROUP_Blt, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Batch compute"), STAT_BltBatchCompute, STATGROUP_Blt, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Batch commit"), STAT_BltBatchCommit, STATGROUP_Blt, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Checkpoint capture"), STAT_BltCheckpointCapture, STATGROUP_Blt, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Checkpoint reset"), STAT_BltCheckpointReset, STATGROUP_Blt, );
+
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Mutations"), STAT_BltMutations, STATGROUP_Blt, );
+DECLARE_FLOAT_COUNTER_STAT_EXTERN(TEXT("Mutations per second"), STAT_BltMutationsPerSecond, STATGROUP_Blt, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Strings generated"), STAT_BltStringsGenerated, STATGROUP_Blt, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Bytes written"), STAT_BltBytesWritten, STATGROUP_Blt, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Plan cache hits"), STAT_BltPlanCacheHits, STATGROUP_Blt, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Plan cache misses"), STAT_BltPlanCacheMisses, STATGROUP_Blt, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Schema cache hits"), STAT_BltSchemaCacheHits, STATGROUP_Blt, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Schema cache misses"), STAT_BltSchemaCacheMisses, STATGROUP_Blt, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Regex cache hits"), STAT_BltRegexCacheHits, STATGROUP_Blt, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Regex cache misses"), STAT_BltRegexCacheMisses, STATGROUP_Blt, );
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Name pool size"), STAT_BltNamePoolSize, STATGROUP_Blt, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Name pool hits"), STAT_BltNamePoolHits, STATGROUP_Blt, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Name pool misses"), STAT_BltNamePoolMisses, STATGROUP_Blt, );
+DECLARE_FLOAT_ACCUMULATOR_STAT_EXTERN(TEXT("Name pool hit rate"), STAT_BltNamePoolHitRate, STATGROUP_Blt, );
+
+#define BLT_SCOPE_CYCLE_COUNTER(Stat) \
+	SCOPE_CYCLE_COUNTER(Stat); \
+	TRACE_CPUPROFILER_EVENT_SCOPE(Stat)
+
+
+#if STATS
+
+// Mutation counters are batched per actor, the rates are derived once per frame
+class FBltStats
+{
+public:
+	// Sums the mutations this thread makes within a scope and adds them in one go; nested scopes add to the outer one
+	class FScopedMutationBatch
+	{
+	public:
+		FScopedMutationBatch()
+			: Previous(ActiveBatch)
+		{
+			ActiveBatch = this;
+		}
+
+		~FScopedMutationBatch()
+		{
+			ActiveBatch = Previous;
+			if (Previous)
+			{
+				Previous->Count += Count;
+				Previous->Bytes += Bytes;
+			}
+			else if (Count > 0)
+			{
+				AddMutations(Count, Bytes);
+			}
+		}
+
+		FScopedMutationBatch(const FScopedMutationBatch&) = delete;
+		FScopedMutationBatch& operator=(const FScopedMutationBatch&) = delete;
+
+	private:
+		friend FBltStats;
+
+		FScopedMutationBatch* Previous;
+		int32 Count = 0;
+		int64 Bytes = 0;
+	};
+
+	static void AddMutations(const int32 Count, const int64 Bytes)
+	{
+		INC_DWORD_STAT_BY(STAT_BltMutations, Count);
+		INC_DWORD_STAT_BY(STAT_BltBytesWritten, Bytes);
+		PendingMutations.fetch_add(Count, std::memory_order_relaxed);
+	}
+
+	// One value written, held back by the active batch of the thread if there is one
+	static void AddMutation(const int64 Bytes)
+	{
+		if (ActiveBatch)
+		{
+			++ActiveBatch->Count;
+			ActiveBatch->Bytes += Bytes;
+		}
+		else
+		{
+			AddMutations(1, Bytes);
+		}
+	}
+
+	static void AddNameLookup(const bool bHit)
+	{
+		if (bHit)
+		{
+			INC_DWORD_STAT(STAT_BltNamePoolHits);
+			PendingNameHits.fetch_add(1u, std::memory_order_relaxed);
+		}
+		else
+		{
+			INC_DWORD_STAT(STAT_BltNamePoolMisses);
+		}
+		PendingNameLookups.fetch_add(1u, std::memory_order_relaxed);
+	}
+
+	static void RegisterTicker();
+	static void UnregisterTicker();
+
+private:
+	static std::atomic<uint64> PendingMutations;
+	static std::atomic<uint64> PendingNameHits;
+	static std::atomic<uint64> PendingNameLookups;
+	static FDelegateHandle TickerHandle;
+	static thread_local FScopedMutationBatch* ActiveBatch;
+};
+
+#define BLT_SCOPE_MUTATION_BATCH() const FBltStats::FScopedMutationBatch PREPROCESSOR_JOIN(MutationBatch, __LINE__)
+#define BLT_COUNT_MUTATIONS(Count, Bytes) FBltStats::AddMutations(Count, Bytes)
+#define BLT_COUNT_MUTATION(Bytes) FBltStats::AddMutation(Bytes)
+#define BLT_COUNT_NAME_LOOKUP(bHit) FBltStats::AddNameLookup(bHit)
+
+#else
+
+#define BLT_SCOPE_MUTATION_BATCH()
+#define BLT_COUNT_MUTATIONS(Count, Bytes)
+#define BLT_COUNT_MUTATION(Bytes)
+#define BLT_COUNT_NAME_LOOKUP(bHit)
+
+#endif
@@ -0,0 +1,90 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "BltStringMutator.h"
+
+#include "BltNamePool.h"
+#include "BltRegexGenerator.h"
+
+
+void FBltStringMutator::Read(const FBltFuzzPropertyPlan& PropertyPlan, const void* const ValuePtr, FString& OutString)
+{
+	switch (PropertyPlan.Type)
+	{
+	case EBltFuzzValueType::String:
+		OutString = *static_cast<const FString*>(ValuePtr);
+		break;
+
+	case EBltFuzzValueType::Name:
+		OutString = static_cast<const FName*>(ValuePtr)->ToString();
+		break;
+
+	case EBltFuzzValueType::Text:
+		OutString = static_cast<const FText*>(ValuePtr)->ToString();
+		break;
+
+	default:
+		OutString.Reset();
+		break;
+	}
+}
+
+void FBltStringMutator::Perturb(const FBltFuzzPropertyPlan& PropertyPlan, FBltRandomStream& Stream, FString& InOutString)
+{
+	const int32 Limit = PropertyPlan.Type == EBltFuzzValueType::Name ? FBltNamePool::MaxNameLength : MaxLength;
+	const int32 EditCount = 1 + Stream.RandHelper(4);
+	for (int32 Edit = 0; Edit < EditCount; ++Edit)
+	{
+		const int32 Len = InOutString.Len();
+		switch (Len > 0 ? Stream.RandHelper(4) : 0)
+		{
+		// Insert a few printable ASCII characters
+		case 0:
+		{
+			const int32 Count = 1 + Stream.RandHelper(4);
+			FString Chars;
+			Chars.Reserve(Count);
+			for (int32 Index = 0; Index < Count; ++Index)
+			{
+				Chars.AppendChar(static_cast<TCHAR>(Stream.RandRange(0x20, 0x7e)));
+			}
+			InOutString.InsertAt(Stream.RandHelper(Len + 1), Chars);
+			break;
+		}
+
+		case 1:
+		{
+			const int32 Start = Stream.RandHelper(Len);
+			InOutString.RemoveAt(Start, 1 + Stream.RandHelper(Len - Start), false);
+			break;
+		}
+
+		case 2:
+			InOutString.LeftInline(Stream.RandHelper(Len), false);
+			break;
+
+		// Head of the value, tail of a donor: a fresh sample of the regex, or the value itself
+		default:
+		{
+			FString Donor;
+			if (PropertyPlan.Generator && Stream.RandHelper(2))
+			{
+				PropertyPlan.Generator->Generate(Stream, Donor);
+			}
+			else
+			{
+				Donor = InOutString;
+			}
+
+			const int32 Head = Stream.RandHelper(Len + 1);
+			InOutString.LeftInline(Head, false);
+			InOutString += Donor.RightChop(Stream.RandHelper(Donor.Len() + 1));
+			break;
+		}
+		}
+
+		if (InOutString.Len() > Limit)
+		{
+			InOutString.LeftInline(Limit, false);
+		}
+	}
+}
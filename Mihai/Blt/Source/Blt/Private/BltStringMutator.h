@@ -0,0 +1,21 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "BltFuzzPlan.h"
+#include "BltRandom.h"
+
+
+// Mutational strategy for FString, FName and FText properties: the current value is edited
+// instead of rendering a new string from the regex of the entry
+class FBltStringMutator
+{
+public:
+	static void Read(const FBltFuzzPropertyPlan& PropertyPlan, const void* const ValuePtr, FString& OutString);
+
+	// Stacks up to four inserts, deletions, truncations and splices with a fresh sample of the regex
+	static void Perturb(const FBltFuzzPropertyPlan& PropertyPlan, FBltRandomStream& Stream, FString& InOutString);
+
+	// Edited values never grow past this, however long a walk gets; names stop at FBltNamePool::MaxNameLength
+	static constexpr int32 MaxLength = 1024;
+};
@@ -0,0 +1,358 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "BltValueDistribution.h"
+
+#include "BltRandom.h"
+
+
+namespace
+{
+	template <typename T>
+	struct TIntegerEncoding
+	{
+		static constexpr bool bInteger = true;
+
+		static uint64 Encode(const double Value)
+		{
+			if (Value != Value)
+				return 0u;
+
+			if (Value <= static_cast<double>(TNumericLimits<T>::Lowest()))
+				return static_cast<uint64>(TNumericLimits<T>::Lowest());
+
+			if (Value >= static_cast<double>(TNumericLimits<T>::Max()))
+				return static_cast<uint64>(TNumericLimits<T>::Max());
+
+			return static_cast<uint64>(static_cast<T>(Value));
+		}
+
+		// Raw bits are the value as Encode stores it, sign extended for signed types
+		static bool FitsBits(const uint64 Bits)
+		{
+			return static_cast<uint64>(static_cast<T>(Bits)) == Bits;
+		}
+
+		// Min and Max as TNumericLimits names them
+		static bool FindNamed(const FName Name, uint64& OutBits)
+		{
+			if (Name == TEXT("Min") || Name == TEXT("Lowest"))
+			{
+				OutBits = static_cast<uint64>(TNumericLimits<T>::Lowest());
+				return true;
+			}
+
+			if (Name == TEXT("Max"))
+			{
+				OutBits = static_cast<uint64>(TNumericLimits<T>::Max());
+				return true;
+			}
+
+			return false;
+		}
+
+		static void AddBoundaries(TArray<uint64>& OutBits)
+		{
+			constexpr T Lowest = TNumericLimits<T>::Lowest();
+			constexpr T Max = TNumericLimits<T>::Max();
+			for (const T Value : { T(0), T(1), static_cast<T>(-1), Lowest, static_cast<T>(Lowest + 1), Max, static_cast<T>(Max - 1) })
+			{
+				OutBits.AddUnique(static_cast<uint64>(Value));
+			}
+
+			// Where the value would flip sign if read as signed
+			if (Lowest == 0)
+			{
+				OutBits.AddUnique(static_cast<uint64>(Max / 2));
+				OutBits.AddUnique(static_cast<uint64>(Max / 2 + 1));
+			}
+		}
+	};
+
+	template <typename T, typename BitsType, int32 MantissaBits>
+	struct TFloatEncoding
+	{
+		static_assert(sizeof(T) == sizeof(BitsType), "Float kernel instantiated with bits of another size");
+
+		static constexpr bool bInteger = false;
+
+		static constexpr BitsType SignBit = BitsType(1) << (sizeof(BitsType) * 8 - 1);
+		static constexpr BitsType ExponentMask = ~SignBit & ~((BitsType(1) << MantissaBits) - 1);
+		static constexpr BitsType One = (ExponentMask >> (MantissaBits + 1)) << MantissaBits;
+		static constexpr BitsType Infinity = ExponentMask;
+		static constexpr BitsType QuietNaN = ExponentMask | BitsType(1) << (MantissaBits - 1);
+		static constexpr BitsType Max = ExponentMask - 1;
+		static constexpr BitsType SmallestNormal = BitsType(1) << MantissaBits;
+		static constexpr BitsType Denormal = 1;
+		static constexpr BitsType Epsilon = One - (BitsType(MantissaBits) << MantissaBits);
+
+		static uint64 Encode(const double Value)
+		{
+			const T Number = static_cast<T>(Value);
+
+			BitsType Bits;
+			FMemory::Memcpy(&Bits, &Number, sizeof(T));
+			return Bits;
+		}
+
+		static bool FitsBits(const uint64 Bits)
+		{
+			return static_cast<uint64>(static_cast<BitsType>(Bits)) == Bits;
+		}
+
+		// Min is the smallest normal value, as TNumericLimits names it
+		static bool FindNamed(const FName Name, uint64& OutBits)
+		{
+			static const TPair<FName, BitsType> Named[] = {
+				{ TEXT("NaN"), QuietNaN },
+				{ TEXT("Inf"), Infinity },
+				{ TEXT("-Inf"), SignBit | Infinity },
+				{ TEXT("-0"), SignBit },
+				{ TEXT("Denormal"), Denormal },
+				{ TEXT("-Denormal"), SignBit | Denormal },
+				{ TEXT("Min"), SmallestNormal },
+				{ TEXT("Epsilon"), Epsilon },
+				{ TEXT("Max"), Max },
+				{ TEXT("Lowest"), SignBit | Max }
+			};
+
+			for (const TPair<FName, BitsType>& Pair : Named)
+			{
+				if (Pair.Key == Name)
+				{
+					OutBits = Pair.Value;
+					return true;
+				}
+			}
+
+			return false;
+		}
+
+		static void AddBoundaries(TArray<uint64>& OutBits)
+		{
+			for (const BitsType Bits : { BitsType(0), SignBit, One, SignBit | One, Max, SignBit | Max, SmallestNormal,
+				SignBit | SmallestNormal, Denormal, SignBit | Denormal, Epsilon, QuietNaN, Infinity, SignBit | Infinity })
+			{
+				OutBits.AddUnique(Bits);
+			}
+		}
+	};
+
+	template <typename FunctorType>
+	bool DispatchEncoding(const EBltFuzzValueType Type, FunctorType&& Functor)
+	{
+		switch (Type)
+		{
+		case EBltFuzzValueType::Int8:   Functor(TIntegerEncoding<int8>());   return true;
+		case EBltFuzzValueType::Int16:  Functor(TIntegerEncoding<int16>());  return true;
+		case EBltFuzzValueType::Int32:  Functor(TIntegerEncoding<int32>());  return true;
+		case EBltFuzzValueType::Int64:  Functor(TIntegerEncoding<int64>());  return true;
+		case EBltFuzzValueType::UInt8:  Functor(TIntegerEncoding<uint8>());  return true;
+		case EBltFuzzValueType::UInt16: Functor(TIntegerEncoding<uint16>()); return true;
+		case EBltFuzzValueType::UInt32: Functor(TIntegerEncoding<uint32>()); return true;
+		case EBltFuzzValueType::UInt64: Functor(TIntegerEncoding<uint64>()); return true;
+		case EBltFuzzValueType::Float:  Functor(TFloatEncoding<float, uint32, 23>());  return true;
+		case EBltFuzzValueType::Double: Functor(TFloatEncoding<double, uint64, 52>()); return true;
+
+		default:
+			return false;
+		}
+	}
+
+	// log1p mirrored around zero, so buckets crossing zero spread evenly over the magnitudes on both sides
+	double SignedLog(const double Value)
+	{
+		return Value < 0.0 ? -log1p(-Value) : log1p(Value);
+	}
+
+	double SignedExp(const double Value)
+	{
+		return Value < 0.0 ? -expm1(-Value) : expm1(Value);
+	}
+}
+
+
+TSharedPtr<const FBltValueDistribution, ESPMode::ThreadSafe> FBltValueDistribution::Compile(
+	const FBltFuzzDistributionSpec& Spec,
+	const EBltFuzzValueType Type,
+	FString& OutError
+)
+{
+	const double EdgeRate = Spec.EdgeRate >= 0.0 ? Spec.EdgeRate : Spec.Edges.Num() > 0 ? DefaultEdgeRate : 0.0;
+	if (EdgeRate > 1.0 || Spec.BoundaryRate < 0.0 || EdgeRate + Spec.BoundaryRate > 1.0)
+	{
+		OutError = TEXT("EdgeRate and Boundaries must be shares between 0 and 1 adding up to at most 1");
+		return nullptr;
+	}
+
+	TSharedRef<FBltValueDistribution, ESPMode::ThreadSafe> Distribution = MakeShared<FBltValueDistribution, ESPMode::ThreadSafe>();
+	TArray<double> Weights;
+	bool bBuilt = false;
+
+	const bool bSupported = DispatchEncoding(Type, [&](auto Encoding)
+	{
+		using EncodingType = decltype(Encoding);
+		Distribution->Encode = &EncodingType::Encode;
+		Distribution->bInteger = EncodingType::bInteger;
+
+		// Buckets share whatever edges and boundaries leave, in proportion to their weights
+		double TotalWeight = 0.0;
+		for (const FBltFuzzBucketSpec& Bucket : Spec.Buckets)
+		{
+			if (!(Bucket.Weight >= 0.0))
+			{
+				OutError = TEXT("bucket weights must not be negative");
+				return;
+			}
+			TotalWeight += Bucket.Weight;
+		}
+
+		for (const FBltFuzzBucketSpec& Bucket : Spec.Buckets)
+		{
+			FComponent Component;
+			Component.Kind = Spec.bLogScale ? EComponentKind::LogUniform : EComponentKind::Uniform;
+			Component.Min = FMath::Min(Bucket.Min, Bucket.Max);
+			Component.Max = FMath::Max(Bucket.Min, Bucket.Max);
+			Component.LogMin = SignedLog(Component.Min);
+			Component.LogMax = SignedLog(Component.Max);
+			Component.Low = EncodingType::Encode(Component.Min);
+			Component.High = EncodingType::Encode(Component.Max);
+			Distribution->AddComponent(Component, (1.0 - EdgeRate - Spec.BoundaryRate) * Bucket.Weight / TotalWeight, Weights);
+		}
+
+		TArray<uint64> ValueBits;
+		for (const FBltFuzzEdgeSpec& Edge : Spec.Edges)
+		{
+			uint64 Bits = Edge.Bits;
+			if (Edge.bRawBits)
+			{
+				if (!EncodingType::FitsBits(Bits))
+				{
+					OutError = FString::Printf(TEXT("edge 0x%llx does not fit this property type"), Bits);
+					return;
+				}
+			}
+			else if (Edge.Name.IsNone())
+			{
+				Bits = EncodingType::Encode(Edge.Value);
+			}
+			else if (!EncodingType::FindNamed(Edge.Name, Bits))
+			{
+				OutError = FString::Printf(TEXT("edge %s is not a value of this property type"), *Edge.Name.ToString());
+				return;
+			}
+			ValueBits.AddUnique(Bits);
+		}
+
+		const auto AddValues = [&Distribution, &Weights, &ValueBits](const double Rate)
+		{
+			for (const uint64 Bits : ValueBits)
+			{
+				FComponent Component;
+				Component.Low = Bits;
+				Distribution->AddComponent(Component, Rate / ValueBits.Num(), Weights);
+			}
+		};
+
+		AddValues(EdgeRate);
+
+		ValueBits.Reset();
+		EncodingType::AddBoundaries(ValueBits);
+		AddValues(Spec.BoundaryRate);
+
+		bBuilt = true;
+	});
+
+	if (!bSupported)
+	{
+		OutError = TEXT("distributions only apply to integer and floating point properties");
+		return nullptr;
+	}
+
+	if (!bBuilt)
+		return nullptr;
+
+	if (Distribution->Components.Num() == 0)
+	{
+		OutError = TEXT("the distribution has nothing to sample, give it a Range, Buckets, Edges or Boundaries");
+		return nullptr;
+	}
+
+	Distribution->BuildSlots(Weights);
+	return Distribution;
+}
+
+uint64 FBltValueDistribution::Sample(FBltRandomStream& Stream) const
+{
+	const uint64 Random = Stream.NextUInt64();
+	const int32 SlotIndex = static_cast<int32>(((Random >> 32u) * static_cast<uint64>(Slots.Num())) >> 32u);
+	const FSlot& Slot = Slots[SlotIndex];
+	const FComponent& Component = Components[(Random & MAX_uint32) < Slot.Threshold ? SlotIndex : Slot.Alias];
+
+	switch (Component.Kind)
+	{
+	case EComponentKind::Uniform:
+		return bInteger
+			? Stream.RangeUInt64(Component.Low, Component.High)
+			: Encode(FMath::Lerp(Component.Min, Component.Max, Stream.GetFraction()));
+
+	case EComponentKind::LogUniform:
+	{
+		const double Value = SignedExp(FMath::Lerp(Component.LogMin, Component.LogMax, Stream.GetFraction()));
+		return Encode(bInteger ? FMath::Clamp(FMath::RoundToDouble(Value), Component.Min, Component.Max) : Value);
+	}
+
+	default:
+		return Component.Low;
+	}
+}
+
+void FBltValueDistribution::AddComponent(const FComponent& Component, const double Weight, TArray<double>& Weights)
+{
+	if (Weight > 0.0)
+	{
+		Components.Add(Component);
+		Weights.Add(Weight);
+	}
+}
+
+void FBltValueDistribution::BuildSlots(const TArray<double>& Weights)
+{
+	double TotalWeight = 0.0;
+	for (const double Weight : Weights)
+	{
+		TotalWeight += Weight;
+	}
+
+	// Vose's method: underfull slots are topped up by one overfull component each
+	const int32 Count = Weights.Num();
+	TArray<double> Scaled;
+	TArray<int32> Small;
+	TArray<int32> Large;
+	for (int32 Index = 0; Index < Count; ++Index)
+	{
+		Scaled.Add(Weights[Index] * Count / TotalWeight);
+		(Scaled[Index] < 1.0 ? Small : Large).Add(Index);
+	}
+
+	Slots.SetNum(Count);
+	while (Small.Num() > 0 && Large.Num() > 0)
+	{
+		const int32 Under = Small.Pop(false);
+		const int32 Over = Large.Pop(false);
+		Slots[Under].Threshold = static_cast<uint64>(Scaled[Under] * 4294967296.0);
+		Slots[Under].Alias = Over;
+
+		Scaled[Over] -= 1.0 - Scaled[Under];
+		(Scaled[Over] < 1.0 ? Small : Large).Add(Over);
+	}
+
+	// Whatever is left is full up to rounding
+	for (const TArray<int32>* const Remaining : { &Small, &Large })
+	{
+		for (const int32 Index : *Remaining)
+		{
+			Slots[Index].Threshold = 1ull << 32u;
+			Slots[Index].Alias = Index;
+		}
+	}
+}
@@ -0,0 +1,68 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "BltFuzzPlan.h"
+
+class FBltRandomStream;
+
+
+// Distribution entry compiled against the type of one numeric property. Buckets, edge values and
+// type boundaries become the components of a Vose alias table, so a sample costs one draw to pick
+// the component plus at most one to place the value, however many components the entry has.
+class FBltValueDistribution
+{
+public:
+	// Null when Spec does not fit Type, with the reason in OutError
+	static TSharedPtr<const FBltValueDistribution, ESPMode::ThreadSafe> Compile(
+		const FBltFuzzDistributionSpec& Spec,
+		const EBltFuzzValueType Type,
+		FString& OutError
+	);
+
+	// Raw bits of one value, laid out like the bits FBltNumericMutators writes
+	uint64 Sample(FBltRandomStream& Stream) const;
+
+	int32 Num() const { return Components.Num(); }
+
+	// Share of the samples given to Edges when the entry has no EdgeRate
+	static constexpr double DefaultEdgeRate = 0.1;
+
+private:
+	enum class EComponentKind : uint8
+	{
+		Value,
+		Uniform,
+		LogUniform
+	};
+
+	struct FComponent
+	{
+		EComponentKind Kind = EComponentKind::Value;
+
+		// The bits of a value, or the sign extended bounds of an integer bucket
+		uint64 Low = 0u;
+		uint64 High = 0u;
+
+		// Bounds of a bucket, and their images on the signed log scale
+		double Min = 0.0;
+		double Max = 0.0;
+		double LogMin = 0.0;
+		double LogMax = 0.0;
+	};
+
+	// Slot i keeps component i when the low half of the draw falls under Threshold, and gives Alias otherwise
+	struct FSlot
+	{
+		uint64 Threshold = 0u;
+		int32 Alias = 0;
+	};
+
+	void AddComponent(const FComponent& Component, const double Weight, TArray<double>& Weights);
+	void BuildSlots(const TArray<double>& Weights);
+
+	TArray<FComponent> Components;
+	TArray<FSlot> Slots;
+	uint64 (*Encode)(const double Value) = nullptr;
+	bool bInteger = false;
+};
@@ -0,0 +1,334 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "BltWorldCheckpoint.h"
+
+#include "BltActorIndex.h"
+#include "BltBPLibrary.h"
+#include "BltFuzzPlan.h"
+#include "BltRestoreJournal.h"
+#include "BltStats.h"
+#include "Camera/PlayerCameraManager.h"
+#include "Components/PrimitiveComponent.h"
+#include "EngineUtils.h"
+#include "GameFramework/Controller.h"
+#include "GameFramework/HUD.h"
+#include "GameFramework/Info.h"
+#include "GameFramework/Pawn.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+#include "Serialization/ObjectAndNameAsStringProxyArchive.h"
+
+
+TMap<TWeakObjectPtr<UWorld>, TUniquePtr<FBltWorldCheckpoint>> FBltWorldCheckpoint::Checkpoints;
+FDelegateHandle FBltWorldCheckpoint::WorldCleanupHandle;
+
+
+namespace
+{
+	// Full values by path, so nothing points at actors that were destroyed in the meantime
+	class FBltCheckpointArchive final : public FObjectAndNameAsStringProxyArchive
+	{
+	public:
+		explicit FBltCheckpointArchive(FArchive& InnerArchive)
+			: FObjectAndNameAsStringProxyArchive(InnerArchive, false)
+		{
+			ArNoDelta = true;
+		}
+
+		virtual bool ShouldSkipProperty(const FProperty* const Property) const override
+		{
+			if (Property->HasAnyPropertyFlags(CPF_Transient | CPF_DuplicateTransient | CPF_InstancedReference | CPF_ContainsInstancedReference))
+				return true;
+
+			const FObjectPropertyBase* const ObjectProperty = CastField<const FObjectPropertyBase>(Property);
+			return ObjectProperty && ObjectProperty->PropertyClass->IsChildOf(UActorComponent::StaticClass());
+		}
+	};
+
+	// Framework actors come and go with players, not with gameplay, so a reset never destroys them
+	bool IsFrameworkActor(const AActor* const Actor)
+	{
+		if (Actor->IsA<AInfo>() || Actor->IsA<AController>() || Actor->IsA<APlayerCameraManager>() || Actor->IsA<AHUD>())
+			return true;
+
+		const APawn* const Pawn = Cast<APawn>(Actor);
+		return Pawn && Pawn->IsPlayerControlled();
+	}
+}
+
+
+FBltWorldCheckpoint& FBltWorldCheckpoint::Get(UWorld* const World)
+{
+	check(World);
+
+	TUniquePtr<FBltWorldCheckpoint>& Checkpoint = Checkpoints.FindOrAdd(World);
+	if (!Checkpoint)
+	{
+		Checkpoint.Reset(new FBltWorldCheckpoint(World));
+	}
+
+	return *Checkpoint;
+}
+
+FBltWorldCheckpoint* FBltWorldCheckpoint::Find(const UWorld* const World)
+{
+	TUniquePtr<FBltWorldCheckpoint>* const Checkpoint = Checkpoints.Find(const_cast<UWorld*>(World));
+	return Checkpoint ? Checkpoint->Get() : nullptr;
+}
+
+void FBltWorldCheckpoint::RegisterWorldHooks()
+{
+	WorldCleanupHandle = FWorldDelegates::OnWorldCleanup.AddLambda(
+		[](UWorld* const World, bool, bool)
+		{
+			Checkpoints.Remove(World);
+		}
+	);
+}
+
+void FBltWorldCheckpoint::UnregisterWorldHooks()
+{
+	FWorldDelegates::OnWorldCleanup.Remove(WorldCleanupHandle);
+	Checkpoints.Empty();
+}
+
+FBltWorldCheckpoint::FBltWorldCheckpoint(UWorld* const InWorld)
+	: World(InWorld)
+{
+}
+
+void FBltWorldCheckpoint::Capture(const FBltFuzzPlan& Plan)
+{
+	check(IsInGameThread());
+	BLT_SCOPE_CYCLE_COUNTER(STAT_BltCheckpointCapture);
+
+	UWorld* const CurrentWorld = World.Get();
+	if (!CurrentWorld)
+		return;
+
+	Actors.Reset();
+	KnownActors.Reset();
+	KnownLevels.Reset();
+	for (const ULevel* const Level : CurrentWorld->GetLevels())
+	{
+		KnownLevels.Add(Level);
+	}
+
+	for (TActorIterator<AActor> Iterator(CurrentWorld); Iterator; ++Iterator)
+	{
+		KnownActors.Add(*Iterator);
+	}
+
+	// A class may be listed next to one of its parents, every actor is saved once
+	TSet<AActor*> Targets;
+	TArray<AActor*> ClassActors;
+	FBltActorIndex& ActorIndex = FBltActorIndex::Get(CurrentWorld);
+	for (const FBltFuzzClassSpec& ClassSpec : Plan.GetClasses())
+	{
+		if (const UClass* const Class = ClassSpec.Class.Get())
+		{
+			ClassActors.Reset();
+			ActorIndex.GetActorsOfClass(Class, ClassActors);
+			Targets.Append(ClassActors);
+		}
+	}
+
+	Actors.Reserve(Targets.Num());
+	for (AActor* const Actor : Targets)
+	{
+		FActorState& State = Actors.AddDefaulted_GetRef();
+		State.Actor = Actor;
+		State.Class = Actor->GetClass();
+		State.Level = Actor->GetLevel();
+		State.Name = Actor->GetFName();
+		State.Transform = Actor->GetActorTransform();
+		SaveObject(Actor, State.Bytes);
+
+		TInlineComponentArray<UActorComponent*> Components(Actor);
+		State.Components.Reserve(Components.Num());
+		for (UActorComponent* const Component : Components)
+		{
+			FComponentState& ComponentState = State.Components.AddDefaulted_GetRef();
+			ComponentState.Name = Component->GetFName();
+			ComponentState.Component = Component;
+			SaveObject(Component, ComponentState.Bytes);
+
+			const UPrimitiveComponent* const Primitive = Cast<UPrimitiveComponent>(Component);
+			if (Primitive && Primitive->IsSimulatingPhysics())
+			{
+				ComponentState.bSimulatingPhysics = true;
+				ComponentState.LinearVelocity = Primitive->GetPhysicsLinearVelocity();
+				ComponentState.AngularVelocity = Primitive->GetPhysicsAngularVelocityInDegrees();
+			}
+		}
+	}
+
+	bCaptured = true;
+	UE_LOG(LogBlt, Log, TEXT("Checkpoint of %s: %d actors, %llu bytes"), *CurrentWorld->GetName(), Actors.Num(), static_cast<uint64>(GetAllocatedSize()));
+}
+
+int32 FBltWorldCheckpoint::Reset()
+{
+	check(IsInGameThread());
+	BLT_SCOPE_CYCLE_COUNTER(STAT_BltCheckpointReset);
+
+	if (!bCaptured || !World.IsValid())
+		return 0;
+
+	DestroySpawnedActors();
+
+	int32 RestoredCount = 0;
+	for (FActorState& State : Actors)
+	{
+		AActor* Actor = State.Actor.Get();
+		if (!Actor || Actor->IsPendingKillPending())
+		{
+			Actor = Respawn(State);
+			if (!Actor)
+				continue;
+		}
+
+		RestoreActor(Actor, State);
+		++RestoredCount;
+	}
+
+	// The checkpoint values supersede whatever the property journal saw before them
+	FBltRestoreJournal::Get().Reset(World.Get());
+	return RestoredCount;
+}
+
+SIZE_T FBltWorldCheckpoint::GetAllocatedSize() const
+{
+	SIZE_T Size = Actors.GetAllocatedSize() + KnownActors.GetAllocatedSize() + KnownLevels.GetAllocatedSize();
+	for (const FActorState& State : Actors)
+	{
+		Size += State.Bytes.GetAllocatedSize() + State.Components.GetAllocatedSize();
+		for (const FComponentState& ComponentState : State.Components)
+		{
+			Size += ComponentState.Bytes.GetAllocatedSize();
+		}
+	}
+
+	return Size;
+}
+
+void FBltWorldCheckpoint::SaveObject(UObject* const Object, TArray<uint8>& OutBytes)
+{
+	FMemoryWriter Writer(OutBytes);
+	Writer.ArNoDelta = true;
+
+	FBltCheckpointArchive Archive(Writer);
+	Object->SerializeScriptProperties(Archive);
+}
+
+void FBltWorldCheckpoint::LoadObject(UObject* const Object, const TArray<uint8>& Bytes)
+{
+	FMemoryReader Reader(Bytes);
+	FBltCheckpointArchive Archive(Reader);
+	Object->SerializeScriptProperties(Archive);
+}
+
+AActor* FBltWorldCheckpoint::Respawn(FActorState& State)
+{
+	UClass* const Class = State.Class.Get();
+	ULevel* const Level = State.Level.Get();
+
+	// Actors of levels streamed out since the capture come back with their level
+	if (!Class || !Level)
+		return nullptr;
+
+	// A destroyed actor keeps its name until it is collected, SpawnActor refuses names already taken
+	if (UObject* const Existing = StaticFindObjectFast(nullptr, Level, State.Name))
+	{
+		const AActor* const ExistingActor = Cast<AActor>(Existing);
+		if (!Existing->IsPendingKill() && !(ExistingActor && ExistingActor->IsPendingKillPending()))
+		{
+			UE_LOG(LogBlt, Warning, TEXT("Could not respawn %s for the checkpoint of %s, its name is taken"), *State.Name.ToString(), *World->GetName());
+			return nullptr;
+		}
+
+		Existing->Rename(nullptr, nullptr, REN_DontCreateRedirectors | REN_ForceNoResetLoaders | REN_NonTransactional);
+	}
+
+	FActorSpawnParameters SpawnParameters;
+	SpawnParameters.Name = State.Name;
+	SpawnParameters.OverrideLevel = Level;
+	SpawnParameters.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+
+	AActor* const Actor = World->SpawnActor(Class, &State.Transform, SpawnParameters);
+	if (!Actor)
+	{
+		UE_LOG(LogBlt, Warning, TEXT("Could not respawn a %s for the checkpoint of %s"), *Class->GetName(), *World->GetName());
+		return nullptr;
+	}
+
+	State.Actor = Actor;
+	KnownActors.Add(Actor);
+	return Actor;
+}
+
+void FBltWorldCheckpoint::RestoreActor(AActor* const Actor, FActorState& State)
+{
+	LoadObject(Actor, State.Bytes);
+
+	TInlineComponentArray<UActorComponent*> Components(Actor);
+	for (FComponentState& ComponentState : State.Components)
+	{
+		// Respawned actors recreate their components under the same names
+		UActorComponent* Component = ComponentState.Component.Get();
+		if (!Component || Component->GetOwner() != Actor)
+		{
+			UActorComponent* const* const Match = Components.FindByPredicate(
+				[&ComponentState](const UActorComponent* const Candidate)
+				{
+					return Candidate->GetFName() == ComponentState.Name;
+				}
+			);
+
+			Component = Match ? *Match : nullptr;
+			ComponentState.Component = Component;
+			if (!Component)
+				continue;
+		}
+
+		LoadObject(Component, ComponentState.Bytes);
+		if (Component->IsRegistered())
+		{
+			Component->MarkRenderStateDirty();
+		}
+	}
+
+	// Relative transforms came back with the properties, world transforms and physics bodies follow them
+	if (USceneComponent* const RootComponent = Actor->GetRootComponent())
+	{
+		RootComponent->UpdateComponentToWorld(EUpdateTransformFlags::None, ETeleportType::ResetPhysics);
+	}
+
+	for (const FComponentState& ComponentState : State.Components)
+	{
+		UPrimitiveComponent* const Primitive = Cast<UPrimitiveComponent>(ComponentState.Component.Get());
+		if (Primitive && ComponentState.bSimulatingPhysics && Primitive->IsSimulatingPhysics())
+		{
+			Primitive->SetPhysicsLinearVelocity(ComponentState.LinearVelocity);
+			Primitive->SetPhysicsAngularVelocityInDegrees(ComponentState.AngularVelocity);
+		}
+	}
+}
+
+void FBltWorldCheckpoint::DestroySpawnedActors()
+{
+	TArray<AActor*> SpawnedActors;
+	for (TActorIterator<AActor> Iterator(World.Get()); Iterator; ++Iterator)
+	{
+		AActor* const Actor = *Iterator;
+		if (!KnownActors.Contains(Actor) && KnownLevels.Contains(Actor->GetLevel()) && !IsFrameworkActor(Actor))
+		{
+			SpawnedActors.Add(Actor);
+		}
+	}
+
+	for (AActor* const Actor : SpawnedActors)
+	{
+		Actor->Destroy();
+	}
+}
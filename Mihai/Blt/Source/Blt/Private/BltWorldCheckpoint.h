@@ -0,0 +1,81 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "UObject/ObjectKey.h"
+
+class FBltFuzzPlan;
+
+
+// In-memory snapshot of the actors targeted by a fuzz plan, taken so iterations can start from the
+// same world state without a level reload. Actors and their components are saved as tagged script
+// properties with object references stored by path; references to components and instanced
+// subobjects are structure rather than state and are left alone. A reset writes the saved state back
+// into surviving actors, respawns destroyed ones and destroys gameplay actors spawned after the capture.
+class FBltWorldCheckpoint
+{
+public:
+	static FBltWorldCheckpoint& Get(UWorld* const World);
+	static FBltWorldCheckpoint* Find(const UWorld* const World);
+
+	static void RegisterWorldHooks();
+	static void UnregisterWorldHooks();
+
+	// Replaces the previous checkpoint of the world
+	void Capture(const FBltFuzzPlan& Plan);
+
+	// Returns how many actors were restored or respawned
+	int32 Reset();
+
+	bool IsCaptured() const { return bCaptured; }
+	int32 Num() const { return Actors.Num(); }
+	SIZE_T GetAllocatedSize() const;
+
+private:
+	explicit FBltWorldCheckpoint(UWorld* const InWorld);
+
+	struct FComponentState
+	{
+		FName Name;
+		TWeakObjectPtr<UActorComponent> Component;
+		TArray<uint8> Bytes;
+
+		// Rigid body velocities live in the physics scene, not in properties
+		bool bSimulatingPhysics = false;
+		FVector LinearVelocity = FVector::ZeroVector;
+		FVector AngularVelocity = FVector::ZeroVector;
+	};
+
+	struct FActorState
+	{
+		TWeakObjectPtr<AActor> Actor;
+		TWeakObjectPtr<UClass> Class;
+		TWeakObjectPtr<ULevel> Level;
+
+		// Respawns take it back, so their ActorId and with it their random streams stay the same
+		FName Name;
+		FTransform Transform;
+		TArray<uint8> Bytes;
+		TArray<FComponentState> Components;
+	};
+
+	static void SaveObject(UObject* const Object, TArray<uint8>& OutBytes);
+	static void LoadObject(UObject* const Object, const TArray<uint8>& Bytes);
+
+	AActor* Respawn(FActorState& State);
+	void RestoreActor(AActor* const Actor, FActorState& State);
+	void DestroySpawnedActors();
+
+	TWeakObjectPtr<UWorld> World;
+	TArray<FActorState> Actors;
+
+	// Every actor of the world at capture time, respawned ones are added as they come back
+	TSet<FObjectKey> KnownActors;
+
+	// Actors of levels streamed in after the capture belong to those levels and are left alone
+	TSet<FObjectKey> KnownLevels;
+	bool bCaptured = false;
+
+	static TMap<TWeakObjectPtr<UWorld>, TUniquePtr<FBltWorldCheckpoint>> Checkpoints;
+	static FDelegateHandle WorldCleanupHandle;
+};
@@ -5,12 +5,25 @@
 
 const UPythonBridge* UPythonBridge::Get()
 {
+	// The Python implementation class only changes when init_unreal.py gets reloaded, which leaves
+	// the old class behind marked as replaced
+	static TWeakObjectPtr<const UPythonBridge> CachedBridge;
+	if (CachedBridge.IsValid() && !CachedBridge->GetClass()->HasAnyClassFlags(CLASS_NewerVersionExists))
+		return CachedBridge.Get();
+
+	CachedBridge.Reset();
+
 	TArray<UClass*> PythonBridgeClasses;
 	GetDerivedClasses(StaticClass(), PythonBridgeClasses);
+	PythonBridgeClasses.RemoveAll([](const UClass* const Class)
+	{
+		return Class->HasAnyClassFlags(CLASS_NewerVersionExists) || Class->IsPendingKill();
+	});
 	
 	const uint32& BridgeCount = PythonBridgeClasses.Num();
 	if (BridgeCount == 0u)
 		return nullptr;
 	
-	return Cast<UPythonBridge>(PythonBridgeClasses[BridgeCount - 1u]->GetDefaultObject());
+	CachedBridge = Cast<UPythonBridge>(PythonBridgeClasses[BridgeCount - 1u]->GetDefaultObject());
+	return CachedBridge.Get();
 }
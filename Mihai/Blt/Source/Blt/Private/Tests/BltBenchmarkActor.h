@@ -0,0 +1,201 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "Components/ActorComponent.h"
+#include "Components/SceneComponent.h"
+#include "GameFramework/Actor.h"
+#include "BltBenchmarkActor.generated.h"
+
+
+// Synthetic population for the benchmarks, shaped like the fuzzed gameplay characters
+UCLASS(NotBlueprintable, NotPlaceable, Transient)
+class ABltBenchmarkActor final : public AActor
+{
+	GENERATED_BODY()
+
+public:
+	UPROPERTY()
+	int64 test_WalkSpeed = 200;
+
+	UPROPERTY()
+	int64 test_RunSpeed = 1000;
+
+	UPROPERTY()
+	int64 test_JumpHeight = 1000;
+
+	UPROPERTY()
+	float Health = 100.0f;
+
+	UPROPERTY()
+	double BaseTurnRate = 45.0;
+
+	UPROPERTY()
+	bool bIsSprinting = false;
+
+	UPROPERTY()
+	FString Name;
+};
+
+// Numeric heavy mix, one field of every kernel
+UCLASS(NotBlueprintable, NotPlaceable, Transient)
+class ABltBenchmarkNumericActor final : public AActor
+{
+	GENERATED_BODY()
+
+public:
+	UPROPERTY()
+	int8 Level = 1;
+
+	UPROPERTY()
+	int16 Armor = 10;
+
+	UPROPERTY()
+	int32 Ammo = 30;
+
+	UPROPERTY()
+	int32 Score = 0;
+
+	UPROPERTY()
+	int64 test_WalkSpeed = 200;
+
+	UPROPERTY()
+	int64 test_RunSpeed = 1000;
+
+	UPROPERTY()
+	uint8 Team = 0;
+
+	UPROPERTY()
+	uint16 Lives = 3;
+
+	UPROPERTY()
+	uint32 Seed = 0;
+
+	UPROPERTY()
+	uint64 Experience = 0;
+
+	UPROPERTY()
+	float Health = 100.0f;
+
+	UPROPERTY()
+	float Stamina = 100.0f;
+
+	UPROPERTY()
+	float JumpZVelocity = 420.0f;
+
+	UPROPERTY()
+	double BaseTurnRate = 45.0;
+
+	UPROPERTY()
+	double BaseLookUpRate = 45.0;
+
+	UPROPERTY()
+	bool bIsSprinting = false;
+
+	UPROPERTY()
+	bool bIsCrouched = false;
+};
+
+// String heavy mix, rendered natively
+UCLASS(NotBlueprintable, NotPlaceable, Transient)
+class ABltBenchmarkStringActor final : public AActor
+{
+	GENERATED_BODY()
+
+public:
+	UPROPERTY()
+	FString DisplayName;
+
+	UPROPERTY()
+	FString Title;
+
+	UPROPERTY()
+	FString Guild;
+
+	UPROPERTY()
+	FName Faction;
+
+	UPROPERTY()
+	FName SpawnTag;
+
+	UPROPERTY()
+	FText Greeting;
+
+	UPROPERTY()
+	int32 Score = 0;
+};
+
+UCLASS(NotBlueprintable, Transient)
+class UBltBenchmarkComponent final : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:
+	UPROPERTY()
+	float Value = 0.0f;
+
+	UPROPERTY()
+	int32 Stacks = 0;
+};
+
+// Character like actor: a handful of fuzzed fields next to default subobjects
+UCLASS(NotBlueprintable, NotPlaceable, Transient)
+class ABltBenchmarkComponentActor final : public AActor
+{
+	GENERATED_BODY()
+
+public:
+	ABltBenchmarkComponentActor()
+	{
+		Root = CreateDefaultSubobject<USceneComponent>(TEXT("Root"));
+		RootComponent = Root;
+
+		HealthComponent = CreateDefaultSubobject<UBltBenchmarkComponent>(TEXT("HealthComponent"));
+		StaminaComponent = CreateDefaultSubobject<UBltBenchmarkComponent>(TEXT("StaminaComponent"));
+		InventoryComponent = CreateDefaultSubobject<UBltBenchmarkComponent>(TEXT("InventoryComponent"));
+	}
+
+	UPROPERTY()
+	USceneComponent* Root = nullptr;
+
+	UPROPERTY()
+	UBltBenchmarkComponent* HealthComponent = nullptr;
+
+	UPROPERTY()
+	UBltBenchmarkComponent* StaminaComponent = nullptr;
+
+	UPROPERTY()
+	UBltBenchmarkComponent* InventoryComponent = nullptr;
+
+	UPROPERTY()
+	int64 test_WalkSpeed = 200;
+
+	UPROPERTY()
+	int64 test_RunSpeed = 1000;
+
+	UPROPERTY()
+	int64 test_JumpHeight = 1000;
+
+	UPROPERTY()
+	FString Name;
+};
+
+// Records the inputs that reproduce its pass, like the gameplay characters do
+UCLASS(NotBlueprintable, NotPlaceable, Transient)
+class ABltSeededTestActor final : public AActor
+{
+	GENERATED_BODY()
+
+public:
+	UPROPERTY()
+	int64 test_WalkSpeed = 200;
+
+	UPROPERTY()
+	int32 Stamina = 100;
+
+	UPROPERTY()
+	int64 FuzzSeed = 0;
+
+	UPROPERTY()
+	int32 FuzzIteration = 0;
+};
@@ -0,0 +1,98 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "Misc/AutomationTest.h"
+#include "Policies/CondensedJsonPrintPolicy.h"
+#include "Serialization/JsonWriter.h"
+
+
+// Results of one benchmark run. Save writes Saved/Blt/Benchmarks/<Name>.json and appends one row
+// per metric to Saved/Blt/Benchmarks/Benchmarks.csv, which is what the nightly runs pick up.
+class FBltBenchmarkReport
+{
+public:
+	explicit FBltBenchmarkReport(const FString& InBenchmarkName)
+		: BenchmarkName(InBenchmarkName)
+		, Timestamp(FDateTime::UtcNow().ToIso8601())
+	{
+	}
+
+	// Wall time of one call, in milliseconds
+	template <typename FunctorType>
+	static double Time(const FunctorType& Functor)
+	{
+		const double StartTime = FPlatformTime::Seconds();
+		Functor();
+		return (FPlatformTime::Seconds() - StartTime) * 1000.0;
+	}
+
+	void Add(const FString& MetricName, const double Value, const TCHAR* const Unit)
+	{
+		Metrics.Add({ MetricName, Value, Unit });
+	}
+
+	bool Save(FAutomationTestBase& Test) const
+	{
+		const FString Directory = FPaths::ProjectSavedDir() / TEXT("Blt") / TEXT("Benchmarks");
+
+		FString Json;
+		const TSharedRef<TJsonWriter<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>> JsonWriter
+			= TJsonWriterFactory<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>::Create(&Json);
+
+		JsonWriter->WriteObjectStart();
+		JsonWriter->WriteValue(TEXT("benchmark"), BenchmarkName);
+		JsonWriter->WriteValue(TEXT("timestamp"), Timestamp);
+		JsonWriter->WriteValue(TEXT("build"), FString(FApp::GetBuildVersion()));
+		JsonWriter->WriteArrayStart(TEXT("metrics"));
+		for (const FMetric& Metric : Metrics)
+		{
+			JsonWriter->WriteObjectStart();
+			JsonWriter->WriteValue(TEXT("name"), Metric.Name);
+			JsonWriter->WriteValue(TEXT("value"), Metric.Value);
+			JsonWriter->WriteValue(TEXT("unit"), Metric.Unit);
+			JsonWriter->WriteObjectEnd();
+		}
+		JsonWriter->WriteArrayEnd();
+		JsonWriter->WriteObjectEnd();
+		JsonWriter->Close();
+
+		const FString CsvPath = Directory / TEXT("Benchmarks.csv");
+		FString Csv = IFileManager::Get().FileExists(*CsvPath) ? FString() : TEXT("timestamp,build,benchmark,metric,value,unit\n");
+		for (const FMetric& Metric : Metrics)
+		{
+			Csv += FString::Printf(
+				TEXT("%s,%s,%s,%s,%f,%s\n"),
+				*Timestamp,
+				FApp::GetBuildVersion(),
+				*BenchmarkName,
+				*Metric.Name,
+				Metric.Value,
+				*Metric.Unit
+			);
+		}
+
+		const FString JsonPath = Directory / (BenchmarkName + TEXT(".json"));
+		const bool bSaved = FFileHelper::SaveStringToFile(Json, *JsonPath)
+			&& FFileHelper::SaveStringToFile(Csv, *CsvPath, FFileHelper::EEncodingOptions::AutoDetect, &IFileManager::Get(), FILEWRITE_Append);
+
+		for (const FMetric& Metric : Metrics)
+		{
+			Test.AddInfo(FString::Printf(TEXT("%-32s %14.3f %s"), *Metric.Name, Metric.Value, *Metric.Unit));
+		}
+
+		return Test.TestTrue(TEXT("Benchmark results written"), bSaved);
+	}
+
+private:
+	struct FMetric
+	{
+		FString Name;
+		double Value = 0.0;
+		FString Unit;
+	};
+
+	FString BenchmarkName;
+	FString Timestamp;
+	TArray<FMetric> Metrics;
+};
@@ -0,0 +1,53 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+
+
+// Headless game world owned by a benchmark for the duration of a scope
+class FBltBenchmarkWorld
+{
+public:
+	FBltBenchmarkWorld()
+	{
+		World = UWorld::CreateWorld(EWorldType::Game, false, TEXT("BltBenchmarkWorld"));
+
+		FWorldContext& WorldContext = GEngine->CreateNewWorldContext(EWorldType::Game);
+		WorldContext.SetCurrentWorld(World);
+	}
+
+	~FBltBenchmarkWorld()
+	{
+		GEngine->DestroyWorldContext(World);
+		World->DestroyWorld(false);
+		CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+	}
+
+	template <typename ActorType>
+	TArray<AActor*> Spawn(const int32 Count)
+	{
+		return Spawn(ActorType::StaticClass(), Count);
+	}
+
+	TArray<AActor*> Spawn(UClass* const ActorClass, const int32 Count)
+	{
+		FActorSpawnParameters SpawnParameters;
+		SpawnParameters.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+
+		TArray<AActor*> Actors;
+		Actors.Reserve(Count);
+		for (int32 Index = 0; Index < Count; ++Index)
+		{
+			Actors.Add(World->SpawnActor(ActorClass, nullptr, nullptr, SpawnParameters));
+		}
+
+		return Actors;
+	}
+
+	UWorld* Get() const { return World; }
+
+private:
+	UWorld* World = nullptr;
+};
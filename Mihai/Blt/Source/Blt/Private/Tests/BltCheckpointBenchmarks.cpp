@@ -0,0 +1,215 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "BltActorIndex.h"
+#include "BltBenchmarkActor.h"
+#include "BltBenchmarkReport.h"
+#include "BltBenchmarkWorld.h"
+#include "BltFuzzBatch.h"
+#include "BltFuzzPlan.h"
+#include "BltWorldCheckpoint.h"
+#include "Kismet/GameplayStatics.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+
+namespace
+{
+	const int32 CheckpointPopulations[] = { 1000, 10000 };
+
+	FBltFuzzPlanPtr MakeCheckpointPlan(UClass* const Class)
+	{
+		TArray<FBltFuzzClassSpec> Classes;
+		FBltFuzzClassSpec& ClassSpec = Classes.AddDefaulted_GetRef();
+		ClassSpec.ClassName = Class->GetName();
+		ClassSpec.Class = Class;
+
+		for (TFieldIterator<FNumericProperty> Iterator(Class, EFieldIteratorFlags::ExcludeSuper); Iterator; ++Iterator)
+		{
+			FBltFuzzPropertySpec& PropertySpec = ClassSpec.Properties.Add(Iterator->GetFName());
+			PropertySpec.PropertyName = Iterator->GetFName();
+			PropertySpec.Source = EBltFuzzRangeSource::Interval;
+			PropertySpec.Min = 0.0;
+			PropertySpec.Max = 100.0;
+		}
+
+		return MakeShared<const FBltFuzzPlan, ESPMode::ThreadSafe>(TEXT("Checkpoint"), MoveTemp(Classes));
+	}
+
+	// Reopens the current map of a running game and waits until the new world has begun play
+	class FBltOpenLevelCommand final : public IAutomationLatentCommand
+	{
+	public:
+		FBltOpenLevelCommand(FAutomationTestBase& InTest, const TSharedRef<FBltBenchmarkReport>& InReport, FWorldContext& InWorldContext)
+			: Test(InTest)
+			, Report(InReport)
+			, WorldContext(InWorldContext)
+		{
+		}
+
+		virtual bool Update() override
+		{
+			UWorld* const CurrentWorld = WorldContext.World();
+			if (!PreviousWorld.IsValid() && StartTime == 0.0)
+			{
+				PreviousWorld = CurrentWorld;
+				StartTime = FPlatformTime::Seconds();
+				UGameplayStatics::OpenLevel(CurrentWorld, FName(*UWorld::RemovePIEPrefix(CurrentWorld->GetOutermost()->GetName())));
+				return false;
+			}
+
+			const double Seconds = FPlatformTime::Seconds() - StartTime;
+			if (CurrentWorld && CurrentWorld != PreviousWorld.Get() && CurrentWorld->HasBegunPlay())
+			{
+				Report->Add(TEXT("OpenLevel"), Seconds * 1000.0, TEXT("ms"));
+				Report->Save(Test);
+				return true;
+			}
+
+			if (Seconds > 120.0)
+			{
+				Test.AddError(TEXT("OpenLevel did not finish within two minutes"));
+				return true;
+			}
+
+			return false;
+		}
+
+	private:
+		FAutomationTestBase& Test;
+		TSharedRef<FBltBenchmarkReport> Report;
+		FWorldContext& WorldContext;
+		TWeakObjectPtr<UWorld> PreviousWorld;
+		double StartTime = 0.0;
+	};
+}
+
+
+// Checkpoint reset against rebuilding the whole population in a fresh world, the in-process lower bound of a level reload
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(
+	FBltWorldResetBenchmark,
+	"Blt.Benchmarks.WorldReset",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::PerfFilter
+)
+
+bool FBltWorldResetBenchmark::RunTest(const FString& Parameters)
+{
+	constexpr int32 Repetitions = 5;
+
+	FBltBenchmarkReport Report(TEXT("WorldReset"));
+	for (const int32 Population : CheckpointPopulations)
+	{
+		UClass* const ActorClass = ABltBenchmarkComponentActor::StaticClass();
+		const FBltFuzzPlanPtr Plan = MakeCheckpointPlan(ActorClass);
+
+		FBltBenchmarkWorld World;
+		TArray<AActor*> Actors = World.Spawn(ActorClass, Population);
+
+		FBltWorldCheckpoint& Checkpoint = FBltWorldCheckpoint::Get(World.Get());
+		Report.Add(FString::Printf(TEXT("Capture.%dk"), Population / 1000), FBltBenchmarkReport::Time([&Checkpoint, &Plan]()
+		{
+			Checkpoint.Capture(*Plan);
+		}), TEXT("ms"));
+		Report.Add(FString::Printf(TEXT("Memory.%dk"), Population / 1000), Checkpoint.GetAllocatedSize() / 1024.0, TEXT("KiB"));
+
+		TSet<FName> CapturedNames;
+		for (const AActor* const Actor : Actors)
+		{
+			CapturedNames.Add(Actor->GetFName());
+		}
+
+		// Every iteration fuzzes everything, loses 1% of the actors and gains 1% new ones
+		double ResetMilliseconds = 0.0;
+		for (int32 Repetition = 0; Repetition < Repetitions; ++Repetition)
+		{
+			FBltFuzzPass Pass;
+			Pass.Iteration = Repetition;
+
+			FBltFuzzBatch Batch(Pass);
+			for (AActor* const Actor : Actors)
+			{
+				Batch.Add(Actor, Plan->FindOrResolveClassPlan(0, ActorClass));
+			}
+			Batch.Compute();
+			Batch.Commit();
+
+			for (int32 Index = 0; Index < Population / 100; ++Index)
+			{
+				Actors[Index * 100]->Destroy();
+			}
+			World.Spawn(ActorClass, Population / 100);
+
+			int32 RestoredCount = 0;
+			ResetMilliseconds += FBltBenchmarkReport::Time([&Checkpoint, &RestoredCount]()
+			{
+				RestoredCount = Checkpoint.Reset();
+			});
+			TestEqual(TEXT("Every checkpointed actor restored"), RestoredCount, Population);
+
+			Actors.Reset();
+			FBltActorIndex::Get(World.Get()).GetActorsOfClass(ActorClass, Actors);
+			TestEqual(TEXT("Spawned actors destroyed"), Actors.Num(), Population);
+			TestFalse(TEXT("Respawned actor under a new name"), Actors.ContainsByPredicate([&CapturedNames](const AActor* const Actor)
+			{
+				return !CapturedNames.Contains(Actor->GetFName());
+			}));
+		}
+
+		Report.Add(FString::Printf(TEXT("Reset.%dk"), Population / 1000), ResetMilliseconds / Repetitions, TEXT("ms"));
+
+		Report.Add(FString::Printf(TEXT("WorldRebuild.%dk"), Population / 1000), FBltBenchmarkReport::Time([ActorClass, Population]()
+		{
+			FBltBenchmarkWorld FreshWorld;
+			FreshWorld.Spawn(ActorClass, Population);
+		}), TEXT("ms"));
+	}
+
+	return Report.Save(*this);
+}
+
+
+// Needs a running game or PIE session: reset latency of the loaded map against OpenLevel on the same map
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(
+	FBltOpenLevelBenchmark,
+	"Blt.Benchmarks.OpenLevel",
+	EAutomationTestFlags::ClientContext | EAutomationTestFlags::PerfFilter
+)
+
+bool FBltOpenLevelBenchmark::RunTest(const FString& Parameters)
+{
+	FWorldContext* GameWorldContext = nullptr;
+	for (FWorldContext& WorldContext : GEngine->GetWorldContexts())
+	{
+		if (WorldContext.OwningGameInstance && WorldContext.World() && WorldContext.World()->HasBegunPlay())
+		{
+			GameWorldContext = &WorldContext;
+			break;
+		}
+	}
+
+	if (!GameWorldContext)
+	{
+		AddWarning(TEXT("No game world is running, start PIE or -game first"));
+		return true;
+	}
+
+	UWorld* const World = GameWorldContext->World();
+	const FBltFuzzPlanPtr Plan = MakeCheckpointPlan(AActor::StaticClass());
+
+	FBltWorldCheckpoint& Checkpoint = FBltWorldCheckpoint::Get(World);
+	const TSharedRef<FBltBenchmarkReport> Report = MakeShared<FBltBenchmarkReport>(TEXT("OpenLevel"));
+	Report->Add(TEXT("Capture"), FBltBenchmarkReport::Time([&Checkpoint, &Plan]()
+	{
+		Checkpoint.Capture(*Plan);
+	}), TEXT("ms"));
+	Report->Add(TEXT("Actors"), Checkpoint.Num(), TEXT("count"));
+	Report->Add(TEXT("Reset"), FBltBenchmarkReport::Time([&Checkpoint]()
+	{
+		Checkpoint.Reset();
+	}), TEXT("ms"));
+
+	ADD_LATENT_AUTOMATION_COMMAND(FBltOpenLevelCommand(*this, Report, *GameWorldContext));
+	return true;
+}
+
+#endif
@@ -0,0 +1,300 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "BltBenchmarkActor.h"
+#include "BltBenchmarkReport.h"
+#include "BltBenchmarkWorld.h"
+#include "BltFuzzBatch.h"
+#include "BltFuzzPlan.h"
+#include "BltFuzzSpecReader.h"
+#include "BltNumericMutators.h"
+#include "BltRandom.h"
+#include "Misc/AutomationTest.h"
+#include "Serialization/JsonSerializer.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+
+namespace
+{
+	FBltFuzzPlanPtr MakeBenchmarkPlan(const bool bWithStrings = true)
+	{
+		TArray<FBltFuzzClassSpec> Classes;
+		FBltFuzzClassSpec& ClassSpec = Classes.AddDefaulted_GetRef();
+		ClassSpec.ClassName = ABltBenchmarkActor::StaticClass()->GetName();
+		ClassSpec.Class = ABltBenchmarkActor::StaticClass();
+
+		const auto AddInterval = [&ClassSpec](const TCHAR* const PropertyName, const double Min, const double Max)
+		{
+			FBltFuzzPropertySpec& PropertySpec = ClassSpec.Properties.Add(PropertyName);
+			PropertySpec.PropertyName = PropertyName;
+			PropertySpec.Source = EBltFuzzRangeSource::Interval;
+			PropertySpec.Min = Min;
+			PropertySpec.Max = Max;
+		};
+
+		AddInterval(TEXT("test_WalkSpeed"), 45.0, 900.0);
+		AddInterval(TEXT("test_RunSpeed"), 0.0, 10000.0);
+		AddInterval(TEXT("test_JumpHeight"), 0.0, 10000.0);
+		AddInterval(TEXT("Health"), 0.0, 100.0);
+		AddInterval(TEXT("BaseTurnRate"), 45.0, 90.0);
+		AddInterval(TEXT("bIsSprinting"), 0.0, 1.0);
+
+		if (!bWithStrings)
+			return MakeShared<const FBltFuzzPlan, ESPMode::ThreadSafe>(TEXT("Benchmark"), MoveTemp(Classes));
+
+		FBltFuzzPropertySpec& NameSpec = ClassSpec.Properties.Add(TEXT("Name"));
+		NameSpec.PropertyName = TEXT("Name");
+		NameSpec.Source = EBltFuzzRangeSource::Regex;
+		NameSpec.Regex = TEXT("Hello, [\\d]{1-4} [World]!");
+
+		return MakeShared<const FBltFuzzPlan, ESPMode::ThreadSafe>(TEXT("Benchmark"), MoveTemp(Classes));
+	}
+
+	// Shaped like the generated specs: every class with a mix of intervals and regexes
+	bool WriteBenchmarkSpec(const FString& FilePath, const int32 ClassCount, const int32 PropertyCount)
+	{
+		const TUniquePtr<FArchive> Archive(IFileManager::Get().CreateFileWriter(*FilePath));
+		if (!Archive)
+			return false;
+
+		for (int32 ClassIndex = 0; ClassIndex < ClassCount; ++ClassIndex)
+		{
+			TAnsiStringBuilder<16 * 1024> Builder;
+			Builder.Appendf("%s\n  \"BenchmarkClass_%d\": {", ClassIndex == 0 ? "{" : ",", ClassIndex);
+			for (int32 PropertyIndex = 0; PropertyIndex < PropertyCount; ++PropertyIndex)
+			{
+				Builder.Appendf(PropertyIndex % 4 == 3
+					? "%s\n    \"Property_%d\": \"[A-Z][a-z]{2,12} \\\\d{1,4}\""
+					: "%s\n    \"Property_%d\": [%d, %d.5]",
+					PropertyIndex == 0 ? "" : ",", PropertyIndex, -PropertyIndex, PropertyIndex * 1000);
+			}
+			Builder.Append("\n  }");
+			Archive->Serialize(const_cast<ANSICHAR*>(Builder.GetData()), Builder.Len());
+		}
+
+		Archive->Serialize(const_cast<ANSICHAR*>("\n}\n"), 3);
+		return Archive->Close();
+	}
+
+	// Every planned value of every actor, in actor then property order
+	void ReadValues(const TArray<AActor*>& Actors, const FBltFuzzClassPlan& ClassPlan, TArray<uint64>& OutBits)
+	{
+		OutBits.Reset(Actors.Num() * ClassPlan.Properties.Num());
+		for (const AActor* const Actor : Actors)
+		{
+			for (const FBltFuzzPropertyPlan& PropertyPlan : ClassPlan.Properties)
+			{
+				uint64 Bits = 0u;
+				FBltNumericMutators::Read(PropertyPlan, reinterpret_cast<const uint8*>(Actor) + PropertyPlan.Offset, Bits);
+				OutBits.Add(Bits);
+			}
+		}
+	}
+
+	int64 GetUsedPhysical()
+	{
+		return static_cast<int64>(FPlatformMemory::GetStats().UsedPhysical);
+	}
+}
+
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(
+	FBltParallelScalingBenchmark,
+	"Blt.Benchmarks.ParallelScaling",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::PerfFilter
+)
+
+bool FBltParallelScalingBenchmark::RunTest(const FString& Parameters)
+{
+	constexpr int32 ActorCount = 20000;
+	constexpr int32 Repetitions = 5;
+
+	FBltBenchmarkWorld World;
+	const TArray<AActor*> Actors = World.Spawn<ABltBenchmarkActor>(ActorCount);
+
+	const FBltFuzzPlanPtr Plan = MakeBenchmarkPlan();
+	const FBltFuzzClassPlan& ClassPlan = Plan->FindOrResolveClassPlan(0, ABltBenchmarkActor::StaticClass());
+
+	FBltBenchmarkReport Report(TEXT("ParallelScaling"));
+	const int32 MaxWorkers = FTaskGraphInterface::Get().GetNumWorkerThreads() + 1;
+	for (int32 Workers = 1; ; Workers = FMath::Min(Workers * 2, MaxWorkers))
+	{
+		double Seconds = 0.0;
+		for (int32 Repetition = 0; Repetition < Repetitions; ++Repetition)
+		{
+			FBltFuzzPass Pass;
+			Pass.Iteration = Repetition;
+
+			FBltFuzzBatch Batch(Pass);
+			for (AActor* const Actor : Actors)
+			{
+				Batch.Add(Actor, ClassPlan);
+			}
+
+			const double StartTime = FPlatformTime::Seconds();
+			Batch.Compute(Workers);
+			Batch.Commit(Workers);
+			Seconds += FPlatformTime::Seconds() - StartTime;
+		}
+
+		Report.Add(FString::Printf(TEXT("Workers.%d"), Workers), ActorCount * Repetitions / Seconds, TEXT("actors/s"));
+
+		if (Workers == MaxWorkers)
+			break;
+	}
+
+	return Report.Save(*this);
+}
+
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(
+	FBltBatchKernelsBenchmark,
+	"Blt.Benchmarks.BatchKernels",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::PerfFilter
+)
+
+bool FBltBatchKernelsBenchmark::RunTest(const FString& Parameters)
+{
+	constexpr int32 ActorCount = 10000;
+	constexpr int32 Repetitions = 5;
+
+	FBltBenchmarkWorld World;
+	const TArray<AActor*> Actors = World.Spawn<ABltBenchmarkActor>(ActorCount);
+
+	const FBltFuzzPlanPtr Plan = MakeBenchmarkPlan(false);
+	const FBltFuzzClassPlan& ClassPlan = Plan->FindOrResolveClassPlan(0, ABltBenchmarkActor::StaticClass());
+
+	TArray<uint32> ActorIds;
+	for (const AActor* const Actor : Actors)
+	{
+		ActorIds.Add(FBltRandomStream::HashObject(Actor));
+	}
+
+	double ScalarSeconds = MAX_dbl;
+	double ColumnSeconds = MAX_dbl;
+	double ParallelSeconds = MAX_dbl;
+	bool bIdentical = true;
+	TArray<uint64> ScalarBits;
+	TArray<uint64> ColumnBits;
+
+	for (int32 Repetition = 0; Repetition < Repetitions; ++Repetition)
+	{
+		FBltFuzzPass Pass;
+		Pass.Iteration = Repetition;
+
+		// One stream per actor and property, as the per-actor path samples
+		const auto MutateScalar = [&Actors, &ActorIds, &ClassPlan, &Pass](const int32 Iteration)
+		{
+			for (int32 ActorIndex = 0; ActorIndex < Actors.Num(); ++ActorIndex)
+			{
+				for (const FBltFuzzPropertyPlan& PropertyPlan : ClassPlan.Properties)
+				{
+					FBltRandomStream Stream(Pass.Seed, Iteration, ActorIds[ActorIndex], PropertyPlan.PropertyId);
+					FBltNumericMutators::Mutate(PropertyPlan, reinterpret_cast<uint8*>(Actors[ActorIndex]) + PropertyPlan.Offset, Stream);
+				}
+			}
+		};
+
+		const double StartTime = FPlatformTime::Seconds();
+		MutateScalar(Pass.Iteration);
+		ScalarSeconds = FMath::Min(ScalarSeconds, FPlatformTime::Seconds() - StartTime);
+		ReadValues(Actors, ClassPlan, ScalarBits);
+
+		for (const int32 MaxConcurrency : { 1, 0 })
+		{
+			// Scrambled first, so a batch that writes nothing cannot match
+			MutateScalar(Pass.Iteration + Repetitions);
+
+			FBltFuzzBatch Batch(Pass);
+			for (AActor* const Actor : Actors)
+			{
+				Batch.Add(Actor, ClassPlan);
+			}
+
+			const double BatchStartTime = FPlatformTime::Seconds();
+			Batch.Compute(MaxConcurrency);
+			Batch.Commit(MaxConcurrency);
+			double& Seconds = MaxConcurrency == 1 ? ColumnSeconds : ParallelSeconds;
+			Seconds = FMath::Min(Seconds, FPlatformTime::Seconds() - BatchStartTime);
+
+			ReadValues(Actors, ClassPlan, ColumnBits);
+			bIdentical &= ColumnBits == ScalarBits;
+		}
+	}
+
+	TestTrue(TEXT("Column kernels match the per-stream values bit for bit"), bIdentical);
+
+	const int32 ValueCount = ActorCount * ClassPlan.Properties.Num();
+	FBltBenchmarkReport Report(TEXT("BatchKernels"));
+	Report.Add(TEXT("Scalar"), ValueCount / ScalarSeconds, TEXT("values/s"));
+	Report.Add(TEXT("Columns.SingleThread"), ValueCount / ColumnSeconds, TEXT("values/s"));
+	Report.Add(TEXT("Columns.Parallel"), ValueCount / ParallelSeconds, TEXT("values/s"));
+	return Report.Save(*this);
+}
+
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(
+	FBltSpecLoadingBenchmark,
+	"Blt.Benchmarks.SpecLoading",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::PerfFilter
+)
+
+bool FBltSpecLoadingBenchmark::RunTest(const FString& Parameters)
+{
+	constexpr int32 ClassCount = 4000;
+	constexpr int32 PropertyCount = 100;
+	constexpr int32 Repetitions = 3;
+
+	const FString FilePath = FPaths::ProjectSavedDir() / TEXT("Blt") / TEXT("BenchmarkSpec.json");
+	if (!TestTrue(TEXT("Benchmark spec written"), WriteBenchmarkSpec(FilePath, ClassCount, PropertyCount)))
+		return false;
+
+	FBltBenchmarkReport Report(TEXT("SpecLoading"));
+	Report.Add(TEXT("SpecSize"), IFileManager::Get().FileSize(*FilePath) / (1024.0 * 1024.0), TEXT("MB"));
+
+	// Memory is sampled while everything the loader built is still alive, which is where both paths peak
+	double DomSeconds = MAX_dbl;
+	double StreamSeconds = MAX_dbl;
+	int64 DomBytes = 0;
+	int64 StreamBytes = 0;
+
+	for (int32 Repetition = 0; Repetition < Repetitions; ++Repetition)
+	{
+		{
+			const int64 StartBytes = GetUsedPhysical();
+			const double StartTime = FPlatformTime::Seconds();
+
+			// FJsonSerializer alone as the baseline, before any spec entry is decoded out of the DOM
+			FString JsonRaw;
+			TSharedPtr<FJsonObject> JsonObject;
+			const bool bLoaded = FFileHelper::LoadFileToString(JsonRaw, *FilePath)
+				&& FJsonSerializer::Deserialize(TJsonReaderFactory<TCHAR>::Create(JsonRaw), JsonObject);
+
+			DomSeconds = FMath::Min(DomSeconds, FPlatformTime::Seconds() - StartTime);
+			DomBytes = FMath::Max(DomBytes, GetUsedPhysical() - StartBytes);
+			TestTrue(TEXT("DOM holds every class"), bLoaded && JsonObject->Values.Num() == ClassCount);
+		}
+
+		{
+			const int64 StartBytes = GetUsedPhysical();
+			const double StartTime = FPlatformTime::Seconds();
+
+			TArray<FBltFuzzClassSpec> Classes;
+			const bool bLoaded = FBltFuzzSpecReader::ReadFile(FilePath, Classes);
+
+			StreamSeconds = FMath::Min(StreamSeconds, FPlatformTime::Seconds() - StartTime);
+			StreamBytes = FMath::Max(StreamBytes, GetUsedPhysical() - StartBytes);
+			TestTrue(TEXT("Streaming path decoded every class"), bLoaded && Classes.Num() == ClassCount);
+		}
+	}
+
+	Report.Add(TEXT("FJsonSerializer.Time"), DomSeconds * 1000.0, TEXT("ms"));
+	Report.Add(TEXT("FJsonSerializer.Memory"), DomBytes / (1024.0 * 1024.0), TEXT("MB"));
+	Report.Add(TEXT("Streaming.Time"), StreamSeconds * 1000.0, TEXT("ms"));
+	Report.Add(TEXT("Streaming.Memory"), StreamBytes / (1024.0 * 1024.0), TEXT("MB"));
+
+	IFileManager::Get().Delete(*FilePath);
+	return Report.Save(*this);
+}
+
+#endif
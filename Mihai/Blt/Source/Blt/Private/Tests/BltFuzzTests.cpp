@@ -0,0 +1,362 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "BltBenchmarkActor.h"
+#include "BltBenchmarkWorld.h"
+#include "BltBPLibrary.h"
+#include "BltFuzzPlan.h"
+#include "BltFuzzSpecReader.h"
+#include "BltFuzzTask.h"
+#include "BltNumericMutators.h"
+#include "BltRandom.h"
+#include "BltValueDistribution.h"
+#include "Misc/AutomationTest.h"
+#include "Serialization/MemoryReader.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+
+namespace
+{
+	// One entry of every kind the spec supports, kept out of the sample Data/fuzzing.json
+	const TCHAR* const ShowcaseSpec = TEXT(R"({
+		"GameTestingCharacter": {
+			"Health": { "Range": [0, 100], "Edges": [0, -1, "NaN", "Denormal"], "EdgeRate": 0.2 },
+			"CharacterMovement.MaxWalkSpeed": { "Range": [300, 1200], "Strategy": "Mutate" }
+		},
+		"MyCharacter": {
+			"test_JumpHeight": { "Buckets": [[0, 1000, 3], [1000, 1000000, 1]], "Scale": "Log", "Boundaries": 0.05 }
+		}
+	})");
+
+	// Text of every property the class itself declares, in declaration order
+	TArray<FString> ExportOwnProperties(const AActor* const Actor)
+	{
+		TArray<FString> Values;
+		for (TFieldIterator<FProperty> Iterator(Actor->GetClass(), EFieldIteratorFlags::ExcludeSuper); Iterator; ++Iterator)
+		{
+			FString& Value = Values.AddDefaulted_GetRef();
+			Iterator->ExportTextItem(Value, Iterator->ContainerPtrToValuePtr<void>(Actor), nullptr, nullptr, PPF_None);
+		}
+		return Values;
+	}
+
+	// Entries for AActor and ABltBenchmarkNumericActor, so every numeric actor matches both
+	FBltFuzzPlanPtr MakeOverlappingPlan()
+	{
+		TArray<FBltFuzzClassSpec> Classes;
+		const auto AddEntry = [&Classes](UClass* const Class)
+		{
+			FBltFuzzClassSpec& ClassSpec = Classes.AddDefaulted_GetRef();
+			ClassSpec.ClassName = Class->GetName();
+			ClassSpec.Class = Class;
+			return &ClassSpec;
+		};
+		const auto AddInterval = [](FBltFuzzClassSpec* const ClassSpec, const TCHAR* const PropertyName, const double Min, const double Max, const EBltFuzzStrategy Strategy)
+		{
+			FBltFuzzPropertySpec& PropertySpec = ClassSpec->Properties.Add(PropertyName);
+			PropertySpec.PropertyName = PropertyName;
+			PropertySpec.Source = EBltFuzzRangeSource::Interval;
+			PropertySpec.Strategy = Strategy;
+			PropertySpec.Min = Min;
+			PropertySpec.Max = Max;
+		};
+
+		// Health and Score are named by both entries, Ammo only by the base one
+		FBltFuzzClassSpec* const BaseEntry = AddEntry(AActor::StaticClass());
+		AddInterval(BaseEntry, TEXT("Health"), 0.0, 100.0, EBltFuzzStrategy::Sample);
+		AddInterval(BaseEntry, TEXT("Score"), 0.0, 1000.0, EBltFuzzStrategy::Sample);
+		AddInterval(BaseEntry, TEXT("Ammo"), 0.0, 30.0, EBltFuzzStrategy::Sample);
+
+		FBltFuzzClassSpec* const DerivedEntry = AddEntry(ABltBenchmarkNumericActor::StaticClass());
+		AddInterval(DerivedEntry, TEXT("Health"), 50.0, 60.0, EBltFuzzStrategy::Sample);
+		AddInterval(DerivedEntry, TEXT("Score"), 0.0, 1000.0, EBltFuzzStrategy::Mutate);
+
+		return MakeShared<const FBltFuzzPlan, ESPMode::ThreadSafe>(TEXT("OverlappingEntries"), MoveTemp(Classes));
+	}
+
+	const FBltFuzzPropertySpec* FindEntry(const TArray<FBltFuzzClassSpec>& Classes, const TCHAR* const ClassName, const TCHAR* const PropertyName)
+	{
+		const FBltFuzzClassSpec* const ClassSpec = Classes.FindByPredicate([ClassName](const FBltFuzzClassSpec& Candidate)
+		{
+			return Candidate.ClassName == ClassName;
+		});
+		return ClassSpec ? ClassSpec->Properties.Find(PropertyName) : nullptr;
+	}
+}
+
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(
+	FBltSeedSurvivesPassTest,
+	"Blt.Fuzzing.SeedSurvivesPass",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter
+)
+
+bool FBltSeedSurvivesPassTest::RunTest(const FString& Parameters)
+{
+	constexpr int64 Seed = 1234;
+	constexpr int32 Iteration = 7;
+
+	FBltBenchmarkWorld World;
+	const TArray<AActor*> Actors = World.Spawn<ABltSeededTestActor>(16);
+	for (AActor* const Actor : Actors)
+	{
+		CastChecked<ABltSeededTestActor>(Actor)->FuzzSeed = Seed;
+		CastChecked<ABltSeededTestActor>(Actor)->FuzzIteration = Iteration;
+	}
+
+	// Only one entry, so every other user defined numeric falls back to default fuzzing
+	TArray<FBltFuzzClassSpec> Classes;
+	FBltFuzzClassSpec& ClassSpec = Classes.AddDefaulted_GetRef();
+	ClassSpec.ClassName = ABltSeededTestActor::StaticClass()->GetName();
+	ClassSpec.Class = ABltSeededTestActor::StaticClass();
+
+	FBltFuzzPropertySpec& PropertySpec = ClassSpec.Properties.Add(TEXT("test_WalkSpeed"));
+	PropertySpec.PropertyName = TEXT("test_WalkSpeed");
+	PropertySpec.Source = EBltFuzzRangeSource::Interval;
+	PropertySpec.Min = 45.0;
+	PropertySpec.Max = 900.0;
+
+	const FBltFuzzPlan Plan(TEXT("SeedSurvivesPass"), MoveTemp(Classes));
+
+	FBltFuzzPass Pass;
+	Pass.Seed = Seed;
+	Pass.Iteration = Iteration;
+	UBltBPLibrary::ApplyFuzzPass(World.Get(), Plan, Pass, Actors, true, false);
+	UBltBPLibrary::ApplyFuzzPass(World.Get(), Plan, Pass, Actors, true, true);
+
+	for (const AActor* const Actor : Actors)
+	{
+		const ABltSeededTestActor* const SeededActor = CastChecked<const ABltSeededTestActor>(Actor);
+		TestEqual(TEXT("FuzzSeed after a pass"), SeededActor->FuzzSeed, Seed);
+		TestEqual(TEXT("FuzzIteration after a pass"), SeededActor->FuzzIteration, Iteration);
+	}
+
+	return true;
+}
+
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(
+	FBltOverlappingEntriesTest,
+	"Blt.Fuzzing.OverlappingEntries",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter
+)
+
+bool FBltOverlappingEntriesTest::RunTest(const FString& Parameters)
+{
+	FBltBenchmarkWorld World;
+	TArray<AActor*> Actors = World.Spawn<ABltBenchmarkNumericActor>(64);
+
+	// Listed twice, on top of matching both entries below
+	Actors.Append(TArray<AActor*>(Actors.GetData(), 8));
+
+	const FBltFuzzPlanPtr PlanPtr = MakeOverlappingPlan();
+	const FBltFuzzPlan& Plan = *PlanPtr;
+
+	FBltFuzzPass Pass;
+	Pass.Seed = 42;
+	Pass.Iteration = 3;
+
+	UBltBPLibrary::ApplyFuzzPass(World.Get(), Plan, Pass, Actors, true, false);
+
+	TArray<TArray<FString>> SerialValues;
+	for (const AActor* const Actor : Actors)
+	{
+		const ABltBenchmarkNumericActor* const NumericActor = CastChecked<const ABltBenchmarkNumericActor>(Actor);
+		TestTrue(TEXT("Health takes the derived entry"), NumericActor->Health >= 50.0f && NumericActor->Health <= 60.0f);
+		TestTrue(TEXT("Ammo keeps the base entry"), NumericActor->Ammo >= 0 && NumericActor->Ammo <= 30);
+		SerialValues.Add(ExportOwnProperties(Actor));
+	}
+
+	UBltBPLibrary::RestoreFuzzedProperties();
+	UBltBPLibrary::ApplyFuzzPass(World.Get(), Plan, Pass, Actors, true, true);
+
+	for (int32 Index = 0; Index < Actors.Num(); ++Index)
+	{
+		TestTrue(TEXT("Parallel pass matches the serial one"), ExportOwnProperties(Actors[Index]) == SerialValues[Index]);
+	}
+
+	UBltBPLibrary::RestoreFuzzedProperties();
+	return true;
+}
+
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(
+	FBltTimeSlicedPassTest,
+	"Blt.Fuzzing.TimeSlicedPass",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter
+)
+
+bool FBltTimeSlicedPassTest::RunTest(const FString& Parameters)
+{
+	FBltBenchmarkWorld World;
+	TArray<AActor*> Actors = World.Spawn<ABltBenchmarkNumericActor>(64);
+	Actors.Append(TArray<AActor*>(Actors.GetData(), 8));
+
+	const FBltFuzzPlanPtr Plan = MakeOverlappingPlan();
+
+	FBltFuzzPass Pass;
+	Pass.Seed = 42;
+	Pass.Iteration = 3;
+
+	UBltBPLibrary::ApplyFuzzPass(World.Get(), *Plan, Pass, Actors, true, false);
+
+	TArray<TArray<FString>> PassValues;
+	for (const AActor* const Actor : Actors)
+	{
+		PassValues.Add(ExportOwnProperties(Actor));
+	}
+
+	UBltBPLibrary::RestoreFuzzedProperties();
+
+	// A zero budget mutates one property per step, the most a cursor can be parked and resumed
+	const TSharedRef<FBltFuzzTask> Task = MakeShared<FBltFuzzTask>(World.Get(), Plan, Pass, Actors, true);
+	TestEqual(TEXT("Every actor is targeted once"), Task->GetTotalActors(), 64);
+	while (!Task->Step(0.0))
+	{
+	}
+
+	for (int32 Index = 0; Index < Actors.Num(); ++Index)
+	{
+		TestTrue(TEXT("Time sliced pass matches ApplyFuzzPass"), ExportOwnProperties(Actors[Index]) == PassValues[Index]);
+	}
+
+	UBltBPLibrary::RestoreFuzzedProperties();
+	return true;
+}
+
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(
+	FBltMutationStaysInRangeTest,
+	"Blt.Fuzzing.MutationStaysInRange",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter
+)
+
+bool FBltMutationStaysInRangeTest::RunTest(const FString& Parameters)
+{
+	constexpr int32 Steps = 10000;
+
+	// Default range of a user defined property without an entry
+	FBltFuzzPropertyPlan PropertyPlan;
+	PropertyPlan.Strategy = EBltFuzzStrategy::Mutate;
+	PropertyPlan.Min = 0.0;
+	PropertyPlan.Max = 1000000.0;
+	PropertyPlan.IntegerMin = 0u;
+	PropertyPlan.IntegerMax = 1000000u;
+
+	FBltRandomStream Stream(1, 0, 0u, 0u);
+
+	uint64 FloatBits = TBltNumericMutator<float>::ToBits(100.0f);
+	uint64 IntegerBits = TBltNumericMutator<int32>::ToBits(100);
+	bool bFloatInRange = true;
+	bool bIntegerInRange = true;
+	for (int32 Step = 0; Step < Steps; ++Step)
+	{
+		FloatBits = TBltNumericMutator<float>::Perturb(PropertyPlan, FloatBits, Stream);
+		IntegerBits = TBltNumericMutator<int32>::Perturb(PropertyPlan, IntegerBits, Stream);
+
+		const float Float = TBltNumericMutator<float>::FromBits(FloatBits);
+		const int32 Integer = TBltNumericMutator<int32>::FromBits(IntegerBits);
+		bFloatInRange &= Float >= 0.0f && Float <= 1000000.0f;
+		bIntegerInRange &= Integer >= 0 && Integer <= 1000000;
+	}
+
+	TestTrue(TEXT("Float walk stays in the default range"), bFloatInRange);
+	TestTrue(TEXT("Integer walk stays in the default range"), bIntegerInRange);
+	return true;
+}
+
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(
+	FBltNamePoolSurvivesReloadTest,
+	"Blt.Fuzzing.NamePoolSurvivesReload",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter
+)
+
+bool FBltNamePoolSurvivesReloadTest::RunTest(const FString& Parameters)
+{
+	const auto MakeClasses = [](const uint32 SourceHash)
+	{
+		TArray<FBltFuzzClassSpec> Classes;
+		FBltFuzzClassSpec& ClassSpec = Classes.AddDefaulted_GetRef();
+		ClassSpec.ClassName = ABltBenchmarkStringActor::StaticClass()->GetName();
+		ClassSpec.Class = ABltBenchmarkStringActor::StaticClass();
+		ClassSpec.SourceHash = SourceHash;
+
+		FBltFuzzPropertySpec& FactionSpec = ClassSpec.Properties.Add(TEXT("Faction"));
+		FactionSpec.PropertyName = TEXT("Faction");
+		FactionSpec.Source = EBltFuzzRangeSource::Regex;
+		FactionSpec.Regex = TEXT("[A-Z]{4}");
+		return Classes;
+	};
+
+	const auto FindFactionPool = [](const FBltFuzzPlan& Plan)
+	{
+		for (const FBltFuzzPropertyPlan& PropertyPlan : Plan.FindOrResolveClassPlan(0, ABltBenchmarkStringActor::StaticClass()).Properties)
+		{
+			if (PropertyPlan.PathName == TEXT("Faction"))
+				return PropertyPlan.NamePool.Get();
+		}
+		return static_cast<FBltNamePool*>(nullptr);
+	};
+
+	// A changed entry is resolved from scratch, yet has to come back to the names it already added
+	const FBltFuzzPlan Original(TEXT("NamePoolSurvivesReload"), MakeClasses(1u));
+	const FBltFuzzPlan Reloaded(TEXT("NamePoolSurvivesReload"), MakeClasses(2u), &Original);
+	const FBltFuzzPlan Other(TEXT("NamePoolSurvivesReload.Other"), MakeClasses(1u));
+
+	const FBltNamePool* const OriginalPool = FindFactionPool(Original);
+	if (!TestNotNull(TEXT("Faction has a name pool"), OriginalPool))
+		return true;
+
+	TestTrue(TEXT("Reloaded entry keeps its pool"), FindFactionPool(Reloaded) == OriginalPool);
+	TestTrue(TEXT("Another spec gets a pool of its own"), FindFactionPool(Other) != OriginalPool);
+	return true;
+}
+
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(
+	FBltShowcaseSpecTest,
+	"Blt.Fuzzing.ShowcaseSpec",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter
+)
+
+bool FBltShowcaseSpecTest::RunTest(const FString& Parameters)
+{
+	const FTCHARToUTF8 Utf8Spec(ShowcaseSpec);
+	const TArray<uint8> Bytes(reinterpret_cast<const uint8*>(Utf8Spec.Get()), Utf8Spec.Length());
+	FMemoryReader Archive(Bytes);
+
+	TArray<FBltFuzzClassSpec> Classes;
+	TestTrue(TEXT("Showcase decoded"), FBltFuzzSpecReader(Archive).Read(Classes));
+
+	const FBltFuzzPropertySpec* const Health = FindEntry(Classes, TEXT("GameTestingCharacter"), TEXT("Health"));
+	if (TestNotNull(TEXT("Health entry"), Health))
+	{
+		TestTrue(TEXT("Health is a distribution"), Health->Source == EBltFuzzRangeSource::Distribution);
+		TestEqual(TEXT("Health edges"), Health->Distribution.Edges.Num(), 4);
+
+		FString Error;
+		TestTrue(TEXT("Health compiles for a float"), FBltValueDistribution::Compile(Health->Distribution, EBltFuzzValueType::Float, Error).IsValid());
+		TestFalse(TEXT("NaN is no int32 edge"), FBltValueDistribution::Compile(Health->Distribution, EBltFuzzValueType::Int32, Error).IsValid());
+	}
+
+	const FBltFuzzPropertySpec* const MaxWalkSpeed = FindEntry(Classes, TEXT("GameTestingCharacter"), TEXT("CharacterMovement.MaxWalkSpeed"));
+	if (TestNotNull(TEXT("CharacterMovement.MaxWalkSpeed entry"), MaxWalkSpeed))
+	{
+		TestTrue(TEXT("MaxWalkSpeed is an interval"), MaxWalkSpeed->Source == EBltFuzzRangeSource::Interval);
+		TestTrue(TEXT("MaxWalkSpeed is mutated"), MaxWalkSpeed->Strategy == EBltFuzzStrategy::Mutate);
+		TestEqual(TEXT("MaxWalkSpeed max"), MaxWalkSpeed->Max, 1200.0);
+	}
+
+	const FBltFuzzPropertySpec* const JumpHeight = FindEntry(Classes, TEXT("MyCharacter"), TEXT("test_JumpHeight"));
+	if (TestNotNull(TEXT("test_JumpHeight entry"), JumpHeight))
+	{
+		TestTrue(TEXT("test_JumpHeight is a distribution"), JumpHeight->Source == EBltFuzzRangeSource::Distribution);
+		TestTrue(TEXT("test_JumpHeight is log scaled"), JumpHeight->Distribution.bLogScale);
+		TestEqual(TEXT("test_JumpHeight buckets"), JumpHeight->Distribution.Buckets.Num(), 2);
+	}
+
+	return true;
+}
+
+#endif
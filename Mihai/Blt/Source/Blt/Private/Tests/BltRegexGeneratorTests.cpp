@@ -0,0 +1,83 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "BltRandom.h"
+#include "BltRegexGenerator.h"
+#include "Internationalization/Regex.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(
+	FBltRegexGeneratorTest,
+	"Blt.Fuzzing.RegexGenerator",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter
+)
+
+bool FBltRegexGeneratorTest::RunTest(const FString& Parameters)
+{
+	constexpr int32 Samples = 64;
+
+	// Every construct the native generator renders, each string checked against the pattern itself
+	static const TCHAR* const Supported[] = {
+		TEXT("abc"),
+		TEXT("a|bc|def"),
+		TEXT("[a-z]{3,5}"),
+		TEXT("[^0-9]+"),
+		TEXT("[\\d_\\-]{2}"),
+		TEXT("\\d\\w\\s\\D\\W\\S"),
+		TEXT("\\.\\-\\\\\\(\\t"),
+		TEXT("(?:ab|cd)*"),
+		TEXT("(?<tag>[A-F]){2}x?"),
+		TEXT("(?P<name>x+)y{0,3}"),
+		TEXT("a+?b*+c??"),
+		TEXT(".{0,8}"),
+		TEXT("^start$")
+	};
+
+	for (const TCHAR* const Pattern : Supported)
+	{
+		const FBltRegexGeneratorPtr Generator = FBltRegexGenerator::Compile(Pattern);
+		if (!TestNotNull(*FString::Printf(TEXT("%s compiles natively"), Pattern), Generator.Get()))
+			continue;
+
+		const FRegexPattern Anchored(FString::Printf(TEXT("^(?:%s)$"), Pattern));
+		FBltRandomStream Stream(7, 0, 0u, 0u);
+		FString String;
+		for (int32 Sample = 0; Sample < Samples; ++Sample)
+		{
+			Generator->Generate(Stream, String);
+
+			FRegexMatcher Matcher(Anchored, String);
+			if (!Matcher.FindNext())
+			{
+				AddError(FString::Printf(TEXT("%s rendered \"%s\", which it does not match"), Pattern, *String));
+				break;
+			}
+		}
+	}
+
+	// Anything that constrains its surroundings or names a code point goes to the Python bridge
+	static const TCHAR* const Unsupported[] = {
+		TEXT("\\bfoo\\b"),
+		TEXT("\\Afoo\\Z"),
+		TEXT("\\x41"),
+		TEXT("\\u0041"),
+		TEXT("\\p{L}"),
+		TEXT("[\\x41-\\x5A]"),
+		TEXT("(a)\\1"),
+		TEXT("(?P<name>a)(?P=name)"),
+		TEXT("(?=a)b"),
+		TEXT("(?<=a)b"),
+		TEXT("(?<!a)b")
+	};
+
+	for (const TCHAR* const Pattern : Unsupported)
+	{
+		TestNull(*FString::Printf(TEXT("%s is left to Python"), Pattern), FBltRegexGenerator::Compile(Pattern).Get());
+	}
+
+	return true;
+}
+
+#endif
@@ -0,0 +1,235 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "Algo/Find.h"
+#include "BltActorIndex.h"
+#include "BltBenchmarkActor.h"
+#include "BltBenchmarkReport.h"
+#include "BltBenchmarkWorld.h"
+#include "BltBPLibrary.h"
+#include "BltFuzzBatch.h"
+#include "BltFuzzPlan.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+
+// Headless run for the nightlies:
+//   UE4Editor-Cmd <Project> -nullrhi -unattended -ExecCmds="Automation RunTests Blt.Benchmarks.Throughput; Quit"
+namespace
+{
+	struct FThroughputScenario
+	{
+		const TCHAR* Name;
+		UClass* (*GetClass)();
+
+		// How many of the fields declared by the class get a spec entry, INDEX_NONE for all of them
+		int32 NumericFields;
+		int32 StringFields;
+	};
+
+	const FThroughputScenario Scenarios[] =
+	{
+		{ TEXT("Mixed"), &ABltBenchmarkActor::StaticClass, INDEX_NONE, INDEX_NONE },
+		{ TEXT("Numeric"), &ABltBenchmarkNumericActor::StaticClass, INDEX_NONE, 0 },
+		{ TEXT("Strings"), &ABltBenchmarkStringActor::StaticClass, 0, INDEX_NONE },
+		{ TEXT("Components"), &ABltBenchmarkComponentActor::StaticClass, INDEX_NONE, INDEX_NONE }
+	};
+
+	const int32 Populations[] = { 1000, 10000, 100000 };
+
+	bool IsStringProperty(const FProperty* const Property)
+	{
+		return Property->IsA<FStrProperty>() || Property->IsA<FNameProperty>() || Property->IsA<FTextProperty>();
+	}
+
+	bool IsNumericProperty(const FProperty* const Property)
+	{
+		return Property->IsA<FNumericProperty>() || Property->IsA<FBoolProperty>() || Property->IsA<FEnumProperty>();
+	}
+
+	// Entries for the fields declared by Struct, under Prefix; components declared next to the benchmark
+	// actors are walked too, so their fields are fuzzed through dotted paths
+	void AppendScenarioEntries(
+		const FThroughputScenario& Scenario,
+		const UStruct* const Struct,
+		const FString& Prefix,
+		TAnsiStringBuilder<4096>& Builder,
+		int32& NumericFields,
+		int32& StringFields
+	)
+	{
+		for (TFieldIterator<FProperty> Iterator(Struct, EFieldIteratorFlags::ExcludeSuper); Iterator; ++Iterator)
+		{
+			const FProperty* const Property = *Iterator;
+			const FString PathName = Prefix + Property->GetName();
+			const bool bString = IsStringProperty(Property);
+			if (bString && (Scenario.StringFields == INDEX_NONE || StringFields < Scenario.StringFields))
+			{
+				Builder.Appendf("%s\n    \"%s\": \"[A-Z][a-z]{3,10} \\\\d{1,3}\"",
+					NumericFields + StringFields == 0 ? "" : ",", TCHAR_TO_UTF8(*PathName));
+				++StringFields;
+			}
+			else if (!bString && IsNumericProperty(Property)
+				&& (Scenario.NumericFields == INDEX_NONE || NumericFields < Scenario.NumericFields))
+			{
+				Builder.Appendf("%s\n    \"%s\": [0, 100]",
+					NumericFields + StringFields == 0 ? "" : ",", TCHAR_TO_UTF8(*PathName));
+				++NumericFields;
+			}
+			else if (const FObjectProperty* const ObjectProperty = CastField<const FObjectProperty>(Property))
+			{
+				const UClass* const ComponentClass = ObjectProperty->PropertyClass;
+				if (Prefix.IsEmpty() && ComponentClass->IsChildOf<UActorComponent>() && ComponentClass->GetOutermost() == Struct->GetOutermost())
+				{
+					AppendScenarioEntries(Scenario, ComponentClass, PathName + TEXT("."), Builder, NumericFields, StringFields);
+				}
+			}
+		}
+	}
+
+	bool WriteScenarioSpec(const FThroughputScenario& Scenario, const FString& FilePath)
+	{
+		const UClass* const Class = Scenario.GetClass();
+
+		int32 NumericFields = 0;
+		int32 StringFields = 0;
+		TAnsiStringBuilder<4096> Builder;
+		Builder.Appendf("{\n  \"%s\": {", TCHAR_TO_UTF8(*Class->GetName()));
+		AppendScenarioEntries(Scenario, Class, FString(), Builder, NumericFields, StringFields);
+		Builder.Append("\n  }\n}\n");
+
+		return FFileHelper::SaveStringToFile(FString(Builder.ToString()), *FilePath);
+	}
+}
+
+
+IMPLEMENT_COMPLEX_AUTOMATION_TEST(
+	FBltThroughputBenchmark,
+	"Blt.Benchmarks.Throughput",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::PerfFilter
+)
+
+void FBltThroughputBenchmark::GetTests(TArray<FString>& OutBeautifiedNames, TArray<FString>& OutTestCommands) const
+{
+	for (const FThroughputScenario& Scenario : Scenarios)
+	{
+		for (const int32 Population : Populations)
+		{
+			OutBeautifiedNames.Add(FString::Printf(TEXT("%s.%dk"), Scenario.Name, Population / 1000));
+			OutTestCommands.Add(FString::Printf(TEXT("%s %d"), Scenario.Name, Population));
+		}
+	}
+}
+
+bool FBltThroughputBenchmark::RunTest(const FString& Parameters)
+{
+	FString ScenarioName;
+	FString PopulationString;
+	if (!Parameters.Split(TEXT(" "), &ScenarioName, &PopulationString))
+		return false;
+
+	const FThroughputScenario* const Scenario = Algo::FindByPredicate(Scenarios, [&ScenarioName](const FThroughputScenario& Candidate)
+	{
+		return ScenarioName == Candidate.Name;
+	});
+	if (!Scenario)
+		return false;
+
+	const int32 Population = FCString::Atoi(*PopulationString);
+	UClass* const ActorClass = Scenario->GetClass();
+
+	FBltBenchmarkReport Report(FString::Printf(TEXT("Throughput.%s.%dk"), Scenario->Name, Population / 1000));
+	FBltBenchmarkWorld World;
+
+	Report.Add(TEXT("Spawn"), FBltBenchmarkReport::Time([&World, ActorClass, Population]()
+	{
+		World.Spawn(ActorClass, Population);
+	}), TEXT("ms"));
+
+	const FString SpecPath = FPaths::ConvertRelativePathToFull(
+		FPaths::ProjectSavedDir() / TEXT("Blt") / TEXT("Benchmarks") / FString(Scenario->Name) + TEXT("Spec.json")
+	);
+	if (!TestTrue(TEXT("Benchmark spec written"), WriteScenarioSpec(*Scenario, SpecPath)))
+		return false;
+
+	// Phases are run one by one through the same entry points ApplyFuzzing goes through
+	FBltFuzzPlanHandle Handle;
+	Report.Add(TEXT("Phase.SpecLoad"), FBltBenchmarkReport::Time([&Handle, &SpecPath]()
+	{
+		Handle = UBltBPLibrary::ReloadFuzzPlan(SpecPath);
+	}), TEXT("ms"));
+
+	const FBltFuzzPlanPtr Plan = FBltFuzzPlanRegistry::Get().Find(Handle);
+	if (!TestNotNull(TEXT("Benchmark plan loaded"), Plan.Get()))
+		return false;
+
+	TArray<AActor*> Actors;
+	Report.Add(TEXT("Phase.ActorLookup.Cold"), FBltBenchmarkReport::Time([&World, &Actors, ActorClass]()
+	{
+		FBltActorIndex::Get(World.Get()).GetActorsOfClass(ActorClass, Actors);
+	}), TEXT("ms"));
+
+	Report.Add(TEXT("Phase.ActorLookup.Warm"), FBltBenchmarkReport::Time([&World, &Actors, ActorClass]()
+	{
+		Actors.Reset();
+		FBltActorIndex::Get(World.Get()).GetActorsOfClass(ActorClass, Actors);
+	}), TEXT("ms"));
+
+	TestEqual(TEXT("Every spawned actor found"), Actors.Num(), Population);
+
+	FBltFuzzPass Pass;
+	Pass.Iteration = 1;
+	FBltFuzzBatch Batch(Pass);
+	int32 Mutations = 0;
+
+	Report.Add(TEXT("Phase.Reflection"), FBltBenchmarkReport::Time([&Plan, &Actors, &Batch, &Mutations]()
+	{
+		for (AActor* const Actor : Actors)
+		{
+			const FBltFuzzClassPlan& ClassPlan = Plan->FindOrResolveClassPlan(0, Actor->GetClass());
+			Batch.Add(Actor, ClassPlan);
+			Mutations += ClassPlan.Properties.Num();
+		}
+	}), TEXT("ms"));
+
+	Report.Add(TEXT("Phase.Sampling"), FBltBenchmarkReport::Time([&Batch]()
+	{
+		Batch.Compute();
+	}), TEXT("ms"));
+
+	Report.Add(TEXT("Phase.Write"), FBltBenchmarkReport::Time([&Batch]()
+	{
+		Batch.Commit();
+	}), TEXT("ms"));
+
+	// Unloaded before each end to end run, so ApplyFuzzing reads and plans the spec again like a first call does
+	const auto UnloadSpec = [&SpecPath]()
+	{
+		UBltBPLibrary::UnloadFuzzPlan(FBltFuzzPlanRegistry::Get().FindByPath(SpecPath));
+	};
+
+	UnloadSpec();
+	const double SerialMilliseconds = FBltBenchmarkReport::Time([&World, &SpecPath]()
+	{
+		UBltBPLibrary::ApplyFuzzing(World.Get(), SpecPath, TArray<AActor*>(), false, 0, 2, false);
+	});
+
+	UnloadSpec();
+	const double ParallelMilliseconds = FBltBenchmarkReport::Time([&World, &SpecPath]()
+	{
+		UBltBPLibrary::ApplyFuzzing(World.Get(), SpecPath, TArray<AActor*>(), false, 0, 3, true);
+	});
+
+	Report.Add(TEXT("EndToEnd.Serial"), SerialMilliseconds, TEXT("ms"));
+	Report.Add(TEXT("EndToEnd.Parallel"), ParallelMilliseconds, TEXT("ms"));
+	Report.Add(TEXT("Mutations"), Mutations, TEXT("count"));
+	Report.Add(TEXT("Throughput.Serial"), Mutations / (SerialMilliseconds / 1000.0), TEXT("mutations/s"));
+	Report.Add(TEXT("Throughput.Parallel"), Mutations / (ParallelMilliseconds / 1000.0), TEXT("mutations/s"));
+
+	UnloadSpec();
+	IFileManager::Get().Delete(*SpecPath);
+
+	return Report.Save(*this);
+}
+
+#endif
@@ -4,18 +4,18 @@
 
 #include <fstream>
 #include <string>
+#include "BltFuzzPlan.h"
+#include "BltRandom.h"
 #include "BLTBPLibrary.generated.h"
 
 DECLARE_LOG_CATEGORY_EXTERN(LogBlt, Log, All);
 
 
 UCLASS(Abstract)
-class UBltBPLibrary final : public UBlueprintFunctionLibrary
+class BLT_API UBltBPLibrary final : public UBlueprintFunctionLibrary
 {
 	GENERATED_BODY()
 	
-	static bool ParseJson(const FString& FilePath, TSharedPtr<FJsonObject>& OutObject);
-
 	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Game Testing")
 	static bool GetAbsolutePath(const FString& FilePath, FString& AbsoluteFilePath);
 	
@@ -24,12 +24,16 @@ class UBltBPLibrary final : public UBlueprintFunctionLibrary
 	
 	UFUNCTION(BlueprintCallable, Category = "Game Testing", meta = (WorldContext = "WorldContextObject"))
 	static TArray<AActor*> GetAllActorsOfClass(const UObject* const WorldContextObject, const FString& ActorClassName);
-	
+
+public:
 	static void ApplyFuzzing(
 		const UObject* const WorldContextObject,
 		const FString& FilePath,
 		const TArray<AActor*>& AffectedActors = TArray<AActor*>(),
-		const bool bUseArray = false
+		const bool bUseArray = false,
+		const int64 Seed = 0,
+		const int32 Iteration = -1,
+		const bool bParallel = false
 	);
 	
 	UFUNCTION(BlueprintCallable, Category = "Game Testing", meta = (
@@ -41,42 +45,146 @@ class UBltBPLibrary final : public UBlueprintFunctionLibrary
 		const UObject* const WorldContextObject,
 		const FString& FilePath,
 		const TArray<AActor*>& AffectedActors,
+		const bool bUseArray = false,
+		const int64 Seed = 0,
+		const int32 Iteration = -1,
+		const bool bParallel = false
+	);
+
+	UFUNCTION(BlueprintCallable, Category = "Game Testing")
+	static FBltFuzzPlanHandle LoadFuzzPlan(const FString& FilePath);
+
+	// Parses the spec again and swaps the new plan in; entries whose text did not change keep their resolved plans
+	static FBltFuzzPlanHandle ReloadFuzzPlan(const FString& AbsoluteFilePath);
+
+	UFUNCTION(BlueprintCallable, Category = "Game Testing")
+	static void UnloadFuzzPlan(const FBltFuzzPlanHandle& Plan);
+
+	static void ApplyFuzzPlan(
+		const UObject* const WorldContextObject,
+		const FBltFuzzPlanHandle& Plan,
+		const TArray<AActor*>& AffectedActors = TArray<AActor*>(),
+		const bool bUseArray = false,
+		const int64 Seed = 0,
+		const int32 Iteration = -1,
+		const bool bParallel = false
+	);
+
+	// Runs one pass of an already resolved plan; the guided mode and the minimizer set up the pass themselves
+	static void ApplyFuzzPass(
+		const UObject* const WorldContextObject,
+		const FBltFuzzPlan& FuzzPlan,
+		const FBltFuzzPass& Pass,
+		const TArray<AActor*>& AffectedActors = TArray<AActor*>(),
+		const bool bUseArray = false,
+		const bool bParallel = false
+	);
+
+	UFUNCTION(BlueprintCallable, Category = "Game Testing", meta = (
+		DisplayName = "ApplyFuzzPlan",
+		WorldContext = "WorldContextObject",
+		AutoCreateRefTerm = "AffectedActors"
+	))
+	static void K2ApplyFuzzPlan(
+		const UObject* const WorldContextObject,
+		const FBltFuzzPlanHandle& Plan,
+		const TArray<AActor*>& AffectedActors,
+		const bool bUseArray = false,
+		const int64 Seed = 0,
+		const int32 Iteration = -1,
+		const bool bParallel = false
+	);
+
+	// Disk output of the cached class schema, only written when explicitly asked for
+	UFUNCTION(BlueprintCallable, Category = "Game Testing")
+	static bool ExportClassSchema(
+		const UClass* const Class,
+		const FString& FilePath,
+		const bool bUserDefinedOnly = false
+	);
+
+	// Prints the properties added to the class of TargetObject since the last snapshot and records its layout
+	UFUNCTION(BlueprintCallable, Category = "Game Testing")
+	static void LogNewProperties(const UObject* const TargetObject);
+
+	// Writes the recorded layouts to Data/propertySnapshot.bin; also done on module shutdown
+	UFUNCTION(BlueprintCallable, Category = "Game Testing")
+	static bool SavePropertySnapshot();
+
+	// Puts back the value every property had before it was first fuzzed; returns how many were restored
+	UFUNCTION(BlueprintCallable, Category = "Game Testing")
+	static int32 RestoreFuzzedProperties();
+
+	// Keeps the state of every actor targeted by Plan, components included, in memory
+	UFUNCTION(BlueprintCallable, Category = "Game Testing", meta = (WorldContext = "WorldContextObject"))
+	static bool SaveWorldCheckpoint(const UObject* const WorldContextObject, const FBltFuzzPlanHandle& Plan);
+
+	// Brings the world back to the last checkpoint without reloading the level; returns the actors restored
+	UFUNCTION(BlueprintCallable, Category = "Game Testing", meta = (WorldContext = "WorldContextObject"))
+	static int32 ResetWorldCheckpoint(const UObject* const WorldContextObject);
+
+	// Marks the current iteration as failing, for the guided mode and the minimizer
+	UFUNCTION(BlueprintCallable, Category = "Game Testing", meta = (WorldContext = "WorldContextObject"))
+	static void ReportFuzzFailure(const UObject* const WorldContextObject, const FString& Reason);
+
+	// Every actor a pass of FuzzPlan reaches, once each even when it matches several entries or is listed twice
+	static TArray<AActor*> GatherFuzzTargets(
+		const UObject* const WorldContextObject,
+		const FBltFuzzPlan& FuzzPlan,
+		const TArray<AActor*>& AffectedActors = TArray<AActor*>(),
 		const bool bUseArray = false
 	);
 
+	// Properties listed in Data/baseProperties.txt are never fuzzed, by the plans or by game side fuzzers
+	static bool IsBaseProperty(const FName PropertyName);
+
+	// Mutates every value a property plan reaches, each with the stream pinned by (pass, actor, value)
+	static void RandomiseProperty(
+		AActor* const Actor,
+		const FBltFuzzPropertyPlan& PropertyPlan,
+		const FBltFuzzPass& Pass,
+		const uint32 ActorId
+	);
+
+private:
 	static void RandomiseProperties(
-		const TSharedPtr<FJsonObject>* ActorClassObject,
-		const TArray<AActor*>& Actors
+		AActor* const Actor,
+		const FBltFuzzClassPlan& ClassPlan,
+		const FBltFuzzPass& Pass
 	);
 	
 	static void RandomiseNumericProperty(
-		const FProperty* const Property,
-		const FJsonValue* const PropertyValue,
-		AActor* const Actor
+		const FBltFuzzPropertyPlan& PropertyPlan,
+		UObject* const Owner,
+		void* const ValuePtr,
+		const uint32 ActorId,
+		const uint32 ValueId,
+		FBltRandomStream& Stream,
+		const FBltFuzzValue* const GuidedValue
 	);
 	
 	static void RandomiseStringProperty(
-		const FProperty* const Property,
-		const FJsonValue* const PropertyValue,
-		AActor* const Actor
-	);
-
-	static TMap<FString, FProperty*> LogCurrentProperties(
-		UObject* targetObject,
-		 FString& currentProperties
+		const FBltFuzzPropertyPlan& PropertyPlan,
+		UObject* const Owner,
+		void* const ValuePtr,
+		const uint32 ActorId,
+		const uint32 ValueId,
+		FBltRandomStream& Stream,
+		const FBltFuzzValue* const GuidedValue
 	);
 
-	static void LogNewProperties(
-		UObject* targetObject,
-		 FString& oldProperties,
-		 FString& currentProperties
+	static void WriteStringProperty(
+		const FBltFuzzPropertyPlan& PropertyPlan,
+		const uint32 ActorId,
+		const uint32 ValueId,
+		void* const ValuePtr,
+		const FString& RandomString
 	);
 
-	static void LogDefinedProperties(
-		UObject* targetObject,
-		 FString& baseProperties,
-		TMap<FString, FProperty*>& property_map
+	static void WriteNameProperty(
+		const uint32 ActorId,
+		const uint32 ValueId,
+		void* const ValuePtr,
+		const FName Name
 	);
-
-
 };
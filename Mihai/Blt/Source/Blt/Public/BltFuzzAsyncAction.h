@@ -0,0 +1,51 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "Kismet/BlueprintAsyncActionBase.h"
+#include "BltFuzzPlan.h"
+#include "BltFuzzAsyncAction.generated.h"
+
+class FBltFuzzTask;
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FBltFuzzAsyncProgress, int32, ProcessedActors, int32, TotalActors);
+
+
+// Latent node around FBltFuzzTask
+UCLASS()
+class BLT_API UBltFuzzAsyncAction final : public UBlueprintAsyncActionBase
+{
+	GENERATED_BODY()
+
+public:
+	UFUNCTION(BlueprintCallable, Category = "Game Testing", meta = (
+		BlueprintInternalUseOnly = "true",
+		DisplayName = "ApplyFuzzPlanAsync",
+		WorldContext = "WorldContextObject",
+		AutoCreateRefTerm = "AffectedActors"
+	))
+	static UBltFuzzAsyncAction* ApplyFuzzPlanAsync(
+		const UObject* const WorldContextObject,
+		const FBltFuzzPlanHandle& Plan,
+		const TArray<AActor*>& AffectedActors,
+		const bool bUseArray = false,
+		const int64 Seed = 0,
+		const int32 Iteration = -1,
+		const float BudgetMilliseconds = 2.f
+	);
+
+	virtual void Activate() override;
+
+	UPROPERTY(BlueprintAssignable)
+	FBltFuzzAsyncProgress OnProgress;
+
+	UPROPERTY(BlueprintAssignable)
+	FBltFuzzAsyncProgress OnCompleted;
+
+private:
+	void HandleProgress(const int32 ProcessedActors, const int32 TotalActors);
+	void HandleCompleted(const int32 ProcessedActors, const int32 TotalActors);
+
+	TSharedPtr<FBltFuzzTask> Task;
+	float BudgetMilliseconds = 0.f;
+};
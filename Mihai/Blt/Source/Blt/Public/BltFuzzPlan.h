@@ -0,0 +1,308 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "BltFuzzPlan.generated.h"
+
+class FBltFuzzGuide;
+class FBltRegexGenerator;
+class FBltValueDistribution;
+class FBltNamePool;
+
+
+USTRUCT(BlueprintType)
+struct BLT_API FBltFuzzPlanHandle
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	int32 Id = INDEX_NONE;
+
+	bool IsValid() const { return Id != INDEX_NONE; }
+};
+
+enum class EBltFuzzValueType : uint8
+{
+	None,
+	Int8,
+	Int16,
+	Int32,
+	Int64,
+	UInt8,
+	UInt16,
+	UInt32,
+	UInt64,
+	Float,
+	Double,
+	Bool,
+	Enum,
+	String,
+	Name,
+	Text
+};
+
+enum class EBltFuzzRangeSource : uint8
+{
+	// Property is user defined but has no JSON entry, or its entry only sets the strategy
+	Default,
+	Interval,
+	Regex,
+
+	// Object entry with several buckets, edge values or type boundaries
+	Distribution
+};
+
+enum class EBltFuzzStrategy : uint8
+{
+	// Entry takes the strategy of the * entry of its class, Sample when that names none either
+	Default,
+
+	// A fresh value is drawn from the entry every pass
+	Sample,
+
+	// The value already in the property is edited: deltas, bit and sign flips and scaling for
+	// numbers, inserts, deletions, truncations and splices for strings
+	Mutate
+};
+
+// Explicit value of a distribution entry, a number, a name such as NaN, Inf, Denormal, Max or Lowest,
+// or the raw bits of the value written as a "0x" string, exact where a JSON number is not
+struct FBltFuzzEdgeSpec
+{
+	double Value = 0.0;
+	FName Name;
+	uint64 Bits = 0u;
+	bool bRawBits = false;
+};
+
+// [min, max, weight] entry of a distribution, or its Range with a weight of one
+struct FBltFuzzBucketSpec
+{
+	double Min = 0.0;
+	double Max = 0.0;
+	double Weight = 1.0;
+};
+
+// Decoded object entry of a numeric property, compiled against the property type by FBltValueDistribution
+struct FBltFuzzDistributionSpec
+{
+	TArray<FBltFuzzBucketSpec> Buckets;
+
+	// Buckets sampled evenly across orders of magnitude instead of evenly across values
+	bool bLogScale = false;
+
+	TArray<FBltFuzzEdgeSpec> Edges;
+
+	// Share of the samples taken by Edges, negative for the default
+	double EdgeRate = -1.0;
+
+	// Share of the samples taken by the limits of the property type: 0, +-1, lowest and max, NaN and so on
+	double BoundaryRate = 0.0;
+};
+
+// Decoded JSON entry of a single property, independent of any UClass. The entry named * holds the
+// defaults of its class: its range stands in for every user defined integer and floating point
+// property without an entry, its strategy for every entry that names none. Its FuzzUnlisted field
+// set to false leaves the properties without an entry alone
+struct FBltFuzzPropertySpec
+{
+	FName PropertyName;
+	EBltFuzzRangeSource Source = EBltFuzzRangeSource::Default;
+	EBltFuzzStrategy Strategy = EBltFuzzStrategy::Default;
+
+	// Distinct FNames a name property may be fuzzed with, 0 for FBltNamePool::DefaultSize
+	int32 NamePoolSize = 0;
+	double Min = 0.0;
+	double Max = 0.0;
+	FString Regex;
+	FBltFuzzDistributionSpec Distribution;
+	bool bFuzzUnlisted = true;
+};
+
+enum class EBltFuzzAccessKind : uint8
+{
+	// Instanced subobject or component the owner points at
+	Object,
+	Array,
+	Map
+};
+
+// One indirection on the way from the actor to a nested value, at Offset into whatever the previous step reached
+struct FBltFuzzAccessStep
+{
+	EBltFuzzAccessKind Kind = EBltFuzzAccessKind::Object;
+	int32 Offset = 0;
+
+	// FObjectProperty, FArrayProperty or FMapProperty matching Kind
+	const FProperty* Property = nullptr;
+};
+
+// Everything needed to mutate one property of one concrete UClass without touching reflection by name
+struct FBltFuzzPropertyPlan
+{
+	const FProperty* Property = nullptr;
+	int32 Offset = 0;
+	uint32 PropertyId = 0u;
+
+	// Dotted spec path such as CharacterMovement.MaxWalkSpeed; the plain name for properties of the actor
+	FName PathName;
+
+	// Pointers and containers between the actor and the value, Offset is relative to what the last step reaches.
+	// Members of structs need no step, their offsets are folded into Offset
+	TArray<FBltFuzzAccessStep> Path;
+
+	// Property of the actor or subobject that holds the value, what the restore journal keeps
+	const FProperty* RootProperty = nullptr;
+	EBltFuzzValueType Type = EBltFuzzValueType::None;
+	EBltFuzzRangeSource Source = EBltFuzzRangeSource::Default;
+	EBltFuzzStrategy Strategy = EBltFuzzStrategy::Sample;
+
+	// Interval, default range, or the span of the buckets of a distribution; mutations are clamped to it
+	double Min = 0.0;
+	double Max = 0.0;
+
+	// Distribution with edge values or type boundaries, whose mutations may leave Min and Max like its samples do
+	bool bUnbounded = false;
+	FString Regex;
+
+	// Interval clamped to the limits of the integer type, sign extended for signed types
+	uint64 IntegerMin = 0u;
+	uint64 IntegerMax = 0u;
+
+	// Bitfield layout of FBoolProperty, relative to Offset
+	uint8 ByteOffset = 0u;
+	uint8 FieldMask = 0u;
+	uint8 ByteMask = 0u;
+
+	// Valid entries of FEnumProperty and TEnumAsByte, without the _MAX entry
+	TArray<int64> EnumValues;
+	uint8 EnumSize = 0u;
+
+	// Null when the regex could only be handled by the Python bridge
+	TSharedPtr<const FBltRegexGenerator, ESPMode::ThreadSafe> Generator;
+
+	// Set for distribution entries, sampled instead of the plain interval
+	TSharedPtr<const FBltValueDistribution, ESPMode::ThreadSafe> Distribution;
+
+	// Set for FName properties, every name written to them comes out of it
+	TSharedPtr<FBltNamePool, ESPMode::ThreadSafe> NamePool;
+};
+
+// Inputs of the random streams of one pass; together with actor and property ids they pin down every value
+struct FBltFuzzPass
+{
+	int64 Seed = 0;
+	int32 Iteration = 0;
+
+	// Values to replay instead of sampling, set by the guided mode and by replays
+	const FBltFuzzGuide* Guide = nullptr;
+};
+
+// One value as written by a pass: the raw bits of numeric, bool and enum properties, the text of string ones
+struct FBltFuzzValue
+{
+	EBltFuzzValueType Type = EBltFuzzValueType::None;
+	uint64 Bits = 0u;
+	FString String;
+};
+
+struct FBltFuzzClassPlan
+{
+	const UClass* Class = nullptr;
+	uint32 SchemaGeneration = 0u;
+	TArray<FBltFuzzPropertyPlan> Properties;
+};
+
+// Top level JSON entry; the resolved plans are built lazily for every concrete subclass met at runtime
+struct FBltFuzzClassSpec
+{
+	FString ClassName;
+	TWeakObjectPtr<UClass> Class;
+	TMap<FName, FBltFuzzPropertySpec> Properties;
+
+	// Hash of the JSON text of the entry; entries that keep it across a reload keep their resolved plans
+	uint32 SourceHash = 0u;
+};
+
+
+class BLT_API FBltFuzzPlan
+{
+public:
+	// Resolved plans of Previous are carried over for every class entry whose JSON text did not change
+	FBltFuzzPlan(
+		const FString& InSourcePath,
+		TArray<FBltFuzzClassSpec>&& InClasses,
+		const FBltFuzzPlan* const Previous = nullptr
+	);
+
+	// Picks the source of an object entry once its fields are decoded: a lone linear Range is a plain
+	// interval, an entry with nothing to sample only sets the strategy
+	static void ClassifyObjectEntry(FBltFuzzPropertySpec& PropertySpec);
+
+	// String edge of an object entry: raw bits when it is a "0x" hex number, a named value otherwise
+	static void DecodeEdgeString(const FString& Text, FBltFuzzEdgeSpec& OutEdge);
+
+	const FString& GetSourcePath() const { return SourcePath; }
+	const TArray<FBltFuzzClassSpec>& GetClasses() const { return Classes; }
+
+	// Resolves the property plans of ActorClass against the JSON entry at ClassIndex, once per class schema
+	const FBltFuzzClassPlan& FindOrResolveClassPlan(const int32 ClassIndex, const UClass* const ActorClass) const;
+
+	// Plan of every JSON entry ActorClass matches, such as Character and MyCharacter, merged into one so
+	// each actor is fuzzed once per pass; null when it matches none
+	const FBltFuzzClassPlan* FindOrResolveActorPlan(const UClass* const ActorClass) const;
+
+private:
+	FBltFuzzClassPlan ResolveClassPlan(const FBltFuzzClassSpec& ClassSpec, const UClass* const ActorClass) const;
+
+	// Later entries win a property named by several, except that a default range never replaces a JSON one
+	static FBltFuzzClassPlan MergeClassPlans(const TArray<const FBltFuzzClassPlan*, TInlineAllocator<4>>& ClassPlans);
+
+	// Adds the plans of Property and, for structs, containers and subobjects, of everything below it
+	void ResolveProperty(
+		const FBltFuzzClassSpec& ClassSpec,
+		const TSet<FString>& PathPrefixes,
+		const FProperty* const Property,
+		const FString& PathName,
+		const FBltFuzzPropertyPlan& Node,
+		const bool bUserDefined,
+		const int32 Depth,
+		TArray<FBltFuzzPropertyPlan>& OutProperties
+	) const;
+
+	FString SourcePath;
+	TArray<FBltFuzzClassSpec> Classes;
+
+	mutable FRWLock ResolvedLock;
+	mutable TArray<TMap<const UClass*, TSharedRef<FBltFuzzClassPlan, ESPMode::ThreadSafe>>> ResolvedPlans;
+
+	// Only holds the classes matching more than one entry
+	mutable TMap<const UClass*, TSharedRef<FBltFuzzClassPlan, ESPMode::ThreadSafe>> MergedPlans;
+};
+
+using FBltFuzzPlanPtr = TSharedPtr<const FBltFuzzPlan, ESPMode::ThreadSafe>;
+
+
+// Owns every loaded plan; handles stay stable for the same spec file across reloads. Plans are
+// immutable once registered, a reload swaps in a new one so passes holding the old one finish on it
+class BLT_API FBltFuzzPlanRegistry
+{
+public:
+	static FBltFuzzPlanRegistry& Get();
+
+	FBltFuzzPlanHandle Register(const FString& SourcePath, const FBltFuzzPlanPtr& Plan);
+	void Unregister(const FBltFuzzPlanHandle& Handle);
+
+	FBltFuzzPlanPtr Find(const FBltFuzzPlanHandle& Handle) const;
+	FBltFuzzPlanHandle FindByPath(const FString& SourcePath) const;
+
+	// Iteration counter used by passes that do not pin an explicit iteration
+	int32 AdvanceIteration(const FBltFuzzPlanHandle& Handle);
+
+private:
+	mutable FCriticalSection Lock;
+	TMap<FString, int32> HandlesByPath;
+	TMap<int32, FBltFuzzPlanPtr> Plans;
+	TMap<int32, int32> Iterations;
+	int32 NextId = 0;
+};
@@ -0,0 +1,66 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "Containers/Ticker.h"
+#include "BltFuzzPlan.h"
+
+DECLARE_DELEGATE_TwoParams(FBltFuzzTaskProgress, int32 /* ProcessedActors */, int32 /* TotalActors */);
+
+
+// Fuzz pass spread over several frames. Every core tick mutates properties until the frame budget
+// runs out and then parks an (actor, property) cursor; since every value comes from its own
+// counter based stream, resuming later produces exactly what one synchronous pass would have.
+class BLT_API FBltFuzzTask final : public TSharedFromThis<FBltFuzzTask>
+{
+public:
+	FBltFuzzTask(
+		const UObject* const WorldContextObject,
+		const FBltFuzzPlanPtr& InPlan,
+		const FBltFuzzPass& InPass,
+		const TArray<AActor*>& AffectedActors = TArray<AActor*>(),
+		const bool bUseArray = false
+	);
+
+	~FBltFuzzTask();
+
+	// Registers with the core ticker; the task keeps itself alive until it completes or gets cancelled
+	void Start(const float InBudgetMilliseconds);
+	void Cancel();
+
+	// Runs until the budget is spent, returns true once every actor has been mutated
+	bool Step(const double BudgetSeconds);
+
+	bool IsDone() const { return ActorIndex >= Targets.Num(); }
+	int32 GetProcessedActors() const { return ProcessedActors; }
+	int32 GetTotalActors() const { return TotalActors; }
+
+	FBltFuzzTaskProgress OnProgress;
+	FBltFuzzTaskProgress OnCompleted;
+
+private:
+	bool Tick(const float DeltaTime);
+	void Finish();
+
+	FBltFuzzPlanPtr Plan;
+	FBltFuzzPass Pass;
+
+	// Actors gathered once at creation, each once like UBltBPLibrary::ApplyFuzzPass does
+	TArray<TWeakObjectPtr<AActor>> Targets;
+
+	int32 ActorIndex = 0;
+	int32 PropertyIndex = 0;
+
+	// Schema generation of the plan PropertyIndex points into, and the properties of the current actor
+	// already mutated, so a plan resolved again between frames resumes at the right properties
+	uint32 PlanGeneration = 0u;
+	TSet<FName> MutatedPaths;
+	bool bPlanReplaced = false;
+
+	int32 ProcessedActors = 0;
+	int32 TotalActors = 0;
+
+	double BudgetSeconds = 0.0;
+	FDelegateHandle TickerHandle;
+	TSharedPtr<FBltFuzzTask> SelfReference;
+};
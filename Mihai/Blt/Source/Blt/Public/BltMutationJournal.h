@@ -0,0 +1,141 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include <atomic>
+#include "BltFuzzPlan.h"
+
+class FThread;
+
+
+enum class EBltMutationValue : uint8
+{
+	// Raw bits of numeric, bool and enum values
+	Bits,
+
+	// CityHash64 of the string contents for FString, FName and FText
+	StringHash
+};
+
+// One mutation as written to the journal files, fixed size so a file reads back as a plain array
+struct FBltMutationRecord
+{
+	uint64 Frame = 0u;
+	uint32 ActorId = 0u;
+	uint32 PropertyId = 0u;
+	uint64 OldValue = 0u;
+	uint64 NewValue = 0u;
+	EBltFuzzValueType Type = EBltFuzzValueType::None;
+	EBltMutationValue ValueKind = EBltMutationValue::Bits;
+	uint16 Reserved0 = 0u;
+	uint32 Reserved1 = 0u;
+};
+
+static_assert(sizeof(FBltMutationRecord) == 40, "Journal files rely on a fixed record size");
+
+
+// Sees every mutation with its full value, strings included, from whichever thread records it
+class IBltMutationListener
+{
+public:
+	virtual ~IBltMutationListener() = default;
+
+	// NewString is null for numeric, bool and enum mutations
+	virtual void OnMutation(const FBltMutationRecord& Record, const FString* const NewString) = 0;
+};
+
+
+// Mutations are pushed from any thread into a bounded lock-free ring and drained by a background
+// writer into rotating files under Saved/Logs/Blt. A full ring drops records instead of stalling
+// the fuzzer; the drop count is part of the on-screen summary.
+class BLT_API FBltMutationJournal
+{
+public:
+	// The process wide journal, or the one made active by an FScopedActive
+	static FBltMutationJournal& Get();
+
+	// Routes Get() to another journal for the duration of a scope, so each world of a process can keep its own.
+	// Set on the game thread; worker tasks launched inside the scope see it too
+	class FScopedActive
+	{
+	public:
+		explicit FScopedActive(FBltMutationJournal& Journal)
+			: Previous(Active)
+		{
+			Active = &Journal;
+		}
+
+		~FScopedActive()
+		{
+			Active = Previous;
+		}
+
+	private:
+		FBltMutationJournal* Previous;
+	};
+
+	~FBltMutationJournal();
+
+	void Start(const FString& InDirectory);
+	void Stop();
+
+	void Record(
+		const uint32 ActorId,
+		const uint32 PropertyId,
+		const EBltFuzzValueType Type,
+		const uint64 OldValue,
+		const uint64 NewValue
+	);
+
+	void RecordString(
+		const uint32 ActorId,
+		const uint32 PropertyId,
+		const EBltFuzzValueType Type,
+		const FString& OldValue,
+		const FString& NewValue
+	);
+
+	// Not owned; set and cleared on the game thread while no pass is running
+	void SetListener(IBltMutationListener* const InListener) { Listener = InListener; }
+
+	// One keyed on-screen line with the mutations since the previous summary, replaced in place
+	void ShowSummary();
+
+	uint64 GetRecordedCount() const { return RecordedCount.load(std::memory_order_relaxed); }
+	uint64 GetDroppedCount() const { return DroppedCount.load(std::memory_order_relaxed); }
+
+private:
+	static constexpr uint32 Capacity = 1u << 16u;
+	static constexpr int64 MaxFileSize = 64 * 1024 * 1024;
+	static constexpr int32 MaxFiles = 4;
+
+	struct FSlot
+	{
+		std::atomic<uint64> Sequence{0u};
+		FBltMutationRecord Record;
+	};
+
+	bool Enqueue(const FBltMutationRecord& Record);
+	bool Dequeue(FBltMutationRecord& OutRecord);
+
+	void WriterLoop();
+	void WriteRecords(const TArray<FBltMutationRecord>& Records);
+	void OpenNextFile();
+
+	TUniquePtr<FSlot[]> Slots;
+	alignas(PLATFORM_CACHE_LINE_SIZE) std::atomic<uint64> EnqueuePosition{0u};
+	alignas(PLATFORM_CACHE_LINE_SIZE) uint64 DequeuePosition = 0u;
+
+	std::atomic<bool> bRunning{false};
+	std::atomic<uint64> RecordedCount{0u};
+	std::atomic<uint64> DroppedCount{0u};
+	uint64 SummarizedCount = 0u;
+
+	static FBltMutationJournal* Active;
+	IBltMutationListener* Listener = nullptr;
+
+	TUniquePtr<FThread> Writer;
+	FString Directory;
+	TUniquePtr<FArchive> File;
+	int32 FileIndex = INDEX_NONE;
+};
@@ -0,0 +1,95 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+
+// Counter based random stream in the SplitMix64 family. A stream is fully defined by
+// (campaign seed, iteration, actor id, property id), so any single mutation of a run can be
+// recomputed in O(1) without replaying what came before it. Streams are cheap value types
+// and never share state, which also makes them safe to use from worker threads.
+class FBltRandomStream
+{
+public:
+	FBltRandomStream(const uint64 Seed, const uint64 Iteration, const uint32 ActorId, const uint32 PropertyId)
+		: Key(Mix(MakePassKey(Seed, Iteration) ^ (static_cast<uint64>(ActorId) << 32u | PropertyId)))
+	{
+	}
+
+	// Shared by every stream of one pass, before actor and property are mixed in
+	static uint64 MakePassKey(const uint64 Seed, const uint64 Iteration)
+	{
+		return Mix(Mix(Seed) ^ Iteration);
+	}
+
+	// First NextUInt64() of the stream of each actor for one property, without building the streams.
+	// Plain arithmetic over contiguous arrays, so the loop vectorizes where 64 bit multiplies do
+	static void DrawFirst(const uint64 PassKey, const uint32 PropertyId, const uint32* const ActorIds, uint64* const OutRandom, const int32 Count)
+	{
+		for (int32 Index = 0; Index < Count; ++Index)
+		{
+			OutRandom[Index] = Mix(Mix(PassKey ^ (static_cast<uint64>(ActorIds[Index]) << 32u | PropertyId)) + Gamma);
+		}
+	}
+
+	uint64 NextUInt64()
+	{
+		return Mix(Key + ++Counter * Gamma);
+	}
+
+	uint32 GetUnsignedInt()
+	{
+		return static_cast<uint32>(NextUInt64() >> 32u);
+	}
+
+	// 53 random bits mapped to [0, 1)
+	double GetFraction()
+	{
+		return static_cast<double>(NextUInt64() >> 11u) * (1.0 / 9007199254740992.0);
+	}
+
+	// [0, Count)
+	int32 RandHelper(const int32 Count)
+	{
+		return Count > 0 ? static_cast<int32>(NextUInt64() % static_cast<uint64>(Count)) : 0;
+	}
+
+	// [Min, Max]
+	int32 RandRange(const int32 Min, const int32 Max)
+	{
+		return Min + RandHelper(Max - Min + 1);
+	}
+
+	// [Low, High]; signed bounds are sign extended so the arithmetic wraps into place
+	uint64 RangeUInt64(const uint64 Low, const uint64 High)
+	{
+		const uint64 Span = High - Low;
+		const uint64 Random = NextUInt64();
+		return Span == MAX_uint64 ? Random : Low + Random % (Span + 1u);
+	}
+
+	// Stable across processes, unlike FName comparison indices or UObject unique ids
+	static uint32 HashName(const FName& Name)
+	{
+		FNameBuilder NameBuilder;
+		Name.AppendString(NameBuilder);
+		return FCrc::StrCrc32(NameBuilder.ToString());
+	}
+
+	static uint32 HashObject(const UObject* const Object)
+	{
+		return HashName(Object->GetFName());
+	}
+
+private:
+	static constexpr uint64 Gamma = 0x9E3779B97F4A7C15ull;
+
+	static uint64 Mix(uint64 Value)
+	{
+		Value = (Value ^ (Value >> 30u)) * 0xBF58476D1CE4E5B9ull;
+		Value = (Value ^ (Value >> 27u)) * 0x94D049BB133111EBull;
+		return Value ^ (Value >> 31u);
+	}
+
+	uint64 Key;
+	uint64 Counter = 0u;
+};
@@ -0,0 +1,62 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "UObject/ObjectKey.h"
+
+
+// Original values of every property touched by fuzzing, captured the first time a property is
+// written after the last restore. Values live in a bump allocated arena: plain old data is copied
+// byte for byte, everything else (FString, FName, FText, ...) goes through its FProperty so copies
+// keep their ownership semantics. Game thread only.
+class BLT_API FBltRestoreJournal
+{
+public:
+	static FBltRestoreJournal& Get();
+
+	~FBltRestoreJournal();
+
+	// Call right before Property of Object is written; later calls for the same value are free
+	void Capture(UObject* const Object, const FProperty* const Property);
+
+	// Rolls every captured value back, newest first, and empties the journal; returns the values restored
+	int32 Restore();
+
+	// Forgets the captured values without restoring them, only those of World's objects when given one
+	void Reset(const UWorld* const World = nullptr);
+
+	int32 Num() const { return Entries.Num(); }
+
+private:
+	static constexpr int32 BlockSize = 64 * 1024;
+
+	struct FEntry
+	{
+		TWeakObjectPtr<UObject> Object;
+		const FProperty* Property = nullptr;
+		uint8* Storage = nullptr;
+
+		// Values larger than an arena block get storage of their own, freed with the entry
+		TUniquePtr<uint8[]> LargeStorage;
+		int32 Offset = 0;
+		int32 Size = 0;
+
+		// Bitfield bools only own the bits of FieldMask inside their byte
+		uint8 FieldMask = 0u;
+		bool bPlainOldData = false;
+	};
+
+	uint8* Allocate(const int32 Size, const int32 Alignment);
+	void DestroyEntries(const bool bPropertiesValid);
+
+	TArray<FEntry> Entries;
+	// Keyed on the property rather than its offset, since bitfield bools share the offset of their byte
+	TSet<TPair<FObjectKey, const FProperty*>> Captured;
+
+	TArray<TUniquePtr<uint8[]>> Blocks;
+	int32 CurrentBlock = 0;
+	int32 BlockOffset = 0;
+
+	// Entries made before a class reload point at freed FProperty objects and are dropped
+	uint32 SchemaGeneration = 0u;
+};
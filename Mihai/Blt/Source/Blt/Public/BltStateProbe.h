@@ -0,0 +1,25 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "UObject/Interface.h"
+#include "BltStateProbe.generated.h"
+
+
+UINTERFACE(BlueprintType)
+class BLT_API UBltStateProbe : public UInterface
+{
+	GENERATED_BODY()
+};
+
+// Implemented by actors that can summarise their gameplay state for the guided fuzzing mode. Each
+// distinct value an actor class reports counts as a new state, so quantise whatever goes in: a
+// health bucket, an AI state enum, a bit per objective reached.
+class BLT_API IBltStateProbe
+{
+	GENERATED_BODY()
+
+public:
+	UFUNCTION(BlueprintNativeEvent, BlueprintCallable, Category = "Game Testing")
+	int64 GetProbeState() const;
+};
@@ -2,6 +2,9 @@
 
 
 #include "Fuzzer.h"
+#include "BltBPLibrary.h"
+#include "BltMutationJournal.h"
+#include "BltRestoreJournal.h"
 
 
 Fuzzer::Fuzzer()
@@ -33,17 +36,13 @@ std::map<FString, FProperty*> Fuzzer::getProperties(UObject* targetObject)
 
 
 
-void Fuzzer::myFuzzer(UObject* targetObject, std::map<FString, FProperty*> property_map) {
-	
-
-
-	GEngine->AddOnScreenDebugMessage(-1, 4, FColor::Green, "Pressed R");
-
+void Fuzzer::myFuzzer(UObject* targetObject, std::map<FString, FProperty*> property_map, int64 seed, int32 iteration) {
 	std::fstream fs;
 	fs.open("C:\\Users\\Q\\Desktop\\fieldValues.json", std::fstream::in | std::fstream::out | std::fstream::app);
 
 	std::string s;
 	std::map<FString, FProperty*> global_property_map = getProperties(targetObject);
+	const uint32 actor_id = FBltRandomStream::HashObject(targetObject);
 
 	while (fs >> s) {
 
@@ -60,41 +59,42 @@ void Fuzzer::myFuzzer(UObject* targetObject, std::map<FString, FProperty*> prope
 				FName property_name = UTF8_TO_TCHAR(var_name.c_str());
 				FInt64Property* NumProperty = FindField<FInt64Property>(targetObject->GetClass(), property_name);
 				int64 property_value = -1;
-				std::random_device rd;
-				std::mt19937 gen(rd());
-				std::uniform_int_distribution<> distr(first, second);
+				FBltRandomStream stream(seed, iteration, actor_id, FBltRandomStream::HashName(property_name));
 
 				if (global_property_map.find(property_name.ToString()) != global_property_map.end()) {
-					NumProperty->SetPropertyValue_InContainer(targetObject, distr(gen));
+					const int64 old_value = NumProperty->GetPropertyValue_InContainer(targetObject);
+					FBltRestoreJournal::Get().Capture(targetObject, NumProperty);
+					NumProperty->SetPropertyValue_InContainer(targetObject, stream.RandRange(first, second));
 					property_value = NumProperty->GetPropertyValue_InContainer(targetObject);
-					GEngine->AddOnScreenDebugMessage(-1, 4, FColor::Green, property_name.ToString() + FString::Printf(TEXT(": %d"), property_value));
+					FBltMutationJournal::Get().Record(actor_id, FBltRandomStream::HashName(property_name), EBltFuzzValueType::Int64, static_cast<uint64>(old_value), static_cast<uint64>(property_value));
 					FString string_property_name = property_name.ToString();
 					property_map.erase(string_property_name);
 				}
 			}
 		}
 	}
-	std::random_device rd;
-	std::mt19937 gen(rd());
-	std::uniform_int_distribution<> distr(1, 1000000);
 	for (std::map<FString, FProperty*>::iterator it = property_map.begin(); it != property_map.end(); ++it) {
+		// FuzzSeed and FuzzIteration are listed there, so the values that reproduce this pass survive it
+		if (UBltBPLibrary::IsBaseProperty(FName(it->first)))
+			continue;
+
 		FString int_type = "int64";
 		if (it->second->GetCPPType() == int_type)
 		{
 			FName property_name(it->first);
 			FInt64Property* NumProperty = FindField<FInt64Property>(targetObject->GetClass(), property_name);
-			NumProperty->SetPropertyValue_InContainer(targetObject, distr(gen));
+			FBltRandomStream stream(seed, iteration, actor_id, FBltRandomStream::HashName(property_name));
+			const int64 old_value = NumProperty->GetPropertyValue_InContainer(targetObject);
+			FBltRestoreJournal::Get().Capture(targetObject, NumProperty);
+			NumProperty->SetPropertyValue_InContainer(targetObject, stream.RandRange(1, 1000000));
 			int64 property_value = NumProperty->GetPropertyValue_InContainer(targetObject);
-			GEngine->AddOnScreenDebugMessage(-1, 4, FColor::Green, property_name.ToString() + FString::Printf(TEXT(" (not in JSON): %d"), property_value));
+			FBltMutationJournal::Get().Record(actor_id, FBltRandomStream::HashName(property_name), EBltFuzzValueType::Int64, static_cast<uint64>(old_value), static_cast<uint64>(property_value));
 					
 		}
-		
-		//GEngine->AddOnScreenDebugMessage(-1, 4, FColor::Green, it->first);
-
 	}
 
 
-	GEngine->AddOnScreenDebugMessage(-1, 500, FColor::Green, " ");
+	FBltMutationJournal::Get().ShowSummary();
 
 	fs.close();
 
@@ -8,8 +8,8 @@
 #include <Runtime/CoreUObject/Public/UObject/ObjectMacros.h>
 #include "Math/UnrealMathUtility.h"
 #include "UObject/Class.h"
+#include "BltRandom.h"
 #include <string>
-#include <random>
 #include <fstream>
 #include <map>
 
@@ -23,7 +23,7 @@ public:
 	~Fuzzer();
 
 	UFUNCTION(BlueprintCallable)
-	void myFuzzer(UObject* targetObject, std::map<FString, FProperty*> property_map);
+	void myFuzzer(UObject* targetObject, std::map<FString, FProperty*> property_map, int64 seed = 0, int32 iteration = 0);
 
 private:
 	std::map<FString, FProperty*> getProperties(UObject* targetObject);
@@ -5,8 +5,11 @@
 #include "Math/UnrealMathUtility.h"
 #include "UObject/Class.h"
 #include "Fuzzer.h"
+#include "BltRandom.h"
+#include "BltBPLibrary.h"
+#include "BltMutationJournal.h"
+#include "BltRestoreJournal.h"
 #include <string>
-#include <random>
 #include <fstream>
 #include <map>
 
@@ -21,6 +24,8 @@ AMyCharacter::AMyCharacter()
 	test_WalkSpeed = 200;
 	test_RunSpeed = 1000;
 	test_JumpHeight = 1000;
+	FuzzSeed = 0;
+	FuzzIteration = 0;
 }
 
 // Called when the game starts or when spawned
@@ -69,47 +74,16 @@ void AMyCharacter::MyPropertyLogger() {
 }
 
 void AMyCharacter::LogNewProperties() {
-	std::fstream fs;
-	std::map<FString, FProperty*> comparison_map = property_map;
-	fs.open("C:\\Users\\Q\\Desktop\\oldProperties.txt", std::fstream::in | std::fstream::out | std::fstream::app);
-	std::string line;
-	while (std::getline(fs, line))
-	{
-		FString p_name = UTF8_TO_TCHAR(line.c_str());
-		comparison_map.erase(p_name);
-	}
-	fs.close();
-	if (comparison_map.empty())
-		GEngine->AddOnScreenDebugMessage(-1, 500, FColor::Red, "No new properties");
-	else {
-		GEngine->AddOnScreenDebugMessage(-1, 500, FColor::Red, "New properties:");
-
-		for (it = comparison_map.begin(); it != comparison_map.end(); ++it) {
-			GEngine->AddOnScreenDebugMessage(-1, 4, FColor::Red, it->first);
-		}
-	}
-	
-	std::fstream fs1;
-	fs.open("C:\\Users\\Q\\Desktop\\oldProperties.txt", std::fstream::in | std::fstream::out | std::fstream::trunc);
-	fs1.open("C:\\Users\\Q\\Desktop\\currentProperties.txt", std::fstream::in | std::fstream::out | std::fstream::app);
-	while (std::getline(fs1, line))
-	{
-		fs << line << '\n';
-	}
-	fs.close();
-	fs1.close();
-
-
+	UBltBPLibrary::LogNewProperties(this);
 }
 
 
 void AMyCharacter::MyFuzzer() {
-	GEngine->AddOnScreenDebugMessage(-1, 4, FColor::Green, "Pressed R");
-
 	std::fstream fs;
 	fs.open("C:\\Users\\Q\\Desktop\\fieldValues.json", std::fstream::in | std::fstream::out | std::fstream::app);
 
 	std::string s;
+	const uint32 actor_id = FBltRandomStream::HashObject(this);
 
 	while (fs >> s) {
 		int pos = s.find_first_of(':');
@@ -125,20 +99,21 @@ void AMyCharacter::MyFuzzer() {
 				FName property_name = UTF8_TO_TCHAR(var_name.c_str());
 				FInt64Property* NumProperty = FindField<FInt64Property>(this->GetClass(), property_name);
 				int64 property_value = -1;
-				std::random_device rd;
-				std::mt19937 gen(rd());
-				std::uniform_int_distribution<> distr(first, second);
+				FBltRandomStream stream(FuzzSeed, FuzzIteration, actor_id, FBltRandomStream::HashName(property_name));
 				
 				if (property_map.find(property_name.ToString()) != property_map.end()) {
-					NumProperty->SetPropertyValue_InContainer(this, distr(gen));
+					const int64 old_value = NumProperty->GetPropertyValue_InContainer(this);
+					FBltRestoreJournal::Get().Capture(this, NumProperty);
+					NumProperty->SetPropertyValue_InContainer(this, stream.RandRange(first, second));
 					property_value = NumProperty->GetPropertyValue_InContainer(this);
-					GEngine->AddOnScreenDebugMessage(-1, 4, FColor::Green, property_name.ToString() + FString::Printf(TEXT(": %d"), property_value));
+					FBltMutationJournal::Get().Record(actor_id, FBltRandomStream::HashName(property_name), EBltFuzzValueType::Int64, static_cast<uint64>(old_value), static_cast<uint64>(property_value));
 				
 				}
 			}
 		}
 	}
-	GEngine->AddOnScreenDebugMessage(-1, 500, FColor::Green, " ");
+	FBltMutationJournal::Get().ShowSummary();
+	++FuzzIteration;
 
 	fs.close();
 
@@ -159,7 +134,7 @@ void AMyCharacter::InheritedFuzzer() {
 	fs.close();
 
 	Fuzzer fuzzer;
-	fuzzer.myFuzzer(this,property_map);
+	fuzzer.myFuzzer(this,property_map, FuzzSeed, FuzzIteration++);
 
 	
 
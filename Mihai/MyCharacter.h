@@ -26,6 +26,12 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "test")
 		int64 test_JumpHeight;
 
+	// Same seed and iteration reproduce the same fuzzed values
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "fuzzing")
+		int64 FuzzSeed;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "fuzzing")
+		int32 FuzzIteration;
+
 
 protected:
 	// Called when the game starts or when spawned